@@ -17,15 +17,50 @@
 
 #include "benchmark_mode.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+#include "batch_mode/batch_mode.h"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/legacy.h"
 #include "platform/platform.h"
 
 namespace plugins
 {
+namespace
+{
+/**
+ * @brief Gets the frame time below which a percentage of the frames fall, with the nearest-rank method
+ */
+float percentile(const std::vector<float> &sorted_frame_times, float percentage)
+{
+	size_t rank = static_cast<size_t>(std::ceil(percentage / 100.0f * sorted_frame_times.size()));
+	return sorted_frame_times[std::clamp<size_t>(rank, 1, sorted_frame_times.size()) - 1];
+}
+
+std::string to_json(const BenchmarkMode::FrameTimeSummary &summary, size_t frame_count)
+{
+	std::stringstream histogram;
+	for (size_t i = 0; i < summary.histogram.size(); ++i)
+	{
+		histogram << (i > 0 ? ", " : "") << summary.histogram[i];
+	}
+
+	return fmt::format("{{\"frames\": {}, \"min\": {}, \"mean\": {}, \"p50\": {}, \"p95\": {}, \"p99\": {}, \"max\": {}, "
+	                   "\"histogram\": {{\"bucket_width\": {}, \"counts\": [{}]}}}}",
+	                   frame_count, summary.min, summary.mean, summary.p50, summary.p95, summary.p99, summary.max,
+	                   summary.histogram_bucket_width, histogram.str());
+}
+}        // namespace
+
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
-                      "Log frame averages after running an app.",
+                      "Log frame time statistics after running an app, and write them to a report.",
                       {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      {&benchmark_flag, &benchmark_warmup_flag, &benchmark_output_flag})
 {
 }
 
@@ -40,23 +75,137 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
 	platform->force_render(true);
+
+	if (parser.contains(&benchmark_warmup_flag))
+	{
+		warmup_frames = parser.as<uint32_t>(&benchmark_warmup_flag);
+	}
+
+	if (parser.contains(&benchmark_output_flag))
+	{
+		output_path     = parser.as<std::string>(&benchmark_output_flag);
+		output_path_set = true;
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
 {
-	elapsed_time += delta_time;
 	total_frames++;
+
+	// The first frames are skipped, as they include loading and the caches warming up
+	if (total_frames <= warmup_frames)
+	{
+		return;
+	}
+
+	elapsed_time += delta_time;
+	cpu_frame_times.push_back(delta_time * 1000.0f);
+	gpu_frame_times.push_back(platform->get_app().get_gpu_frame_time());
 }
 
 void BenchmarkMode::on_app_start(const std::string &app_id)
 {
 	elapsed_time = 0;
 	total_frames = 0;
+	cpu_frame_times.clear();
+	gpu_frame_times.clear();
 	LOGI("Starting Benchmark for {}", app_id);
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
-	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+	auto recorded_frames = cpu_frame_times.size();
+
+	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, recorded_frames, recorded_frames / elapsed_time);
+
+	if (recorded_frames == 0)
+	{
+		LOGW("Benchmark for {} recorded no frames, {} warm-up frames were requested", app_id, warmup_frames);
+		return;
+	}
+
+	auto cpu_summary = summarize(cpu_frame_times);
+	LOGI("CPU frame time (ms): min {:.3f}, mean {:.3f}, p50 {:.3f}, p95 {:.3f}, p99 {:.3f}, max {:.3f}",
+	     cpu_summary.min, cpu_summary.mean, cpu_summary.p50, cpu_summary.p95, cpu_summary.p99, cpu_summary.max);
+
+	write_report(app_id);
+}
+
+BenchmarkMode::FrameTimeSummary BenchmarkMode::summarize(std::vector<float> frame_times)
+{
+	FrameTimeSummary summary{};
+
+	if (frame_times.empty())
+	{
+		return summary;
+	}
+
+	std::sort(frame_times.begin(), frame_times.end());
+
+	summary.min  = frame_times.front();
+	summary.max  = frame_times.back();
+	summary.mean = std::accumulate(frame_times.begin(), frame_times.end(), 0.0f) / frame_times.size();
+	summary.p50  = percentile(frame_times, 50.0f);
+	summary.p95  = percentile(frame_times, 95.0f);
+	summary.p99  = percentile(frame_times, 99.0f);
+
+	summary.histogram.resize(HISTOGRAM_BUCKET_COUNT, 0);
+	summary.histogram_bucket_width = (summary.max - summary.min) / HISTOGRAM_BUCKET_COUNT;
+
+	for (float frame_time : frame_times)
+	{
+		uint32_t bucket = 0;
+		if (summary.histogram_bucket_width > 0.0f)
+		{
+			bucket = std::min(static_cast<uint32_t>((frame_time - summary.min) / summary.histogram_bucket_width), HISTOGRAM_BUCKET_COUNT - 1);
+		}
+		summary.histogram[bucket]++;
+	}
+
+	return summary;
+}
+
+void BenchmarkMode::write_report(const std::string &app_id) const
+{
+	// Frames which were rendered before the stats measured the GPU time report 0
+	std::vector<float> measured_gpu_frame_times;
+	std::copy_if(gpu_frame_times.begin(), gpu_frame_times.end(), std::back_inserter(measured_gpu_frame_times), [](float frame_time) { return frame_time > 0.0f; });
+
+	std::stringstream json;
+	json << "{\n";
+	json << fmt::format("\t\"app\": \"{}\",\n", app_id);
+	json << fmt::format("\t\"warmup_frames\": {},\n", warmup_frames);
+	json << fmt::format("\t\"elapsed_time\": {},\n", elapsed_time);
+	json << fmt::format("\t\"cpu_frame_time\": {}", to_json(summarize(cpu_frame_times), cpu_frame_times.size()));
+	if (!measured_gpu_frame_times.empty())
+	{
+		json << fmt::format(",\n\t\"gpu_frame_time\": {}", to_json(summarize(measured_gpu_frame_times), measured_gpu_frame_times.size()));
+	}
+	json << "\n}\n";
+
+	std::stringstream csv;
+	csv << "frame,cpu_frame_time_ms,gpu_frame_time_ms\n";
+	for (size_t i = 0; i < cpu_frame_times.size(); ++i)
+	{
+		csv << fmt::format("{},{},", warmup_frames + i, cpu_frame_times[i]);
+		if (gpu_frame_times[i] > 0.0f)
+		{
+			csv << gpu_frame_times[i];
+		}
+		csv << "\n";
+	}
+
+	// In batch mode several apps are benchmarked with the same output name
+	std::string name = output_path_set ? output_path : app_id;
+	if (output_path_set && platform->using_plugin<BatchMode>())
+	{
+		name += "-" + app_id;
+	}
+
+	auto fs = vkb::filesystem::get();
+	fs->write_file(vkb::fs::path::get(vkb::fs::path::Type::Benchmarks, name + ".json"), json.str());
+	fs->write_file(vkb::fs::path::get(vkb::fs::path::Type::Benchmarks, name + ".csv"), csv.str());
+
+	LOGI("Benchmark report written to {}", vkb::fs::path::get(vkb::fs::path::Type::Benchmarks, name + ".json"));
 }
 }        // namespace plugins
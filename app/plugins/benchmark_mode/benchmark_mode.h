@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -27,15 +27,43 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
 
 /**
  * @brief Benchmark Mode
- * 
+ *
  * When enabled frame time statistics of a samples run will be printed to the console when an application closes. The simulation frame time (delta time) is also locked to 60FPS so that statistics can be compared more accurately across different devices.
- * 
- * Usage: vulkan_samples sample afbc --benchmark
- * 
+ *
+ * The CPU time of every frame after the warm-up frames is recorded, along with the GPU time of the frame if the sample requests
+ * vkb::StatIndex::gpu_time and the Vulkan performance query timestamps are available. A report with the minimum, mean, percentiles,
+ * maximum and a histogram of the frame times is written to output/benchmarks/<name>.json, and the time of every frame to <name>.csv.
+ *
+ * Usage: vulkan_samples sample afbc --benchmark --benchmark-warmup 60 --benchmark-output afbc-benchmark
+ *
  */
 class BenchmarkMode : public BenchmarkModeTags
 {
   public:
+	/**
+	 * @brief Number of buckets of the frame time histograms, which span the range between the fastest and slowest frame
+	 */
+	static constexpr uint32_t HISTOGRAM_BUCKET_COUNT = 20;
+
+	/**
+	 * @brief Statistics of a series of frame times, in milliseconds
+	 */
+	struct FrameTimeSummary
+	{
+		float min{0.0f};
+		float mean{0.0f};
+		float p50{0.0f};
+		float p95{0.0f};
+		float p99{0.0f};
+		float max{0.0f};
+
+		/// Width of the histogram buckets, the first bucket starts at min
+		float histogram_bucket_width{0.0f};
+
+		/// Number of frames in each bucket
+		std::vector<uint32_t> histogram;
+	};
+
 	BenchmarkMode();
 
 	virtual ~BenchmarkMode() = default;
@@ -50,11 +78,36 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	virtual void on_app_close(const std::string &app_info) override;
 
-	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
+	/**
+	 * @brief Computes the statistics of a series of frame times
+	 * @param frame_times The frame times in milliseconds
+	 * @return The statistics, all zero if there are no frame times
+	 */
+	static FrameTimeSummary summarize(std::vector<float> frame_times);
+
+	vkb::FlagCommand benchmark_flag        = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
+	vkb::FlagCommand benchmark_warmup_flag = {vkb::FlagType::OneValue, "benchmark-warmup", "", "Number of frames to run before recording frame times"};
+	vkb::FlagCommand benchmark_output_flag = {vkb::FlagType::OneValue, "benchmark-output", "", "Declare an output name for the benchmark report"};
 
   private:
+	/**
+	 * @brief Writes the JSON report and the CSV frame times to the benchmarks directory
+	 */
+	void write_report(const std::string &app_id) const;
+
+	uint32_t warmup_frames{0};
+
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	/// CPU time of each recorded frame, in milliseconds
+	std::vector<float> cpu_frame_times;
+
+	/// GPU time of each recorded frame, in milliseconds, empty if the sample doesn't measure it
+	std::vector<float> gpu_frame_times;
+
+	bool        output_path_set = false;
+	std::string output_path;
 };
-}        // namespace plugins
\ No newline at end of file
+}        // namespace plugins
@@ -0,0 +1,87 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering_options.h"
+
+#include <algorithm>
+
+#include "rendering/subpasses/geometry_subpass.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+RenderingOptions::RenderingOptions() :
+    RenderingOptionsTags("Rendering Options",
+                         "A collection of flags to configure how the scenes of the samples are rendered",
+                         {}, {&rendering_options_group})
+{
+}
+
+bool RenderingOptions::is_active(const vkb::CommandParser &parser)
+{
+	return true;
+}
+
+void RenderingOptions::init(const vkb::CommandParser &parser)
+{
+	if (parser.contains(&draw_mode_flag))
+	{
+		std::string draw_mode = parser.as<std::string>(&draw_mode_flag);
+		std::transform(draw_mode.begin(), draw_mode.end(), draw_mode.begin(), ::tolower);
+		if (draw_mode == "indirect")
+		{
+			LOGI("[Rendering Options] Drawing the opaque objects of the scenes indirectly");
+			vkb::GeometrySubpass::set_default_draw_submission_mode(vkb::DrawSubmissionMode::Indirect);
+		}
+		else if (draw_mode == "direct")
+		{
+			vkb::GeometrySubpass::set_default_draw_submission_mode(vkb::DrawSubmissionMode::Direct);
+		}
+		else
+		{
+			LOGE("[Rendering Options] Invalid draw mode {}, drawing directly", draw_mode);
+		}
+	}
+
+	if (parser.contains(&descriptor_buffer_flag))
+	{
+		LOGI("[Rendering Options] Using descriptor buffers when they are supported");
+		vkb::VulkanSampleC::set_default_descriptor_buffer_enable(true);
+	}
+
+	if (parser.contains(&bindless_materials_flag))
+	{
+		LOGI("[Rendering Options] Using bindless materials when they are supported");
+		vkb::GeometrySubpass::set_default_bindless_materials(true);
+	}
+
+	if (parser.contains(&frames_in_flight_flag))
+	{
+		auto frames_in_flight = parser.as<uint32_t>(&frames_in_flight_flag);
+		if (frames_in_flight > 0)
+		{
+			LOGI("[Rendering Options] Recording {} frames in flight", frames_in_flight);
+			vkb::VulkanSampleC::set_default_frames_in_flight(frames_in_flight);
+			vkb::VulkanSampleCpp::set_default_frames_in_flight(frames_in_flight);
+		}
+		else
+		{
+			LOGE("[Rendering Options] Invalid number of frames in flight {}, using one frame per swapchain image", frames_in_flight);
+		}
+	}
+}
+}        // namespace plugins
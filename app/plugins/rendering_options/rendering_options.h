@@ -0,0 +1,57 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class RenderingOptions;
+
+using RenderingOptionsTags = vkb::PluginBase<RenderingOptions, vkb::tags::Passive>;
+
+/**
+ * @brief Rendering Options
+ *
+ * Configure how the framework renders the scenes of the samples.
+ *
+ * Usage: vulkan_samples sample afbc --draw-mode indirect --descriptor-buffer
+ *
+ */
+class RenderingOptions : public RenderingOptionsTags
+{
+  public:
+	RenderingOptions();
+
+	virtual ~RenderingOptions() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &options) override;
+
+	vkb::FlagCommand draw_mode_flag = {vkb::FlagType::OneValue, "draw-mode", "", "How the scene subpasses submit the opaque objects {direct | indirect}. Indirect culls and draws them from the GPU"};
+
+	vkb::FlagCommand descriptor_buffer_flag = {vkb::FlagType::FlagOnly, "descriptor-buffer", "", "Write the descriptors of the samples to descriptor buffers when VK_EXT_descriptor_buffer is supported. The scene subpasses then bind their uniforms without dynamic offsets, and pipelines with dynamic uniform buffers keep using descriptor sets"};
+
+	vkb::FlagCommand bindless_materials_flag = {vkb::FlagType::FlagOnly, "bindless-materials", "", "Read the materials of the scenes from a bindless set when descriptor indexing is supported"};
+
+	vkb::FlagCommand frames_in_flight_flag = {vkb::FlagType::OneValue, "frames-in-flight", "", "Number of frames recorded ahead of the GPU, independently of the number of swapchain images"};
+
+	vkb::CommandGroup rendering_options_group = {"Rendering Options", {&draw_mode_flag, &descriptor_buffer_flag, &bindless_materials_flag, &frames_in_flight_flag}};
+};
+}        // namespace plugins
@@ -20,6 +20,7 @@
 #include <chrono>
 #include <iomanip>
 
+#include "platform/platform.h"
 #include "rendering/render_context.h"
 
 namespace plugins
@@ -28,7 +29,7 @@ Screenshot::Screenshot() :
     ScreenshotTags("Screenshot",
                    "Save a screenshot of a specific frame",
                    {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::PostDraw},
-                   {&screenshot_flag, &screenshot_output_flag})
+                   {&screenshot_flag, &screenshot_output_flag, &screenshot_interval_flag, &screenshot_format_flag})
 {
 }
 
@@ -48,12 +49,48 @@ void Screenshot::init(const vkb::CommandParser &parser)
 			output_path     = parser.as<std::string>(&screenshot_output_flag);
 			output_path_set = true;
 		}
+
+		if (parser.contains(&screenshot_interval_flag))
+		{
+			interval = parser.as<uint32_t>(&screenshot_interval_flag);
+		}
+
+		if (parser.contains(&screenshot_format_flag))
+		{
+			auto format_name = parser.as<std::string>(&screenshot_format_flag);
+			if (format_name == "raw")
+			{
+				format = vkb::FrameCapture::Format::Raw;
+			}
+			else if (format_name != "png")
+			{
+				LOGW("Unknown screenshot format {}, defaulting to png", format_name);
+			}
+		}
 	}
 }
 
 void Screenshot::on_update(float delta_time)
 {
 	current_frame++;
+
+	if (current_frame == frame_number)
+	{
+		// The copy is recorded in the frame the app draws after this update
+		if (auto frame_capture = platform->get_app().get_frame_capture())
+		{
+			update_output_path();
+
+			if (interval > 0)
+			{
+				frame_capture->start_sequence(interval, output_path, format);
+			}
+			else
+			{
+				frame_capture->request(output_path, format);
+			}
+		}
+	}
 }
 
 void Screenshot::on_app_start(const std::string &name)
@@ -66,23 +103,47 @@ void Screenshot::on_post_draw(vkb::RenderContext &context)
 {
 	if (current_frame == frame_number)
 	{
-		if (!output_path_set)
+		auto frame_capture = platform->get_app().get_frame_capture();
+		if (frame_capture && !frame_capture->is_request_pending())
 		{
-			// Create generic image path. <app name>-<current timestamp>.png
-			auto        timestamp = std::chrono::system_clock::now();
-			std::time_t now_tt    = std::chrono::system_clock::to_time_t(timestamp);
-			std::tm     tm        = *std::localtime(&now_tt);
-
-			char buffer[30];
-			strftime(buffer, sizeof(buffer), "%G-%m-%d---%H-%M-%S", &tm);
+			return;
+		}
 
-			std::stringstream stream;
-			stream << current_app_name << "-" << buffer;
+		// Apps which record their own frames don't record the copy, fall back to a blocking screenshot
+		if (frame_capture)
+		{
+			frame_capture->cancel_request();
+		}
+		else
+		{
+			update_output_path();
+		}
 
-			output_path = stream.str();
+		if (interval > 0)
+		{
+			LOGW("The app doesn't record frame captures, only frame {} is captured", frame_number);
 		}
 
 		screenshot(context, output_path);
 	}
 }
+
+void Screenshot::update_output_path()
+{
+	if (!output_path_set)
+	{
+		// Create generic image path. <app name>-<current timestamp>.png
+		auto        timestamp = std::chrono::system_clock::now();
+		std::time_t now_tt    = std::chrono::system_clock::to_time_t(timestamp);
+		std::tm     tm        = *std::localtime(&now_tt);
+
+		char buffer[30];
+		strftime(buffer, sizeof(buffer), "%G-%m-%d---%H-%M-%S", &tm);
+
+		std::stringstream stream;
+		stream << current_app_name << "-" << buffer;
+
+		output_path = stream.str();
+	}
+}
 }        // namespace plugins
\ No newline at end of file
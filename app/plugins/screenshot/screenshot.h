@@ -19,6 +19,7 @@
 
 #include "filesystem/legacy.h"
 #include "platform/plugins/plugin_base.h"
+#include "rendering/frame_capture.h"
 
 namespace plugins
 {
@@ -30,8 +31,11 @@ using ScreenshotTags = vkb::PluginBase<Screenshot, vkb::tags::Passive>;
  * @brief Screenshot
  *
  * Capture a screen shot of the last rendered image at a given frame. The output can also be named
+ * An interval captures a sequence of frames from the given frame on, without stalling the sample, which suits
+ * videos and image comparisons. Frames can be written as PNG images or as raw RGBA8 pixels.
  *
  * Usage: vulkan_sample sample afbc --screenshot 1 --screenshot-output afbc-screenshot
+ *        vulkan_sample sample afbc --screenshot 1 --screenshot-interval 10 --screenshot-format raw
  *
  */
 class Screenshot : public ScreenshotTags
@@ -52,14 +56,26 @@ class Screenshot : public ScreenshotTags
 	virtual void on_post_draw(vkb::RenderContext &context) override;
 
 	vkb::FlagCommand screenshot_flag        = {vkb::FlagType::OneValue, "screenshot", "", "Take a screenshot at a given frame"};
-	vkb::FlagCommand screenshot_output_flag = {vkb::FlagType::OneValue, "screenshot-output", "", "Declare an output name for the image"};
+	vkb::FlagCommand screenshot_output_flag   = {vkb::FlagType::OneValue, "screenshot-output", "", "Declare an output name for the image"};
+	vkb::FlagCommand screenshot_interval_flag = {vkb::FlagType::OneValue, "screenshot-interval", "", "Capture every Nth frame from the screenshot frame on"};
+	vkb::FlagCommand screenshot_format_flag   = {vkb::FlagType::OneValue, "screenshot-format", "", "Declare the format of the images (png|raw)"};
 
   private:
+	/**
+	 * @brief Names the image after the app and the current time, unless an output name was declared
+	 */
+	void update_output_path();
+
 	uint32_t    current_frame = 0;
 	uint32_t    frame_number;
 	std::string current_app_name;
 
 	bool        output_path_set = false;
 	std::string output_path;
+
+	/// Number of frames between the captures of a sequence, 0 to capture a single frame
+	uint32_t interval = 0;
+
+	vkb::FrameCapture::Format format = vkb::FrameCapture::Format::Png;
 };
 }        // namespace plugins
\ No newline at end of file
@@ -62,7 +62,11 @@ void WindowOptions::init(const vkb::CommandParser &parser)
 		properties.extent.height = height;
 	}
 
-	if (parser.contains(&headless_flag))
+	if (parser.contains(&offscreen_flag))
+	{
+		properties.mode = vkb::Window::Mode::Offscreen;
+	}
+	else if (parser.contains(&headless_flag))
 	{
 		properties.mode = vkb::Window::Mode::Headless;
 	}
@@ -48,10 +48,11 @@ class WindowOptions : public WindowOptionsTags
 	vkb::FlagCommand height_flag     = {vkb::FlagType::OneValue, "height", "", "Initial window height"};
 	vkb::FlagCommand fullscreen_flag = {vkb::FlagType::FlagOnly, "fullscreen", "", "Run in fullscreen mode"};
 	vkb::FlagCommand headless_flag   = {vkb::FlagType::FlagOnly, "headless_surface", "", "Run in headless surface mode. A Surface and swap-chain is still created using VK_EXT_headless_surface."};
+	vkb::FlagCommand offscreen_flag  = {vkb::FlagType::FlagOnly, "offscreen", "", "Run in offscreen mode. No surface or swap-chain is created, frames are rendered to images of the render context."};
 	vkb::FlagCommand borderless_flag = {vkb::FlagType::FlagOnly, "borderless", "", "Run in borderless mode"};
 	vkb::FlagCommand stretch_flag    = {vkb::FlagType::FlagOnly, "stretch", "", "Stretch window to fullscreen (direct-to-display only)"};
 	vkb::FlagCommand vsync_flag      = {vkb::FlagType::OneValue, "vsync", "", "Force vsync {ON | OFF}. If not set samples decide how vsync is set"};
 
-	vkb::CommandGroup window_options_group = {"Window Options", {&width_flag, &height_flag, &vsync_flag, &fullscreen_flag, &borderless_flag, &stretch_flag, &headless_flag}};
+	vkb::CommandGroup window_options_group = {"Window Options", {&width_flag, &height_flag, &vsync_flag, &fullscreen_flag, &borderless_flag, &stretch_flag, &headless_flag, &offscreen_flag}};
 };
 }        // namespace plugins
\ No newline at end of file
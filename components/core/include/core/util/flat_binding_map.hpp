@@ -0,0 +1,101 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Values bound to array elements of descriptor bindings, stored flat and sorted by binding and array element.
+ *        Clearing the map keeps its storage, so that binding the same number of elements again doesn't allocate.
+ *        The map keeps a hash of its contents up to date as elements change, the sum of the hashes of the elements,
+ *        so that it doesn't depend on the order in which they were bound.
+ * @tparam Element Type stored for each array element, with uint32_t members binding and array_element
+ *         and a size_t member hash
+ */
+template <class Element>
+class FlatBindingMap
+{
+  public:
+	void clear()
+	{
+		elements.clear();
+
+		hash = 0;
+	}
+
+	bool empty() const
+	{
+		return elements.empty();
+	}
+
+	/**
+	 * @brief Finds the element of an array element of a binding, inserting a default one if it isn't bound yet
+	 */
+	Element &get(uint32_t binding, uint32_t array_element)
+	{
+		auto it = std::lower_bound(elements.begin(), elements.end(), std::make_pair(binding, array_element),
+		                           [](const Element &element, const std::pair<uint32_t, uint32_t> &key) {
+			                           return std::make_pair(element.binding, element.array_element) < key;
+		                           });
+
+		if (it == elements.end() || it->binding != binding || it->array_element != array_element)
+		{
+			it                = elements.insert(it, Element{});
+			it->binding       = binding;
+			it->array_element = array_element;
+		}
+
+		return *it;
+	}
+
+	/**
+	 * @brief Sets the hash of an element after its value changed, and updates the hash of the map
+	 */
+	void set_hash(Element &element, size_t element_hash)
+	{
+		hash += element_hash - element.hash;
+
+		element.hash = element_hash;
+	}
+
+	/**
+	 * @return The hash of the elements
+	 */
+	size_t get_hash() const
+	{
+		return hash;
+	}
+
+	/**
+	 * @return The elements, sorted by binding and array element
+	 */
+	const std::vector<Element> &get_elements() const
+	{
+		return elements;
+	}
+
+  private:
+	std::vector<Element> elements;
+
+	size_t hash{0};
+};
+}        // namespace vkb
@@ -0,0 +1,157 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace vkb
+{
+/**
+ * @brief Synchronizes the requests for one type of resource of a cache, see find_or_build
+ */
+struct ResourceMutex
+{
+	/// Guards the resources, it is only locked exclusively to insert or remove resources
+	std::shared_mutex resources_mutex;
+
+	/// Guards the pending builds
+	std::mutex pending_mutex;
+
+	/// Resources being built, by hash, which are ready when the resource is inserted
+	std::unordered_map<std::size_t, std::shared_future<void>> pending_builds;
+
+	/// Whether resources of the type can't be built concurrently
+	bool serialize_builds{false};
+
+	std::mutex build_mutex;
+};
+
+/**
+ * @brief Looks a resource up in a map, building it if it is missing
+ *        Hits only take a shared lock on the map. A missing resource is built without holding the
+ *        lock by the first thread requesting it, and the other threads requesting the same resource
+ *        wait for that build. Requests for other resources are not blocked by the build.
+ * @param resource_mutex Synchronization state of the map
+ * @param resources The resources, by hash
+ * @param hash Hash of the requested resource
+ * @param build Returns the resource, called at most once per hash unless it throws
+ * @param on_inserted Called with the resource once it is in the map, before the waiting threads are released
+ * @return The resource, whose address is stable until it is removed from the map
+ */
+template <class T, class Build, class OnInserted>
+T &find_or_build(ResourceMutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, std::size_t hash, Build &&build, OnInserted &&on_inserted)
+{
+	{
+		std::shared_lock<std::shared_mutex> guard(resource_mutex.resources_mutex);
+
+		auto res_it = resources.find(hash);
+
+		if (res_it != resources.end())
+		{
+			return res_it->second;
+		}
+	}
+
+	std::promise<void> pending_build;
+
+	{
+		std::unique_lock<std::mutex> pending_guard(resource_mutex.pending_mutex);
+
+		auto pending_it = resource_mutex.pending_builds.find(hash);
+
+		if (pending_it != resource_mutex.pending_builds.end())
+		{
+			// Another thread is building the resource, wait for it and look it up again
+			auto other_build = pending_it->second;
+			pending_guard.unlock();
+
+			other_build.get();
+
+			return find_or_build(resource_mutex, resources, hash, std::forward<Build>(build), std::forward<OnInserted>(on_inserted));
+		}
+
+		// The resource may have been inserted since the first lookup, as builds are inserted before they stop pending
+		{
+			std::shared_lock<std::shared_mutex> guard(resource_mutex.resources_mutex);
+
+			auto res_it = resources.find(hash);
+
+			if (res_it != resources.end())
+			{
+				return res_it->second;
+			}
+		}
+
+		resource_mutex.pending_builds.emplace(hash, pending_build.get_future().share());
+	}
+
+	auto stop_pending = [&resource_mutex, hash]() {
+		std::lock_guard<std::mutex> pending_guard(resource_mutex.pending_mutex);
+		resource_mutex.pending_builds.erase(hash);
+	};
+
+	try
+	{
+		std::unique_lock<std::mutex> build_guard(resource_mutex.build_mutex, std::defer_lock);
+
+		if (resource_mutex.serialize_builds)
+		{
+			build_guard.lock();
+		}
+
+		T resource = build();
+
+		T *res = nullptr;
+
+		{
+			std::unique_lock<std::shared_mutex> guard(resource_mutex.resources_mutex);
+
+			auto res_ins_it = resources.emplace(hash, std::move(resource));
+
+			if (!res_ins_it.second)
+			{
+				throw std::runtime_error{"Insertion error for cache object"};
+			}
+
+			res = &res_ins_it.first->second;
+		}
+
+		on_inserted(*res);
+
+		stop_pending();
+
+		pending_build.set_value();
+
+		return *res;
+	}
+	catch (...)
+	{
+		stop_pending();
+
+		pending_build.set_exception(std::current_exception());
+
+		throw;
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,165 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/flat_binding_map.hpp>
+#include <core/util/hash.hpp>
+
+using namespace vkb;
+
+namespace
+{
+/**
+ * @brief Stands in for the resource bound to an array element, as a descriptor info of a buffer
+ */
+struct Binding
+{
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
+
+	uint64_t buffer{0};
+
+	uint64_t offset{0};
+
+	size_t hash{0};
+};
+
+/**
+ * @brief Binds a buffer the way vkb::ResourceSet does, updating the hash of the map along with the element
+ */
+void bind(FlatBindingMap<Binding> &bindings, uint32_t binding, uint32_t array_element, uint64_t buffer, uint64_t offset)
+{
+	auto &element  = bindings.get(binding, array_element);
+	element.buffer = buffer;
+	element.offset = offset;
+
+	size_t hash{0U};
+	hash_combine(hash, binding);
+	hash_combine(hash, array_element);
+	hash_combine(hash, buffer);
+	hash_combine(hash, offset);
+
+	bindings.set_hash(element, hash);
+}
+
+/**
+ * @brief The bindings of a draw of the geometry subpass: the global uniform, the node uniform
+ *        at a per-draw offset, and the base color, normal and metallic roughness textures
+ */
+void bind_draw(FlatBindingMap<Binding> &bindings, uint32_t draw)
+{
+	bind(bindings, 0, 0, 1, 0);
+	bind(bindings, 1, 0, 2, 256 * draw);
+
+	for (uint32_t texture = 0; texture < 3; ++texture)
+	{
+		bind(bindings, 2, texture, 3 + texture, 0);
+	}
+}
+}        // namespace
+
+TEST_CASE("vkb::FlatBindingMap keeps elements sorted by binding and array element", "[flat_binding_map]")
+{
+	FlatBindingMap<Binding> bindings;
+
+	bindings.get(2, 1).buffer = 3;
+	bindings.get(0, 0).buffer = 1;
+	bindings.get(2, 0).buffer = 2;
+	bindings.get(0, 0).offset = 4;
+
+	auto &elements = bindings.get_elements();
+
+	REQUIRE(elements.size() == 3);
+
+	REQUIRE(elements[0].binding == 0);
+	REQUIRE(elements[0].buffer == 1);
+	REQUIRE(elements[0].offset == 4);
+
+	REQUIRE(elements[1].binding == 2);
+	REQUIRE(elements[1].array_element == 0);
+	REQUIRE(elements[1].buffer == 2);
+
+	REQUIRE(elements[2].binding == 2);
+	REQUIRE(elements[2].array_element == 1);
+	REQUIRE(elements[2].buffer == 3);
+
+	bindings.clear();
+
+	REQUIRE(bindings.empty());
+	REQUIRE(bindings.get(1, 0).buffer == 0);
+}
+
+TEST_CASE("vkb::FlatBindingMap keeps the hash of its contents up to date", "[flat_binding_map]")
+{
+	FlatBindingMap<Binding> bindings;
+	FlatBindingMap<Binding> reversed_bindings;
+
+	REQUIRE(bindings.get_hash() == 0);
+
+	bind_draw(bindings, 1);
+
+	// The hash doesn't depend on the order in which the resources were bound
+	bind(reversed_bindings, 2, 2, 5, 0);
+	bind(reversed_bindings, 2, 1, 4, 0);
+	bind(reversed_bindings, 2, 0, 3, 0);
+	bind(reversed_bindings, 1, 0, 2, 256);
+	bind(reversed_bindings, 0, 0, 1, 0);
+
+	REQUIRE(bindings.get_hash() == reversed_bindings.get_hash());
+
+	// Changing a resource changes the hash, binding it back restores it
+	auto hash = bindings.get_hash();
+
+	bind(bindings, 1, 0, 2, 512);
+	REQUIRE(bindings.get_hash() != hash);
+
+	bind(bindings, 1, 0, 2, 256);
+	REQUIRE(bindings.get_hash() == hash);
+
+	bindings.clear();
+	REQUIRE(bindings.get_hash() == 0);
+
+	// A command buffer records the same bindings again after a reset
+	bind_draw(bindings, 1);
+	REQUIRE(bindings.get_hash() == hash);
+}
+
+TEST_CASE("vkb::FlatBindingMap keeps its storage when cleared", "[flat_binding_map]")
+{
+	FlatBindingMap<Binding> bindings;
+
+	// The first draw sizes the storage
+	bind_draw(bindings, 0);
+
+	auto *data = bindings.get_elements().data();
+
+	for (uint32_t draw = 1; draw < 100; ++draw)
+	{
+		bindings.clear();
+
+		bind_draw(bindings, draw);
+
+		REQUIRE(bindings.get_elements().size() == 5);
+		REQUIRE(bindings.get_elements().data() == data);
+	}
+}
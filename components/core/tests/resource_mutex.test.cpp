@@ -0,0 +1,184 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <core/util/resource_mutex.hpp>
+
+using namespace vkb;
+
+namespace
+{
+constexpr std::size_t resource_count = 1024;
+
+constexpr std::size_t lookups_per_thread = 10000;
+
+/**
+ * @brief Runs a function on several threads at once, passing each its index
+ */
+template <class F>
+void run_threads(std::size_t thread_count, F &&function)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count);
+
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		threads.emplace_back(function, i);
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+std::size_t get_thread_count()
+{
+	return std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+}
+}        // namespace
+
+TEST_CASE("vkb::find_or_build builds each resource once", "[resource_mutex]")
+{
+	ResourceMutex                         resource_mutex;
+	std::unordered_map<std::size_t, int>  resources;
+	std::atomic<int>                      build_count{0};
+	std::atomic<int>                      insert_count{0};
+	std::vector<std::atomic<const int *>> results(get_thread_count());
+
+	run_threads(results.size(), [&](std::size_t thread_index) {
+		results[thread_index] = &find_or_build(
+		    resource_mutex, resources, 42,
+		    [&]() {
+			    build_count++;
+			    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			    return 7;
+		    },
+		    [&](int &) { insert_count++; });
+	});
+
+	REQUIRE(build_count == 1);
+	REQUIRE(insert_count == 1);
+	REQUIRE(resources.size() == 1);
+
+	for (auto &result : results)
+	{
+		REQUIRE(result.load() == &resources.at(42));
+	}
+
+	REQUIRE(resource_mutex.pending_builds.empty());
+}
+
+TEST_CASE("vkb::find_or_build forwards build errors and allows retries", "[resource_mutex]")
+{
+	ResourceMutex                        resource_mutex;
+	std::unordered_map<std::size_t, int> resources;
+
+	auto no_op = [](int &) {};
+
+	REQUIRE_THROWS_AS(find_or_build(
+	                      resource_mutex, resources, 1, []() -> int { throw std::runtime_error{"build failed"}; }, no_op),
+	                  std::runtime_error);
+
+	REQUIRE(resources.empty());
+	REQUIRE(resource_mutex.pending_builds.empty());
+
+	REQUIRE(find_or_build(resource_mutex, resources, 1, []() { return 3; }, no_op) == 3);
+}
+
+// Hidden from the default run, use "test__resource_mutex [benchmark]" to run it
+TEST_CASE("vkb::find_or_build lookup throughput", "[.][benchmark][resource_mutex]")
+{
+	ResourceMutex                        resource_mutex;
+	std::unordered_map<std::size_t, int> resources;
+
+	for (std::size_t i = 0; i < resource_count; ++i)
+	{
+		resources.emplace(i, static_cast<int>(i));
+	}
+
+	std::mutex exclusive_mutex;
+
+	// Sweep the thread counts up to the hardware concurrency, to show how both locks scale with contention
+	std::vector<std::size_t> thread_counts;
+
+	auto max_thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+	for (std::size_t thread_count = 1; thread_count < max_thread_count; thread_count *= 2)
+	{
+		thread_counts.push_back(thread_count);
+	}
+
+	thread_counts.push_back(max_thread_count);
+
+	for (auto thread_count : thread_counts)
+	{
+		// Every lookup is a hit, which is the common case once a sample is running
+		BENCHMARK("Shared lock hits, " + std::to_string(thread_count) + " threads")
+		{
+			std::atomic<std::size_t> sum{0};
+
+			run_threads(thread_count, [&](std::size_t thread_index) {
+				std::size_t local_sum = 0;
+
+				for (std::size_t i = 0; i < lookups_per_thread; ++i)
+				{
+					local_sum += find_or_build(
+					    resource_mutex, resources, (i + thread_index) % resource_count, []() { return 0; }, [](int &) {});
+				}
+
+				sum += local_sum;
+			});
+
+			return sum.load();
+		};
+
+		// The previous implementation, a lookup under an exclusive lock
+		BENCHMARK("Exclusive lock hits, " + std::to_string(thread_count) + " threads")
+		{
+			std::atomic<std::size_t> sum{0};
+
+			run_threads(thread_count, [&](std::size_t thread_index) {
+				std::size_t local_sum = 0;
+
+				for (std::size_t i = 0; i < lookups_per_thread; ++i)
+				{
+					std::lock_guard<std::mutex> guard(exclusive_mutex);
+
+					local_sum += resources.find((i + thread_index) % resource_count)->second;
+				}
+
+				sum += local_sum;
+			});
+
+			return sum.load();
+		};
+	}
+}
@@ -40,6 +40,7 @@ enum Type
 	Storage,
 	Screenshots,
 	Logs,
+	Benchmarks,
 	/* NewFolder */
 	TotalRelativePathTypes,
 
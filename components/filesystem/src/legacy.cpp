@@ -38,6 +38,7 @@ const std::unordered_map<Type, std::string> relative_paths = {
     {Type::Storage, "output/"},
     {Type::Screenshots, "output/images/"},
     {Type::Logs, "output/logs/"},
+    {Type::Benchmarks, "output/benchmarks/"},
 };
 
 const std::string get(const Type type, const std::string &file)
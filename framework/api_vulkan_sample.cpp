@@ -419,9 +419,8 @@ void ApiVulkanSample::recreate_current_command_buffer()
 
 void ApiVulkanSample::create_pipeline_cache()
 {
-	VkPipelineCacheCreateInfo pipeline_cache_create_info = {};
-	pipeline_cache_create_info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-	VK_CHECK(vkCreatePipelineCache(get_device().get_handle(), &pipeline_cache_create_info, nullptr, &pipeline_cache));
+	// The device owns a pipeline cache which persists between runs
+	pipeline_cache = get_device().get_pipeline_cache().get_handle();
 }
 
 VkPipelineShaderStageCreateInfo ApiVulkanSample::load_shader(const std::string &file, VkShaderStageFlagBits stage, vkb::ShaderSourceLanguage src_language)
@@ -525,6 +524,17 @@ void ApiVulkanSample::prepare_frame()
 			VK_CHECK(result);
 		}
 	}
+	else
+	{
+		// Without a swapchain the images of the render context are used in turn
+		current_buffer = (current_buffer + 1) % static_cast<uint32_t>(swapchain_buffers.size());
+
+		// Stands in for the acquire, which would have signaled the semaphore the submission waits for
+		VkSubmitInfo acquire_info         = vkb::initializers::submit_info();
+		acquire_info.signalSemaphoreCount = 1;
+		acquire_info.pSignalSemaphores    = &semaphores.acquired_image_ready;
+		VK_CHECK(vkQueueSubmit(queue, 1, &acquire_info, VK_NULL_HANDLE));
+	}
 }
 
 void ApiVulkanSample::submit_frame()
@@ -573,11 +583,22 @@ void ApiVulkanSample::submit_frame()
 			}
 		}
 	}
+	else if (semaphores.render_complete != VK_NULL_HANDLE)
+	{
+		// Stands in for the present, which would have waited for the semaphore the submission signaled
+		VkPipelineStageFlags wait_stage   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		VkSubmitInfo         present_info = vkb::initializers::submit_info();
+
+		present_info.waitSemaphoreCount = 1;
+		present_info.pWaitSemaphores    = &semaphores.render_complete;
+		present_info.pWaitDstStageMask  = &wait_stage;
+		VK_CHECK(vkQueueSubmit(queue, 1, &present_info, VK_NULL_HANDLE));
+	}
 
 	// DO NOT USE
 	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
 	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	VK_CHECK(get_device().get_suitable_graphics_queue().wait_idle());
 }
 
 ApiVulkanSample::~ApiVulkanSample()
@@ -614,8 +635,6 @@ ApiVulkanSample::~ApiVulkanSample()
 		vkDestroyImage(get_device().get_handle(), depth_stencil.image, nullptr);
 		vkFreeMemory(get_device().get_handle(), depth_stencil.mem, nullptr);
 
-		vkDestroyPipelineCache(get_device().get_handle(), pipeline_cache, nullptr);
-
 		vkDestroyCommandPool(get_device().get_handle(), cmd_pool, nullptr);
 
 		vkDestroySemaphore(get_device().get_handle(), semaphores.acquired_image_ready, nullptr);
@@ -338,7 +338,7 @@ class ApiVulkanSample : public vkb::VulkanSampleC
 	void recreate_current_command_buffer();
 
 	/**
-	 * @brief Create a cache pool for rendering pipelines
+	 * @brief Gets the cache of the device for rendering pipelines
 	 */
 	void create_pipeline_cache();
 
@@ -47,7 +47,19 @@ class BufferAllocation
 	vkb::core::Buffer<bindingType> &get_buffer();
 	DeviceSizeType                  get_offset() const;
 	DeviceSizeType                  get_size() const;
-	void                            update(const std::vector<uint8_t> &data, uint32_t offset = 0);
+
+	/**
+	 * @brief Returns a host pointer to the start of the allocation, to write its contents without intermediate copies
+	 * @note Writes done through the pointer need to be made visible with flush()
+	 */
+	uint8_t *map();
+
+	/**
+	 * @brief Flushes the host writes done through map() on the whole allocation
+	 */
+	void flush();
+
+	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 	template <typename T>
 	void update(const T &value, uint32_t offset = 0);
 
@@ -120,6 +132,20 @@ typename BufferAllocation<bindingType>::DeviceSizeType BufferAllocation<bindingT
 	}
 }
 
+template <vkb::BindingType bindingType>
+uint8_t *BufferAllocation<bindingType>::map()
+{
+	assert(buffer && "Invalid buffer pointer");
+	return buffer->map() + offset;
+}
+
+template <vkb::BindingType bindingType>
+void BufferAllocation<bindingType>::flush()
+{
+	assert(buffer && "Invalid buffer pointer");
+	buffer->flush(offset, size);
+}
+
 template <vkb::BindingType bindingType>
 void BufferAllocation<bindingType>::update(const std::vector<uint8_t> &data, uint32_t offset)
 {
@@ -260,6 +286,9 @@ vk::DeviceSize BufferBlock<bindingType>::aligned_offset() const
 template <vkb::BindingType bindingType>
 vk::DeviceSize BufferBlock<bindingType>::determine_alignment(vk::BufferUsageFlags usage, vk::PhysicalDeviceLimits const &limits) const
 {
+	// Device addresses don't constrain the offsets of the allocations
+	usage &= ~vk::BufferUsageFlags(vk::BufferUsageFlagBits::eShaderDeviceAddress);
+
 	if (usage == vk::BufferUsageFlagBits::eUniformBuffer)
 	{
 		return limits.minUniformBufferOffsetAlignment;
@@ -278,6 +307,11 @@ vk::DeviceSize BufferBlock<bindingType>::determine_alignment(vk::BufferUsageFlag
 		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
 		return 16;
 	}
+	else if (usage & (vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT | vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT))
+	{
+		// The descriptorBufferOffsetAlignment isn't part of the limits, allocations are sized to a multiple of it instead
+		return 16;
+	}
 	else
 	{
 		throw std::runtime_error("Usage not recognised");
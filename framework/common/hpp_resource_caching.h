@@ -285,7 +285,7 @@ namespace
 template <class T, class... A>
 struct HPPRecordHelper
 {
-	size_t record(HPPResourceRecord & /*recorder*/, A &.../*args*/)
+	size_t record(HPPResourceRecord & /*recorder*/, size_t /*hash*/, A &.../*args*/)
 	{
 		return 0;
 	}
@@ -297,9 +297,9 @@ struct HPPRecordHelper
 template <class... A>
 struct HPPRecordHelper<vkb::core::HPPShaderModule, A...>
 {
-	size_t record(HPPResourceRecord &recorder, A &...args)
+	size_t record(HPPResourceRecord &recorder, size_t hash, A &.../*args*/)
 	{
-		return recorder.register_shader_module(args...);
+		return recorder.register_shader_module(hash);
 	}
 
 	void index(HPPResourceRecord &recorder, size_t index, vkb::core::HPPShaderModule &shader_module)
@@ -311,7 +311,7 @@ struct HPPRecordHelper<vkb::core::HPPShaderModule, A...>
 template <class... A>
 struct HPPRecordHelper<vkb::core::HPPPipelineLayout, A...>
 {
-	size_t record(HPPResourceRecord &recorder, A &...args)
+	size_t record(HPPResourceRecord &recorder, size_t /*hash*/, A &...args)
 	{
 		return recorder.register_pipeline_layout(args...);
 	}
@@ -325,7 +325,7 @@ struct HPPRecordHelper<vkb::core::HPPPipelineLayout, A...>
 template <class... A>
 struct HPPRecordHelper<vkb::core::HPPRenderPass, A...>
 {
-	size_t record(HPPResourceRecord &recorder, A &...args)
+	size_t record(HPPResourceRecord &recorder, size_t /*hash*/, A &...args)
 	{
 		return recorder.register_render_pass(args...);
 	}
@@ -339,15 +339,13 @@ struct HPPRecordHelper<vkb::core::HPPRenderPass, A...>
 template <class... A>
 struct HPPRecordHelper<vkb::core::HPPGraphicsPipeline, A...>
 {
-	size_t record(HPPResourceRecord &recorder, A &...args)
+	size_t record(HPPResourceRecord &recorder, size_t /*hash*/, A &...args)
 	{
 		return recorder.register_graphics_pipeline(args...);
 	}
 
-	void index(HPPResourceRecord &recorder, size_t index, vkb::core::HPPGraphicsPipeline &graphics_pipeline)
-	{
-		recorder.set_graphics_pipeline(index, graphics_pipeline);
-	}
+	void index(HPPResourceRecord & /*recorder*/, size_t /*index*/, vkb::core::HPPGraphicsPipeline & /*graphics_pipeline*/)
+	{}
 };
 }        // namespace
 
@@ -390,7 +388,7 @@ T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *record
 
 		if (recorder)
 		{
-			size_t index = record_helper.record(*recorder, args...);
+			size_t index = record_helper.record(*recorder, hash, args...);
 			record_helper.index(*recorder, index, res_it->second);
 		}
 #ifndef DEBUG
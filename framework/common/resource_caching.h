@@ -598,6 +598,12 @@ inline void hash_param<std::vector<ShaderModule *>>(
 	for (auto &shader_module : value)
 	{
 		hash_combine(seed, shader_module->get_id());
+
+		// The resource modes of a shader module can change after it is built, and they affect the layouts built from it
+		for (auto &resource : shader_module->get_resources())
+		{
+			hash_combine(seed, resource.mode);
+		}
 	}
 }
 
@@ -657,7 +663,7 @@ inline void hash_param(size_t &seed, const T &first_arg, const Args &... args)
 template <class T, class... A>
 struct RecordHelper
 {
-	size_t record(ResourceRecord & /*recorder*/, A &... /*args*/)
+	size_t record(ResourceRecord & /*recorder*/, std::size_t /*hash*/, A &... /*args*/)
 	{
 		return 0;
 	}
@@ -670,9 +676,9 @@ struct RecordHelper
 template <class... A>
 struct RecordHelper<ShaderModule, A...>
 {
-	size_t record(ResourceRecord &recorder, A &... args)
+	size_t record(ResourceRecord &recorder, std::size_t hash, A &... /*args*/)
 	{
-		return recorder.register_shader_module(args...);
+		return recorder.register_shader_module(hash);
 	}
 
 	void index(ResourceRecord &recorder, size_t index, ShaderModule &shader_module)
@@ -681,10 +687,23 @@ struct RecordHelper<ShaderModule, A...>
 	}
 };
 
+template <class... A>
+struct RecordHelper<DescriptorSetLayout, A...>
+{
+	size_t record(ResourceRecord &recorder, std::size_t /*hash*/, A &... args)
+	{
+		return recorder.register_descriptor_set_layout(args...);
+	}
+
+	void index(ResourceRecord & /*recorder*/, size_t /*index*/, DescriptorSetLayout & /*descriptor_set_layout*/)
+	{
+	}
+};
+
 template <class... A>
 struct RecordHelper<PipelineLayout, A...>
 {
-	size_t record(ResourceRecord &recorder, A &... args)
+	size_t record(ResourceRecord &recorder, std::size_t /*hash*/, A &... args)
 	{
 		return recorder.register_pipeline_layout(args...);
 	}
@@ -698,7 +717,7 @@ struct RecordHelper<PipelineLayout, A...>
 template <class... A>
 struct RecordHelper<RenderPass, A...>
 {
-	size_t record(ResourceRecord &recorder, A &... args)
+	size_t record(ResourceRecord &recorder, std::size_t /*hash*/, A &... args)
 	{
 		return recorder.register_render_pass(args...);
 	}
@@ -712,14 +731,26 @@ struct RecordHelper<RenderPass, A...>
 template <class... A>
 struct RecordHelper<GraphicsPipeline, A...>
 {
-	size_t record(ResourceRecord &recorder, A &... args)
+	size_t record(ResourceRecord &recorder, std::size_t /*hash*/, A &... args)
 	{
 		return recorder.register_graphics_pipeline(args...);
 	}
 
-	void index(ResourceRecord &recorder, size_t index, GraphicsPipeline &graphics_pipeline)
+	void index(ResourceRecord & /*recorder*/, size_t /*index*/, GraphicsPipeline & /*graphics_pipeline*/)
+	{
+	}
+};
+
+template <class... A>
+struct RecordHelper<ComputePipeline, A...>
+{
+	size_t record(ResourceRecord &recorder, std::size_t /*hash*/, A &... args)
+	{
+		return recorder.register_compute_pipeline(args...);
+	}
+
+	void index(ResourceRecord & /*recorder*/, size_t /*index*/, ComputePipeline & /*compute_pipeline*/)
 	{
-		recorder.set_graphics_pipeline(index, graphics_pipeline);
 	}
 };
 }        // namespace
@@ -763,7 +794,7 @@ T &request_resource(Device &device, ResourceRecord *recorder, std::unordered_map
 
 		if (recorder)
 		{
-			size_t index = record_helper.record(*recorder, args...);
+			size_t index = record_helper.record(*recorder, hash, args...);
 			record_helper.index(*recorder, index, res_it->second);
 		}
 #ifndef DEBUG
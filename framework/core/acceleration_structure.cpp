@@ -38,19 +38,19 @@ AccelerationStructure::~AccelerationStructure()
 	}
 }
 
-uint64_t AccelerationStructure::add_triangle_geometry(vkb::core::BufferC &vertex_buffer,
-                                                      vkb::core::BufferC &index_buffer,
-                                                      vkb::core::BufferC &transform_buffer,
-                                                      uint32_t            triangle_count,
-                                                      uint32_t            max_vertex,
-                                                      VkDeviceSize        vertex_stride,
-                                                      uint32_t            transform_offset,
-                                                      VkFormat            vertex_format,
-                                                      VkIndexType         index_type,
-                                                      VkGeometryFlagsKHR  flags,
-                                                      uint64_t            vertex_buffer_data_address,
-                                                      uint64_t            index_buffer_data_address,
-                                                      uint64_t            transform_buffer_data_address)
+uint64_t AccelerationStructure::add_triangle_geometry(const vkb::core::BufferC &vertex_buffer,
+                                                      const vkb::core::BufferC &index_buffer,
+                                                      const vkb::core::BufferC &transform_buffer,
+                                                      uint32_t                 triangle_count,
+                                                      uint32_t                 max_vertex,
+                                                      VkDeviceSize             vertex_stride,
+                                                      uint32_t                 transform_offset,
+                                                      VkFormat                 vertex_format,
+                                                      VkIndexType              index_type,
+                                                      VkGeometryFlagsKHR       flags,
+                                                      uint64_t                 vertex_buffer_data_address,
+                                                      uint64_t                 index_buffer_data_address,
+                                                      uint64_t                 transform_buffer_data_address)
 {
 	VkAccelerationStructureGeometryKHR geometry{};
 	geometry.sType                                          = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
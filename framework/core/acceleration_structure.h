@@ -60,19 +60,19 @@ class AccelerationStructure
 	 * @param index_buffer_data_address set this if don't want the index_buffer data_address
 	 * @param transform_buffer_data_address set this if don't want the transform_buffer data_address
 	 */
-	uint64_t add_triangle_geometry(vkb::core::BufferC &vertex_buffer,
-	                               vkb::core::BufferC &index_buffer,
-	                               vkb::core::BufferC &transform_buffer,
-	                               uint32_t            triangle_count,
-	                               uint32_t            max_vertex,
-	                               VkDeviceSize        vertex_stride,
-	                               uint32_t            transform_offset              = 0,
-	                               VkFormat            vertex_format                 = VK_FORMAT_R32G32B32_SFLOAT,
-	                               VkIndexType         index_type                    = VK_INDEX_TYPE_UINT32,
-	                               VkGeometryFlagsKHR  flags                         = VK_GEOMETRY_OPAQUE_BIT_KHR,
-	                               uint64_t            vertex_buffer_data_address    = 0,
-	                               uint64_t            index_buffer_data_address     = 0,
-	                               uint64_t            transform_buffer_data_address = 0);
+	uint64_t add_triangle_geometry(const vkb::core::BufferC &vertex_buffer,
+	                               const vkb::core::BufferC &index_buffer,
+	                               const vkb::core::BufferC &transform_buffer,
+	                               uint32_t                 triangle_count,
+	                               uint32_t                 max_vertex,
+	                               VkDeviceSize             vertex_stride,
+	                               uint32_t                 transform_offset              = 0,
+	                               VkFormat                 vertex_format                 = VK_FORMAT_R32G32B32_SFLOAT,
+	                               VkIndexType              index_type                    = VK_INDEX_TYPE_UINT32,
+	                               VkGeometryFlagsKHR       flags                         = VK_GEOMETRY_OPAQUE_BIT_KHR,
+	                               uint64_t                 vertex_buffer_data_address    = 0,
+	                               uint64_t                 index_buffer_data_address     = 0,
+	                               uint64_t                 transform_buffer_data_address = 0);
 
 	void update_triangle_geometry(uint64_t triangleUUID, std::unique_ptr<vkb::core::BufferC> &vertex_buffer,
 	                              std::unique_ptr<vkb::core::BufferC> &index_buffer,
@@ -17,6 +17,8 @@
 
 #include "command_buffer.h"
 
+#include <algorithm>
+
 #include "command_pool.h"
 #include "common/error.h"
 #include "device.h"
@@ -27,6 +29,14 @@
 
 namespace vkb
 {
+namespace
+{
+inline VkDeviceSize aligned_size(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
@@ -65,7 +75,17 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    descriptor_infos(std::exchange(other.descriptor_infos, {})),
+    dynamic_offsets(std::exchange(other.dynamic_offsets, {})),
+    bound_descriptor_set_handles(std::exchange(other.bound_descriptor_set_handles, {})),
+    bound_dynamic_offsets(std::exchange(other.bound_dynamic_offsets, {})),
+    dynamic_offset_deltas(std::exchange(other.dynamic_offset_deltas, {})),
+    dirty_dynamic_offsets(std::exchange(other.dirty_dynamic_offsets, {})),
+    external_descriptor_sets(std::exchange(other.external_descriptor_sets, {})),
+    dirty_external_descriptor_sets(std::exchange(other.dirty_external_descriptor_sets, {})),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    descriptor_buffer_stale_sets(std::exchange(other.descriptor_buffer_stale_sets, {}))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
@@ -91,8 +111,17 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	// Reset state
 	pipeline_state.reset();
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	std::fill(descriptor_set_layout_binding_state.begin(), descriptor_set_layout_binding_state.end(), nullptr);
 	stored_push_constants.clear();
+	external_descriptor_sets.clear();
+	dirty_external_descriptor_sets = 0;
+	for (auto &set_deltas : dynamic_offset_deltas)
+	{
+		set_deltas.clear();
+	}
+	dirty_dynamic_offsets = 0;
+	bound_descriptor_buffer        = VK_NULL_HANDLE;
+	descriptor_buffer_stale_sets   = 0;
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -112,7 +141,15 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 		begin_info.pInheritanceInfo = &inheritance;
 	}
 
-	return vkBeginCommandBuffer(get_handle(), &begin_info);
+	VkResult result = vkBeginCommandBuffer(get_handle(), &begin_info);
+
+	// The GPU zones sent to Tracy are read back by the first primary command buffer of a frame
+	if (result == VK_SUCCESS && level == VK_COMMAND_BUFFER_LEVEL_PRIMARY && command_pool.get_render_frame())
+	{
+		command_pool.get_render_frame()->get_gpu_profiler().collect(get_handle());
+	}
+
+	return result;
 }
 
 VkResult CommandBuffer::end()
@@ -122,6 +159,24 @@ VkResult CommandBuffer::end()
 	return VK_SUCCESS;
 }
 
+uint32_t CommandBuffer::begin_gpu_scope(const char *name)
+{
+	if (auto render_frame = command_pool.get_render_frame())
+	{
+		return render_frame->get_gpu_profiler().begin_scope(get_handle(), name);
+	}
+
+	return GpuProfiler::invalid_scope;
+}
+
+void CommandBuffer::end_gpu_scope(uint32_t scope)
+{
+	if (auto render_frame = command_pool.get_render_frame())
+	{
+		render_frame->get_gpu_profiler().end_scope(get_handle(), scope);
+	}
+}
+
 void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 {
 	flush_pipeline_state(pipeline_bind_point);
@@ -140,7 +195,15 @@ void CommandBuffer::begin_render_pass(const RenderTarget
 	// Reset state
 	pipeline_state.reset();
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	std::fill(descriptor_set_layout_binding_state.begin(), descriptor_set_layout_binding_state.end(), nullptr);
+	external_descriptor_sets.clear();
+	dirty_external_descriptor_sets = 0;
+	for (auto &set_deltas : dynamic_offset_deltas)
+	{
+		set_deltas.clear();
+	}
+	dirty_dynamic_offsets = 0;
+	descriptor_buffer_stale_sets   = 0;
 
 	auto &render_pass = get_render_pass(render_target, load_store_infos, subpasses);
 	auto &framebuffer = get_device().get_resource_cache().request_framebuffer(render_target, render_pass);
@@ -197,7 +260,15 @@ void CommandBuffer::next_subpass()
 
 	// Reset descriptor sets
 	resource_binding_state.reset();
-	descriptor_set_layout_binding_state.clear();
+	std::fill(descriptor_set_layout_binding_state.begin(), descriptor_set_layout_binding_state.end(), nullptr);
+	external_descriptor_sets.clear();
+	dirty_external_descriptor_sets = 0;
+	for (auto &set_deltas : dynamic_offset_deltas)
+	{
+		set_deltas.clear();
+	}
+	dirty_dynamic_offsets = 0;
+	descriptor_buffer_stale_sets   = 0;
 
 	// Clear stored push constants
 	stored_push_constants.clear();
@@ -253,6 +324,36 @@ void CommandBuffer::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize o
 	resource_binding_state.bind_buffer(buffer, offset, range, set, binding, array_element);
 }
 
+void CommandBuffer::set_dynamic_offset(uint32_t set, uint32_t binding, uint32_t offset)
+{
+	assert(set < 64 && "Descriptor set index is out of bounds");
+
+	if (set >= dynamic_offset_deltas.size())
+	{
+		dynamic_offset_deltas.resize(set + 1);
+	}
+
+	auto &set_deltas = dynamic_offset_deltas[set];
+
+	auto delta_it = std::find_if(set_deltas.begin(), set_deltas.end(), [binding](const DynamicOffset &delta) { return delta.binding == binding; });
+
+	if (delta_it == set_deltas.end())
+	{
+		if (offset == 0)
+		{
+			return;
+		}
+
+		delta_it = set_deltas.insert(set_deltas.end(), DynamicOffset{binding, 0});
+	}
+
+	if (delta_it->offset != offset)
+	{
+		delta_it->offset = offset;
+		dirty_dynamic_offsets |= 1ull << set;
+	}
+}
+
 void CommandBuffer::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
 	resource_binding_state.bind_image(image_view, sampler, set, binding, array_element);
@@ -268,6 +369,22 @@ void CommandBuffer::bind_input(const core::ImageView &image_view, uint32_t set,
 	resource_binding_state.bind_input(image_view, set, binding, array_element);
 }
 
+void CommandBuffer::bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set)
+{
+	assert(set < 64 && "Descriptor set index is out of bounds");
+
+	if (set >= external_descriptor_sets.size())
+	{
+		external_descriptor_sets.resize(set + 1, VK_NULL_HANDLE);
+	}
+
+	if (external_descriptor_sets[set] != descriptor_set)
+	{
+		external_descriptor_sets[set] = descriptor_set;
+		dirty_external_descriptor_sets |= 1ull << set;
+	}
+}
+
 void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::BufferC>> &buffers, const std::vector<VkDeviceSize> &offsets)
 {
 	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
@@ -376,6 +493,13 @@ void CommandBuffer::draw_indexed_indirect(const vkb::core::BufferC &buffer, VkDe
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
+void CommandBuffer::draw_indexed_indirect_count(const vkb::core::BufferC &buffer, VkDeviceSize offset, const vkb::core::BufferC &count_buffer, VkDeviceSize count_offset, uint32_t max_draw_count, uint32_t stride)
+{
+	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+	vkCmdDrawIndexedIndirectCountKHR(get_handle(), buffer.get_handle(), offset, count_buffer.get_handle(), count_offset, max_draw_count, stride);
+}
+
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
@@ -395,6 +519,11 @@ void CommandBuffer::update_buffer(const vkb::core::BufferC &buffer, VkDeviceSize
 	vkCmdUpdateBuffer(get_handle(), buffer.get_handle(), offset, data.size(), data.data());
 }
 
+void CommandBuffer::fill_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data)
+{
+	vkCmdFillBuffer(get_handle(), buffer.get_handle(), offset, size, data);
+}
+
 void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions)
 {
 	vkCmdBlitImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -416,6 +545,11 @@ void CommandBuffer::copy_buffer(const vkb::core::BufferC &src_buffer, const vkb:
 	vkCmdCopyBuffer(get_handle(), src_buffer.get_handle(), dst_buffer.get_handle(), 1, &copy_region);
 }
 
+void CommandBuffer::copy_buffer(const vkb::core::BufferC &src_buffer, const vkb::core::BufferC &dst_buffer, const std::vector<VkBufferCopy> &regions)
+{
+	vkCmdCopyBuffer(get_handle(), src_buffer.get_handle(), dst_buffer.get_handle(), to_u32(regions.size()), regions.data());
+}
+
 void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
 	vkCmdCopyImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -523,7 +657,8 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 
 	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	// Sets whose bound descriptor set layout differs from the one of the pipeline layout, one bit per set index
+	uint64_t update_descriptor_sets = 0;
 
 	// Iterate over the shader sets to check if they have already been bound
 	// If they have, add the set so that the command buffer later updates it
@@ -531,43 +666,64 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 	{
 		uint32_t descriptor_set_id = set_it.first;
 
-		auto descriptor_set_layout_it = descriptor_set_layout_binding_state.find(descriptor_set_id);
+		assert(descriptor_set_id < 64 && "Descriptor set index is out of bounds");
 
-		if (descriptor_set_layout_it != descriptor_set_layout_binding_state.end())
+		if (descriptor_set_id < descriptor_set_layout_binding_state.size() && descriptor_set_layout_binding_state[descriptor_set_id] != nullptr)
 		{
-			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
+			if (descriptor_set_layout_binding_state[descriptor_set_id]->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
 			{
-				update_descriptor_sets.emplace(descriptor_set_id);
+				update_descriptor_sets |= 1ull << descriptor_set_id;
 			}
 		}
+		else if (descriptor_set_id < resource_binding_state.get_resource_sets().size() && !resource_binding_state.get_resource_sets()[descriptor_set_id].is_empty())
+		{
+			// Resources bound while the previous pipeline layouts had no such set, binding them again is a no-op so they are written here
+			update_descriptor_sets |= 1ull << descriptor_set_id;
+		}
 	}
 
 	// Validate that the bound descriptor set layouts exist in the pipeline layout
-	for (auto set_it = descriptor_set_layout_binding_state.begin(); set_it != descriptor_set_layout_binding_state.end();)
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < descriptor_set_layout_binding_state.size(); ++descriptor_set_id)
 	{
-		if (!pipeline_layout.has_descriptor_set_layout(set_it->first))
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
 		{
-			set_it = descriptor_set_layout_binding_state.erase(set_it);
+			descriptor_set_layout_binding_state[descriptor_set_id] = nullptr;
 		}
-		else
+	}
+
+	if (pipeline_layout.is_descriptor_buffer())
+	{
+		// Sets written to a descriptor buffer which was replaced need to be written again
+		update_descriptor_sets |= descriptor_buffer_stale_sets;
+
+		if (resource_binding_state.is_dirty() || update_descriptor_sets != 0)
 		{
-			++set_it;
+			update_descriptor_sets = reserve_descriptor_buffer(update_descriptor_sets);
 		}
 	}
 
+	// Sets bound by this flush, one bit per set index
+	uint64_t bound_descriptor_sets = 0;
+
 	// Check if a descriptor set needs to be created
-	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
+	if (resource_binding_state.is_dirty() || update_descriptor_sets != 0)
 	{
 		resource_binding_state.clear_dirty();
 
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < resource_sets.size(); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.is_empty())
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+			if (!resource_set.is_dirty() && !(update_descriptor_sets & (1ull << descriptor_set_id)))
 			{
 				continue;
 			}
@@ -584,113 +740,404 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
 
 			// Make descriptor set layout bound for current set
-			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+			if (descriptor_set_id >= descriptor_set_layout_binding_state.size())
+			{
+				descriptor_set_layout_binding_state.resize(descriptor_set_id + 1, nullptr);
+			}
 
-			BindingMap<VkDescriptorBufferInfo> buffer_infos;
-			BindingMap<VkDescriptorImageInfo>  image_infos;
+			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
-			std::vector<uint32_t> dynamic_offsets;
+			descriptor_infos.clear();
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			if (descriptor_set_id >= bound_descriptor_set_handles.size())
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				bound_descriptor_set_handles.resize(descriptor_set_id + 1, VK_NULL_HANDLE);
+				bound_dynamic_offsets.resize(descriptor_set_id + 1);
+			}
+
+			auto &set_dynamic_offsets = bound_dynamic_offsets[descriptor_set_id];
+			set_dynamic_offsets.clear();
+
+			// The descriptor set is looked up by a hash of its contents, which the resource set keeps up to date as resources are bound
+			// Only the resources the descriptor set doesn't use, or uses differently, are corrected here
+			size_t resources_hash = resource_set.get_hash();
 
+			// Iterate over all resource bindings, which are sorted by binding and array element
+			for (auto &resource_binding : resource_set.get_resource_bindings())
+			{
 				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+				auto binding_info = descriptor_set_layout.get_layout_binding(resource_binding.binding);
+
+				if (!binding_info)
+				{
+					resources_hash -= resource_binding.hash;
+					continue;
+				}
+
+				auto &resource_info = resource_binding.info;
+
+				// Pointer references
+				auto &buffer     = resource_info.buffer;
+				auto &sampler    = resource_info.sampler;
+				auto &image_view = resource_info.image_view;
+
+				DescriptorInfo descriptor_info;
+				descriptor_info.binding         = resource_binding.binding;
+				descriptor_info.array_element   = resource_binding.array_element;
+				descriptor_info.descriptor_type = binding_info->descriptorType;
+
+				// Get buffer info
+				if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
+					auto &buffer_info = descriptor_info.buffer_info;
+
+					buffer_info.buffer = buffer->get_handle();
+					buffer_info.offset = resource_info.offset;
+					buffer_info.range  = resource_info.range;
+
+					// Descriptors in descriptor buffers need an explicit range
+					if (buffer_info.range == VK_WHOLE_SIZE && pipeline_layout.is_descriptor_buffer())
 					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+						buffer_info.range = buffer->get_size() - buffer_info.offset;
+					}
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+					if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						set_dynamic_offsets.push_back({resource_binding.binding, to_u32(buffer_info.offset)});
 
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
+						buffer_info.offset = 0;
 
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+						resources_hash += resource_binding.dynamic_hash - resource_binding.hash;
+					}
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+					descriptor_info.is_buffer = true;
+				}
 
-								buffer_info.offset = 0;
-							}
+				// Get image info
+				else if (image_view != nullptr || sampler != nullptr)
+				{
+					auto &image_info = descriptor_info.image_info;
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					// Can be null for input attachments
+					image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+					image_info.imageView = image_view ? image_view->get_handle() : VK_NULL_HANDLE;
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+					if (image_view != nullptr)
+					{
+						// Add image layout info based on descriptor type
+						switch (binding_info->descriptorType)
 						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
+							case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+								break;
+							case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+								if (is_depth_format(image_view->get_format()))
 								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
+									image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 								}
-							}
-
-							image_infos[binding_index][array_element] = image_info;
+								else
+								{
+									image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+								}
+								break;
+							case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+								break;
+
+							default:
+								resources_hash -= resource_binding.hash;
+								continue;
 						}
 					}
-
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
 				}
+				else
+				{
+					resources_hash -= resource_binding.hash;
+					continue;
+				}
+
+				descriptor_infos.push_back(descriptor_info);
 			}
 
+			if (pipeline_layout.is_descriptor_buffer())
+			{
+				write_descriptor_buffer(descriptor_set_layout, descriptor_buffer->map() + descriptor_buffer_cursor);
+
+				uint32_t     buffer_index = 0;
+				VkDeviceSize offset       = descriptor_buffer_cursor;
+
+				vkCmdSetDescriptorBufferOffsetsEXT(get_handle(),
+				                                   pipeline_bind_point,
+				                                   pipeline_layout.get_handle(),
+				                                   descriptor_set_id,
+				                                   1, &buffer_index,
+				                                   &offset);
+
+				descriptor_buffer_cursor += aligned_size(descriptor_set_layout.get_descriptor_buffer_size(),
+				                                         get_device().get_descriptor_buffer_properties().descriptorBufferOffsetAlignment);
+				descriptor_buffer_stale_sets &= ~(1ull << descriptor_set_id);
+
+				continue;
+			}
+
+			// The image layouts and descriptor types follow from the descriptor set layout
+			size_t descriptor_set_hash{0U};
+			hash_combine(descriptor_set_hash, descriptor_set_layout.get_handle());
+			hash_combine(descriptor_set_hash, resources_hash);
+
 			VkDescriptorSet descriptor_set_handle =
 			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
+			                                                            descriptor_infos,
+			                                                            descriptor_set_hash,
 			                                                            update_after_bind,
 			                                                            command_pool.get_thread_index());
 
 			// Bind descriptor set
-			vkCmdBindDescriptorSets(get_handle(),
-			                        pipeline_bind_point,
-			                        pipeline_layout.get_handle(),
-			                        descriptor_set_id,
-			                        1, &descriptor_set_handle,
-			                        to_u32(dynamic_offsets.size()),
-			                        dynamic_offsets.data());
+			bound_descriptor_set_handles[descriptor_set_id] = descriptor_set_handle;
+
+			bind_descriptor_set_with_dynamic_offsets(pipeline_bind_point, descriptor_set_id);
+
+			bound_descriptor_sets |= 1ull << descriptor_set_id;
+		}
+
+		if (descriptor_buffer != nullptr)
+		{
+			descriptor_buffer->flush(descriptor_buffer_offset, descriptor_buffer_size);
+			descriptor_buffer = nullptr;
+		}
+	}
+
+	// Sets whose only change is a dynamic offset are bound again as they are
+	uint64_t rebind_descriptor_sets = dirty_dynamic_offsets & ~bound_descriptor_sets;
+	dirty_dynamic_offsets           = 0;
+
+	// Pipelines using descriptor buffers can't bind descriptor sets
+	if (pipeline_layout.is_descriptor_buffer())
+	{
+		return;
+	}
+
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < bound_descriptor_set_handles.size(); ++descriptor_set_id)
+	{
+		if ((rebind_descriptor_sets & (1ull << descriptor_set_id)) &&
+		    bound_descriptor_set_handles[descriptor_set_id] != VK_NULL_HANDLE &&
+		    descriptor_set_id < descriptor_set_layout_binding_state.size() &&
+		    descriptor_set_layout_binding_state[descriptor_set_id] != nullptr)
+		{
+			bind_descriptor_set_with_dynamic_offsets(pipeline_bind_point, descriptor_set_id);
+		}
+	}
+
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < external_descriptor_sets.size(); ++descriptor_set_id)
+	{
+		VkDescriptorSet descriptor_set_handle = external_descriptor_sets[descriptor_set_id];
+
+		if (descriptor_set_handle == VK_NULL_HANDLE || !pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
 		}
+
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+		if (descriptor_set_id >= descriptor_set_layout_binding_state.size())
+		{
+			descriptor_set_layout_binding_state.resize(descriptor_set_id + 1, nullptr);
+		}
+
+		// Binding a lower set with an incompatible layout disturbs the higher sets, so they are bound again
+		uint64_t set_bit    = 1ull << descriptor_set_id;
+		bool     disturbed  = (bound_descriptor_sets & (set_bit - 1)) != 0;
+		bool     new_layout = descriptor_set_layout_binding_state[descriptor_set_id] != &descriptor_set_layout || (update_descriptor_sets & set_bit);
+
+		if (!(dirty_external_descriptor_sets & set_bit) && !disturbed && !new_layout)
+		{
+			continue;
+		}
+
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		vkCmdBindDescriptorSets(get_handle(),
+		                        pipeline_bind_point,
+		                        pipeline_layout.get_handle(),
+		                        descriptor_set_id,
+		                        1, &descriptor_set_handle,
+		                        0, nullptr);
+
+		dirty_external_descriptor_sets &= ~set_bit;
+	}
+}
+
+void CommandBuffer::bind_descriptor_set_with_dynamic_offsets(VkPipelineBindPoint pipeline_bind_point, uint32_t descriptor_set_id)
+{
+	dynamic_offsets.clear();
+	for (auto &bound_offset : bound_dynamic_offsets[descriptor_set_id])
+	{
+		uint32_t delta = 0;
+
+		if (descriptor_set_id < dynamic_offset_deltas.size())
+		{
+			for (auto &set_delta : dynamic_offset_deltas[descriptor_set_id])
+			{
+				if (set_delta.binding == bound_offset.binding)
+				{
+					delta = set_delta.offset;
+					break;
+				}
+			}
+		}
+
+		dynamic_offsets.push_back(bound_offset.offset + delta);
+	}
+
+	vkCmdBindDescriptorSets(get_handle(),
+	                        pipeline_bind_point,
+	                        pipeline_state.get_pipeline_layout().get_handle(),
+	                        descriptor_set_id,
+	                        1, &bound_descriptor_set_handles[descriptor_set_id],
+	                        to_u32(dynamic_offsets.size()),
+	                        dynamic_offsets.data());
+}
+
+uint64_t CommandBuffer::reserve_descriptor_buffer(uint64_t update_descriptor_sets)
+{
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+	const auto &resource_sets   = resource_binding_state.get_resource_sets();
+
+	VkDeviceSize alignment = get_device().get_descriptor_buffer_properties().descriptorBufferOffsetAlignment;
+
+	// Sets of the pipeline layout with resources bound, and the ones among them which the flush writes
+	uint64_t     layout_sets{0};
+	uint64_t     bound_sets{0};
+	VkDeviceSize layout_size{0};
+	VkDeviceSize write_size{0};
+
+	for (uint32_t descriptor_set_id = 0; descriptor_set_id < resource_sets.size(); ++descriptor_set_id)
+	{
+		auto &resource_set = resource_sets[descriptor_set_id];
+
+		if (resource_set.is_empty())
+		{
+			continue;
+		}
+
+		bound_sets |= 1ull << descriptor_set_id;
+
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		VkDeviceSize size = aligned_size(pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_descriptor_buffer_size(), alignment);
+
+		layout_sets |= 1ull << descriptor_set_id;
+		layout_size += size;
+
+		if (resource_set.is_dirty() || (update_descriptor_sets & (1ull << descriptor_set_id)))
+		{
+			write_size += size;
+		}
+	}
+
+	if (write_size == 0)
+	{
+		return update_descriptor_sets;
+	}
+
+	auto &render_frame = *command_pool.get_render_frame();
+
+	auto allocation = render_frame.allocate_descriptor_buffer(write_size, command_pool.get_thread_index());
+
+	if (allocation.get_buffer().get_handle() != bound_descriptor_buffer)
+	{
+		if (bound_descriptor_buffer != VK_NULL_HANDLE)
+		{
+			// The offsets of the sets written so far refer to the previous buffer, so they are all written again
+			update_descriptor_sets |= layout_sets;
+			descriptor_buffer_stale_sets = bound_sets & ~layout_sets;
+
+			allocation = render_frame.allocate_descriptor_buffer(layout_size, command_pool.get_thread_index());
+		}
+
+		bound_descriptor_buffer = allocation.get_buffer().get_handle();
+
+		VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+		binding_info.address = allocation.get_buffer().get_device_address();
+		binding_info.usage   = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+
+		vkCmdBindDescriptorBuffersEXT(get_handle(), 1, &binding_info);
+	}
+
+	descriptor_buffer        = &allocation.get_buffer();
+	descriptor_buffer_offset = allocation.get_offset();
+	descriptor_buffer_size   = allocation.get_size();
+	descriptor_buffer_cursor = allocation.get_offset();
+
+	return update_descriptor_sets;
+}
+
+void CommandBuffer::write_descriptor_buffer(const DescriptorSetLayout &descriptor_set_layout, uint8_t *data)
+{
+	auto &device = get_device();
+
+	const auto &properties = device.get_descriptor_buffer_properties();
+
+	for (auto &descriptor_info : descriptor_infos)
+	{
+		VkDescriptorGetInfoEXT     get_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+		VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+
+		get_info.type = descriptor_info.descriptor_type;
+
+		if (descriptor_info.is_buffer)
+		{
+			VkBufferDeviceAddressInfo buffer_address_info{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+			buffer_address_info.buffer = descriptor_info.buffer_info.buffer;
+
+			address_info.address = vkGetBufferDeviceAddressKHR(device.get_handle(), &buffer_address_info) + descriptor_info.buffer_info.offset;
+			address_info.range   = descriptor_info.buffer_info.range;
+		}
+
+		size_t descriptor_size{0};
+
+		switch (descriptor_info.descriptor_type)
+		{
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+				get_info.data.pUniformBuffer = &address_info;
+				descriptor_size              = properties.uniformBufferDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				get_info.data.pStorageBuffer = &address_info;
+				descriptor_size              = properties.storageBufferDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+				get_info.data.pCombinedImageSampler = &descriptor_info.image_info;
+				descriptor_size                     = properties.combinedImageSamplerDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+				get_info.data.pSampledImage = &descriptor_info.image_info;
+				descriptor_size             = properties.sampledImageDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+				get_info.data.pStorageImage = &descriptor_info.image_info;
+				descriptor_size             = properties.storageImageDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+				get_info.data.pInputAttachmentImage = &descriptor_info.image_info;
+				descriptor_size                     = properties.inputAttachmentDescriptorSize;
+				break;
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+				get_info.data.pSampler = &descriptor_info.image_info.sampler;
+				descriptor_size        = properties.samplerDescriptorSize;
+				break;
+			default:
+				// PipelineLayout only uses descriptor buffers for the sets whose descriptor types are handled above
+				assert(false && "Descriptor type can't be written to a descriptor buffer");
+				continue;
+		}
+
+		VkDeviceSize offset = descriptor_set_layout.get_descriptor_buffer_offset(descriptor_info.binding) + descriptor_info.array_element * descriptor_size;
+
+		vkGetDescriptorEXT(device.get_handle(), &get_info, descriptor_size, data + offset);
 	}
 }
 
@@ -22,6 +22,7 @@
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/buffer.h"
+#include "core/descriptor_set.h"
 #include "core/image.h"
 #include "core/image_view.h"
 #include "core/query_pool.h"
@@ -119,6 +120,19 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	VkResult end();
 
+	/**
+	 * @brief Writes a timestamp opening a scope of the GPU profiler of the frame the command buffer belongs to
+	 *        Prefer a ScopedGpuTimer, which closes the scope on destruction.
+	 * @param name Name of the scope
+	 * @return The index of the scope, GpuProfiler::invalid_scope if it isn't measured
+	 */
+	uint32_t begin_gpu_scope(const char *name);
+
+	/**
+	 * @brief Writes a timestamp closing a scope opened by begin_gpu_scope
+	 */
+	void end_gpu_scope(uint32_t scope);
+
 	void clear(VkClearAttachment info, VkClearRect rect);
 
 	void begin_render_pass(const RenderTarget                                           &render_target,
@@ -168,12 +182,31 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	void bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
 
+	/**
+	 * @brief Moves a dynamic buffer from its bound offset
+	 *        If nothing else changed in the set, the next draw binds its last descriptor set again
+	 *        with the new dynamic offsets, without looking it up or writing it.
+	 * @param set The set index
+	 * @param binding The binding of the dynamic buffer, the other dynamic buffers of the set keep their offsets
+	 * @param offset Offset added to the bound offset of each array element of the binding
+	 */
+	void set_dynamic_offset(uint32_t set, uint32_t binding, uint32_t offset);
+
 	void bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element);
 
 	void bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
+	/**
+	 * @brief Binds a descriptor set written outside of the command buffer, such as a bindless set
+	 *        The set is bound as it is with the pipeline layout of the next draws or dispatches,
+	 *        so no resources must be bound to the same set index through the command buffer.
+	 * @param set The set index
+	 * @param descriptor_set The descriptor set, or VK_NULL_HANDLE to stop binding it
+	 */
+	void bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set);
+
 	void bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::BufferC>> &buffers, const std::vector<VkDeviceSize> &offsets);
 
 	void bind_index_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkIndexType index_type);
@@ -212,18 +245,28 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	void draw_indexed_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
 
+	/**
+	 * @brief Draws indexed indirect with the number of draws read from a buffer
+	 * @note Requires VK_KHR_draw_indirect_count to be enabled
+	 */
+	void draw_indexed_indirect_count(const vkb::core::BufferC &buffer, VkDeviceSize offset, const vkb::core::BufferC &count_buffer, VkDeviceSize count_offset, uint32_t max_draw_count, uint32_t stride);
+
 	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
 
 	void dispatch_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset);
 
 	void update_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data);
 
+	void fill_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data);
+
 	void blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions);
 
 	void resolve_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageResolve> &regions);
 
 	void copy_buffer(const vkb::core::BufferC &src_buffer, const vkb::core::BufferC &dst_buffer, VkDeviceSize size);
 
+	void copy_buffer(const vkb::core::BufferC &src_buffer, const vkb::core::BufferC &dst_buffer, const std::vector<VkBufferCopy> &regions);
+
 	void copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions);
 
 	void copy_buffer_to_image(const vkb::core::BufferC &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions);
@@ -277,7 +320,56 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	// that contain update after bind, as they wont be implicitly updated
 	bool update_after_bind{false};
 
-	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
+	/// Descriptor set layouts bound by the command buffer, by set index, or nullptr if none is bound
+	std::vector<DescriptorSetLayout *> descriptor_set_layout_binding_state;
+
+	/// Storage reused by flush_descriptor_state, so that flushing a cached descriptor set doesn't allocate
+	std::vector<DescriptorInfo> descriptor_infos;
+
+	std::vector<uint32_t> dynamic_offsets;
+
+	/**
+	 * @brief An offset of a dynamic buffer binding
+	 */
+	struct DynamicOffset
+	{
+		uint32_t binding{0};
+
+		uint32_t offset{0};
+	};
+
+	/// Descriptor sets bound by flush_descriptor_state and the bound offsets of their dynamic buffers, by set index
+	std::vector<VkDescriptorSet> bound_descriptor_set_handles;
+
+	std::vector<std::vector<DynamicOffset>> bound_dynamic_offsets;
+
+	/// Offsets added with set_dynamic_offset, by set index, then by binding
+	std::vector<std::vector<DynamicOffset>> dynamic_offset_deltas;
+
+	/// Sets whose dynamic offset changed since the last flush, one bit per set index
+	uint64_t dirty_dynamic_offsets{0};
+
+	/// Descriptor sets bound with bind_descriptor_set, by set index, or VK_NULL_HANDLE if none is bound
+	std::vector<VkDescriptorSet> external_descriptor_sets;
+
+	/// External descriptor sets which changed since the last flush, one bit per set index
+	uint64_t dirty_external_descriptor_sets{0};
+
+	/// Descriptor buffer bound by the command buffer, if its pipelines use descriptor buffers
+	VkBuffer bound_descriptor_buffer{VK_NULL_HANDLE};
+
+	/// Sets whose offsets refer to a descriptor buffer which was replaced, one bit per set index
+	uint64_t descriptor_buffer_stale_sets{0};
+
+	/// Descriptor buffer memory reserved by the current flush, the sets are written one after the other from its offset
+	vkb::core::BufferC *descriptor_buffer{nullptr};
+
+	VkDeviceSize descriptor_buffer_offset{0};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	/// Offset in the descriptor buffer of the next set written by the current flush
+	VkDeviceSize descriptor_buffer_cursor{0};
 
 	const RenderPassBinding &get_current_render_pass() const;
 
@@ -298,6 +390,24 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Binds the last descriptor set of a set index, adding its delta to the dynamic offsets
+	 */
+	void bind_descriptor_set_with_dynamic_offsets(VkPipelineBindPoint pipeline_bind_point, uint32_t descriptor_set_id);
+
+	/**
+	 * @brief Reserves memory in the descriptor buffer of the frame for the sets written by a flush,
+	 *        and binds the descriptor buffer if it changed
+	 * @param update_descriptor_sets Sets to write in addition to the dirty ones, one bit per set index
+	 * @return The sets to write, which include all the sets of the pipeline layout if the descriptor buffer changed
+	 */
+	uint64_t reserve_descriptor_buffer(uint64_t update_descriptor_sets);
+
+	/**
+	 * @brief Writes the descriptor infos collected for a set to a descriptor buffer
+	 */
+	void write_descriptor_buffer(const DescriptorSetLayout &descriptor_set_layout, uint8_t *data);
+
 	/**
 	 * @brief Flush the push constant state
 	 */
@@ -205,4 +205,15 @@ ScopedDebugLabel::~ScopedDebugLabel()
 	}
 }
 
+ScopedGpuTimer::ScopedGpuTimer(CommandBuffer &command_buffer, const char *name) :
+    command_buffer{command_buffer},
+    scope{command_buffer.begin_gpu_scope(name)}
+{
+}
+
+ScopedGpuTimer::~ScopedGpuTimer()
+{
+	command_buffer.end_gpu_scope(scope);
+}
+
 }        // namespace vkb
\ No newline at end of file
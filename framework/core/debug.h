@@ -158,4 +158,22 @@ class ScopedDebugLabel final
 	VkCommandBuffer   command_buffer;
 };
 
+/**
+ * @brief A RAII GPU timing scope.
+ *        If the command buffer belongs to a RenderFrame whose GpuProfiler is enabled, this:
+ *        - Writes a timestamp opening a scope on construction
+ *        - Writes a timestamp closing it on destruction
+ */
+class ScopedGpuTimer final
+{
+  public:
+	ScopedGpuTimer(CommandBuffer &command_buffer, const char *name);
+
+	~ScopedGpuTimer();
+
+  private:
+	CommandBuffer &command_buffer;
+	uint32_t       scope;
+};
+
 }        // namespace vkb
\ No newline at end of file
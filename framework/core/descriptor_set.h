@@ -26,6 +26,26 @@ class Device;
 class DescriptorSetLayout;
 class DescriptorPool;
 
+/**
+ * @brief The buffer or image info written to an array element of a binding,
+ *        used to describe the contents of a descriptor set as a flat list
+ */
+struct DescriptorInfo
+{
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
+
+	VkDescriptorType descriptor_type{VK_DESCRIPTOR_TYPE_MAX_ENUM};
+
+	/// Whether the buffer info or the image info is written
+	bool is_buffer{false};
+
+	VkDescriptorBufferInfo buffer_info{};
+
+	VkDescriptorImageInfo image_info{};
+};
+
 /**
  * @brief A descriptor set handle allocated from a \ref DescriptorPool.
  *        Destroying the handle has no effect, as the pool manages the lifecycle of its descriptor sets.
@@ -83,6 +103,11 @@ class DescriptorSet
 
 	const DescriptorSetLayout &get_layout() const;
 
+	/**
+	 * @return The pool the descriptor set is allocated from, which can free it
+	 */
+	DescriptorPool &get_descriptor_pool();
+
 	VkDescriptorSet get_handle() const;
 
 	BindingMap<VkDescriptorBufferInfo> &get_buffer_infos();
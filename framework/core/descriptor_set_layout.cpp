@@ -97,10 +97,12 @@ inline bool validate_flags(const PhysicalDevice &gpu, const std::vector<VkDescri
 DescriptorSetLayout::DescriptorSetLayout(Device &                           device,
                                          const uint32_t                     set_index,
                                          const std::vector<ShaderModule *> &shader_modules,
-                                         const std::vector<ShaderResource> &resource_set) :
+                                         const std::vector<ShaderResource> &resource_set,
+                                         bool                               descriptor_buffer) :
     device{device},
     set_index{set_index},
-    shader_modules{shader_modules}
+    shader_modules{shader_modules},
+    descriptor_buffer{descriptor_buffer}
 {
 	// NOTE: `shader_modules` is passed in mainly for hashing their handles in `request_resource`.
 	//        This way, different pipelines (with different shaders / shader variants) will get
@@ -179,6 +181,11 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		create_info.flags |= std::find(binding_flags.begin(), binding_flags.end(), VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) != binding_flags.end() ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0;
 	}
 
+	if (descriptor_buffer)
+	{
+		create_info.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
 	// Create the Vulkan descriptor set layout handle
 	VkResult result = vkCreateDescriptorSetLayout(device.get_handle(), &create_info, nullptr, &handle);
 
@@ -186,6 +193,20 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	if (descriptor_buffer)
+	{
+		// The placement of the descriptors is fixed by the driver, so it is queried once here rather than when writing them
+		vkGetDescriptorSetLayoutSizeEXT(device.get_handle(), handle, &descriptor_buffer_size);
+
+		for (auto &binding : bindings)
+		{
+			VkDeviceSize offset{0};
+			vkGetDescriptorSetLayoutBindingOffsetEXT(device.get_handle(), handle, binding.binding, &offset);
+
+			descriptor_buffer_offsets_lookup.emplace(binding.binding, offset);
+		}
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -197,7 +218,10 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
     binding_flags_lookup{std::move(other.binding_flags_lookup)},
-    resources_lookup{std::move(other.resources_lookup)}
+    resources_lookup{std::move(other.resources_lookup)},
+    descriptor_buffer{other.descriptor_buffer},
+    descriptor_buffer_size{other.descriptor_buffer_size},
+    descriptor_buffer_offsets_lookup{std::move(other.descriptor_buffer_offsets_lookup)}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -272,4 +296,25 @@ const std::vector<ShaderModule *> &DescriptorSetLayout::get_shader_modules() con
 	return shader_modules;
 }
 
+bool DescriptorSetLayout::is_descriptor_buffer() const
+{
+	return descriptor_buffer;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_size() const
+{
+	return descriptor_buffer_size;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_offset(const uint32_t binding_index) const
+{
+	auto it = descriptor_buffer_offsets_lookup.find(binding_index);
+
+	if (it == descriptor_buffer_offsets_lookup.end())
+	{
+		return 0;
+	}
+
+	return it->second;
+}
 }        // namespace vkb
@@ -41,11 +41,13 @@ class DescriptorSetLayout
 	 * @param set_index The descriptor set index this layout maps to
 	 * @param shader_modules The shader modules this set layout will be used for
 	 * @param resource_set A grouping of shader resources belonging to the same set
+	 * @param descriptor_buffer Whether the descriptors of the set are written to a descriptor buffer instead of a descriptor set
 	 */
 	DescriptorSetLayout(Device &                           device,
 	                    const uint32_t                     set_index,
 	                    const std::vector<ShaderModule *> &shader_modules,
-	                    const std::vector<ShaderResource> &resource_set);
+	                    const std::vector<ShaderResource> &resource_set,
+	                    bool                               descriptor_buffer = false);
 
 	DescriptorSetLayout(const DescriptorSetLayout &) = delete;
 
@@ -73,6 +75,21 @@ class DescriptorSetLayout
 
 	const std::vector<ShaderModule *> &get_shader_modules() const;
 
+	/**
+	 * @return Whether the layout was created for descriptor buffers
+	 */
+	bool is_descriptor_buffer() const;
+
+	/**
+	 * @return The size of the descriptors of the set in a descriptor buffer
+	 */
+	VkDeviceSize get_descriptor_buffer_size() const;
+
+	/**
+	 * @return The offset of the descriptors of a binding from the start of the set in a descriptor buffer
+	 */
+	VkDeviceSize get_descriptor_buffer_offset(const uint32_t binding_index) const;
+
   private:
 	Device &device;
 
@@ -91,5 +108,11 @@ class DescriptorSetLayout
 	std::unordered_map<std::string, uint32_t> resources_lookup;
 
 	std::vector<ShaderModule *> shader_modules;
+
+	bool descriptor_buffer{false};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	std::unordered_map<uint32_t, VkDeviceSize> descriptor_buffer_offsets_lookup;
 };
 }        // namespace vkb
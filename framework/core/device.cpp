@@ -106,6 +106,61 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	// The RenderContext tracks the progress of the queues with timeline semaphores instead of fences when they are available
+	if (is_extension_supported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		auto timeline_semaphore_features =
+		    gpu.get_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+
+		if (timeline_semaphore_features.timelineSemaphore)
+		{
+			// The structure chain can't hold both the Vulkan 1.2 features and the timeline semaphore features
+			if (gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+			{
+				gpu.add_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).timelineSemaphore = VK_TRUE;
+			}
+			else
+			{
+				gpu.add_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR)
+				    .timelineSemaphore = VK_TRUE;
+			}
+
+			if (std::none_of(requested_extensions.begin(), requested_extensions.end(),
+			                 [](auto &extension) { return strcmp(extension.first, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0; }))
+			{
+				enabled_extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+			}
+			LOGI("Timeline semaphores enabled");
+		}
+	}
+
+	// The GpuProfiler of the frames resets its timestamp queries from the host, the performance queries may have enabled it already
+	if (!is_enabled(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) && is_extension_supported(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME))
+	{
+		auto host_query_reset_features =
+		    gpu.get_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES);
+
+		if (host_query_reset_features.hostQueryReset)
+		{
+			if (gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+			{
+				gpu.add_extension_features<VkPhysicalDeviceVulkan12Features>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES).hostQueryReset = VK_TRUE;
+			}
+			else
+			{
+				gpu.add_extension_features<VkPhysicalDeviceHostQueryResetFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES).hostQueryReset =
+				    VK_TRUE;
+			}
+
+			if (std::none_of(requested_extensions.begin(), requested_extensions.end(),
+			                 [](auto &extension) { return strcmp(extension.first, VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) == 0; }))
+			{
+				enabled_extensions.push_back(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
+			}
+			LOGI("Host query reset enabled");
+		}
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
@@ -152,6 +207,33 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	// Let the command buffers write descriptors to descriptor buffers, if the sample asked for it and the GPU supports it
+	if (gpu.is_descriptor_buffer_requested() &&
+	    is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+	    is_enabled(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+	{
+		auto descriptor_buffer_features =
+		    gpu.get_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+		auto buffer_device_address_features =
+		    gpu.get_extension_features<VkPhysicalDeviceBufferDeviceAddressFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES);
+
+		if (descriptor_buffer_features.descriptorBuffer && buffer_device_address_features.bufferDeviceAddress)
+		{
+			gpu.add_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT)
+			    .descriptorBuffer = VK_TRUE;
+			gpu.add_extension_features<VkPhysicalDeviceBufferDeviceAddressFeatures>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES)
+			    .bufferDeviceAddress = VK_TRUE;
+
+			VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+			properties.pNext = &descriptor_buffer_properties;
+			vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &properties);
+			descriptor_buffer_properties.pNext = nullptr;
+
+			descriptor_buffer_enabled = true;
+			LOGI("Descriptor buffers enabled");
+		}
+	}
+
 	VkDeviceCreateInfo create_info{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
 
 	// Latest requested feature will have the pNext's all set up for device creation.
@@ -190,6 +272,9 @@ Device::Device(PhysicalDevice                        &gpu,
 
 	command_pool = std::make_unique<CommandPool>(*this, get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index());
 	fence_pool   = std::make_unique<FencePool>(*this);
+
+	pipeline_cache = std::make_unique<PipelineCache>(*this);
+	resource_cache.set_pipeline_cache(*pipeline_cache);
 }
 
 Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surface) :
@@ -198,12 +283,18 @@ Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surfac
     resource_cache{*this}
 {
 	debug_utils = std::make_unique<DummyDebugUtils>();
+
+	pipeline_cache = std::make_unique<PipelineCache>(*this);
+	resource_cache.set_pipeline_cache(*pipeline_cache);
 }
 
 Device::~Device()
 {
 	resource_cache.clear();
 
+	// Saves the pipeline cache for the next run
+	pipeline_cache.reset();
+
 	command_pool.reset();
 	fence_pool.reset();
 
@@ -554,4 +645,19 @@ ResourceCache &Device::get_resource_cache()
 {
 	return resource_cache;
 }
+
+PipelineCache &Device::get_pipeline_cache()
+{
+	return *pipeline_cache;
+}
+
+bool Device::is_descriptor_buffer_enabled() const
+{
+	return descriptor_buffer_enabled;
+}
+
+const VkPhysicalDeviceDescriptorBufferPropertiesEXT &Device::get_descriptor_buffer_properties() const
+{
+	return descriptor_buffer_properties;
+}
 }        // namespace vkb
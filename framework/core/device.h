@@ -29,6 +29,7 @@
 #include "core/instance.h"
 #include "core/physical_device.h"
 #include "core/pipeline.h"
+#include "core/pipeline_cache.h"
 #include "core/pipeline_layout.h"
 #include "core/queue.h"
 #include "core/render_pass.h"
@@ -212,6 +213,21 @@ class Device : public vkb::core::VulkanResourceC<VkDevice>
 
 	ResourceCache &get_resource_cache();
 
+	/**
+	 * @brief The pipeline cache of the device, used by default by the resource cache
+	 */
+	PipelineCache &get_pipeline_cache();
+
+	/**
+	 * @return Whether the command buffers write descriptors to descriptor buffers instead of descriptor sets
+	 */
+	bool is_descriptor_buffer_enabled() const;
+
+	/**
+	 * @brief The descriptor buffer properties of the GPU, only valid if descriptor buffers are enabled
+	 */
+	const VkPhysicalDeviceDescriptorBufferPropertiesEXT &get_descriptor_buffer_properties() const;
+
   private:
 	const PhysicalDevice &gpu;
 
@@ -230,5 +246,11 @@ class Device : public vkb::core::VulkanResourceC<VkDevice>
 	std::unique_ptr<FencePool> fence_pool;
 
 	ResourceCache resource_cache;
+
+	std::unique_ptr<PipelineCache> pipeline_cache;
+
+	bool descriptor_buffer_enabled{false};
+
+	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
 };
 }        // namespace vkb
@@ -101,9 +101,26 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 	}
 
 	get_handle().begin(begin_info);
+
+	// The GPU zones sent to Tracy are read back by the first primary command buffer of a frame
+	if (level == vk::CommandBufferLevel::ePrimary && command_pool.get_render_frame())
+	{
+		command_pool.get_render_frame()->get_gpu_profiler().collect(static_cast<VkCommandBuffer>(get_handle()));
+	}
+
 	return vk::Result::eSuccess;
 }
 
+uint32_t HPPCommandBuffer::begin_gpu_scope(std::string const &name)
+{
+	if (auto render_frame = command_pool.get_render_frame())
+	{
+		return render_frame->get_gpu_profiler().begin_scope(static_cast<VkCommandBuffer>(get_handle()), name.c_str());
+	}
+
+	return vkb::GpuProfiler::invalid_scope;
+}
+
 void HPPCommandBuffer::begin_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query, vk::QueryControlFlags flags)
 {
 	get_handle().beginQuery(query_pool.get_handle(), query, flags);
@@ -299,6 +316,14 @@ vk::Result HPPCommandBuffer::end()
 	return vk::Result::eSuccess;
 }
 
+void HPPCommandBuffer::end_gpu_scope(uint32_t scope)
+{
+	if (auto render_frame = command_pool.get_render_frame())
+	{
+		render_frame->get_gpu_profiler().end_scope(static_cast<VkCommandBuffer>(get_handle()), scope);
+	}
+}
+
 void HPPCommandBuffer::end_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query)
 {
 	get_handle().endQuery(query_pool.get_handle(), query);
@@ -571,10 +596,16 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 		resource_binding_state.clear_dirty();
 
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < resource_sets.size(); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.is_empty())
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
 			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
@@ -602,19 +633,25 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			std::vector<uint32_t> dynamic_offsets;
 
 			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			auto &resource_bindings = resource_set.get_resource_bindings();
+
+			for (auto binding_it = resource_bindings.begin(); binding_it != resource_bindings.end();)
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				auto binding_index = binding_it->binding;
+
+				// The array elements of a binding are contiguous
+				auto binding_end = std::find_if(binding_it, resource_bindings.end(), [binding_index](const HPPResourceBinding &resource_binding) {
+					return resource_binding.binding != binding_index;
+				});
 
 				// Check if binding exists in the pipeline layout
 				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
 				{
 					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
+					for (auto element_it = binding_it; element_it != binding_end; ++element_it)
 					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+						auto  array_element = element_it->array_element;
+						auto &resource_info = element_it->info;
 
 						// Pointer references
 						auto &buffer     = resource_info.buffer;
@@ -669,6 +706,8 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
 					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
 				}
+
+				binding_it = binding_end;
 			}
 
 			vk::DescriptorSet descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(
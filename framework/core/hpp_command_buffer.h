@@ -92,6 +92,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	 */
 	vk::Result begin(vk::CommandBufferUsageFlags flags, const vkb::core::HPPRenderPass *render_pass, const vkb::core::HPPFramebuffer *framebuffer, uint32_t subpass_index);
 
+	uint32_t                  begin_gpu_scope(std::string const &name);
 	void                      begin_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query, vk::QueryControlFlags flags);
 	void                      begin_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
 	                                            const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
@@ -132,6 +133,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	void                      draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
 	void                      draw_indexed_indirect(const vkb::core::BufferCpp &buffer, vk::DeviceSize offset, uint32_t draw_count, uint32_t stride);
 	vk::Result                end();
+	void                      end_gpu_scope(uint32_t scope);
 	void                      end_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query);
 	void                      end_render_pass();
 	void                      execute_commands(HPPCommandBuffer &secondary_command_buffer);
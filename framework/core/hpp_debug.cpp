@@ -111,5 +111,15 @@ HPPScopedDebugLabel::~HPPScopedDebugLabel()
 	}
 }
 
+HPPScopedGpuTimer::HPPScopedGpuTimer(vkb::core::HPPCommandBuffer &command_buffer, std::string const &name) :
+    command_buffer{command_buffer}, scope{command_buffer.begin_gpu_scope(name)}
+{
+}
+
+HPPScopedGpuTimer::~HPPScopedGpuTimer()
+{
+	command_buffer.end_gpu_scope(scope);
+}
+
 }        // namespace core
 }        // namespace vkb
\ No newline at end of file
@@ -145,5 +145,23 @@ class HPPScopedDebugLabel final
 	vk::CommandBuffer               command_buffer;
 };
 
+/**
+ * @brief A RAII GPU timing scope.
+ *        If the command buffer belongs to a HPPRenderFrame whose GpuProfiler is enabled, this:
+ *        - Writes a timestamp opening a scope on construction
+ *        - Writes a timestamp closing it on destruction
+ */
+class HPPScopedGpuTimer final
+{
+  public:
+	HPPScopedGpuTimer(vkb::core::HPPCommandBuffer &command_buffer, std::string const &name);
+
+	~HPPScopedGpuTimer();
+
+  private:
+	vkb::core::HPPCommandBuffer &command_buffer;
+	uint32_t                     scope;
+};
+
 }        // namespace core
 }        // namespace vkb
\ No newline at end of file
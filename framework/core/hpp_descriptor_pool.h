@@ -39,6 +39,11 @@ class HPPDescriptorPool : private vkb::DescriptorPool
 	HPPDescriptorPool(vkb::core::HPPDevice &device, const vkb::core::HPPDescriptorSetLayout &descriptor_set_layout, uint32_t pool_size = MAX_SETS_PER_POOL) :
 	    vkb::DescriptorPool(reinterpret_cast<vkb::Device &>(device), reinterpret_cast<vkb::DescriptorSetLayout const &>(descriptor_set_layout), pool_size)
 	{}
+
+	vk::Result free(vk::DescriptorSet descriptor_set)
+	{
+		return static_cast<vk::Result>(vkb::DescriptorPool::free(static_cast<VkDescriptorSet>(descriptor_set)));
+	}
 };
 }        // namespace core
 }        // namespace vkb
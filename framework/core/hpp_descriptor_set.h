@@ -53,6 +53,11 @@ class HPPDescriptorSet : private vkb::DescriptorSet
 		return reinterpret_cast<BindingMap<vk::DescriptorBufferInfo> &>(vkb::DescriptorSet::get_buffer_infos());
 	}
 
+	vkb::core::HPPDescriptorPool &get_descriptor_pool()
+	{
+		return reinterpret_cast<vkb::core::HPPDescriptorPool &>(vkb::DescriptorSet::get_descriptor_pool());
+	}
+
 	vk::DescriptorSet get_handle() const
 	{
 		return static_cast<vk::DescriptorSet>(vkb::DescriptorSet::get_handle());
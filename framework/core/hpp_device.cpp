@@ -102,6 +102,59 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 		}
 	}
 
+	// The HPPRenderContext tracks the progress of the queues with timeline semaphores instead of fences when they are available
+	if (is_extension_supported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		auto timeline_semaphore_features = gpu.get_extension_features<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>();
+
+		if (timeline_semaphore_features.timelineSemaphore)
+		{
+			// The structure chain can't hold both the Vulkan 1.2 features and the timeline semaphore features
+			if (gpu.has_extension_features<vk::PhysicalDeviceVulkan12Features>())
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore = true;
+			}
+			else
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>().timelineSemaphore = true;
+			}
+
+			if (std::none_of(requested_extensions.begin(),
+			                 requested_extensions.end(),
+			                 [](auto const &extension) { return strcmp(extension.first, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0; }))
+			{
+				enabled_extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+			}
+			LOGI("Timeline semaphores enabled");
+		}
+	}
+
+	// The GpuProfiler of the frames resets its timestamp queries from the host, the performance queries may have enabled it already
+	if (!is_enabled(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) && is_extension_supported(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME))
+	{
+		auto host_query_reset_features = gpu.get_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>();
+
+		if (host_query_reset_features.hostQueryReset)
+		{
+			if (gpu.has_extension_features<vk::PhysicalDeviceVulkan12Features>())
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceVulkan12Features>().hostQueryReset = true;
+			}
+			else
+			{
+				gpu.add_extension_features<vk::PhysicalDeviceHostQueryResetFeatures>().hostQueryReset = true;
+			}
+
+			if (std::none_of(requested_extensions.begin(),
+			                 requested_extensions.end(),
+			                 [](auto const &extension) { return strcmp(extension.first, VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) == 0; }))
+			{
+				enabled_extensions.push_back(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
+			}
+			LOGI("Host query reset enabled");
+		}
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
@@ -161,7 +214,7 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 	{
 		vk::QueueFamilyProperties const &queue_family_property = queue_family_properties[queue_family_index];
 
-		vk::Bool32 present_supported = gpu.get_handle().getSurfaceSupportKHR(queue_family_index, surface);
+		vk::Bool32 present_supported = surface ? gpu.get_handle().getSurfaceSupportKHR(queue_family_index, surface) : false;
 
 		for (uint32_t queue_index = 0U; queue_index < queue_family_property.queueCount; ++queue_index)
 		{
@@ -460,6 +460,12 @@ vkb::core::HPPPhysicalDevice &HPPInstance::get_suitable_gpu(vk::SurfaceKHR surfa
 	{
 		if (gpu->get_properties().deviceType == vk::PhysicalDeviceType::eDiscreteGpu)
 		{
+			// Without a surface, any discrete GPU can render offscreen
+			if (!surface)
+			{
+				return *gpu;
+			}
+
 			// See if it work with the surface
 			size_t queue_count = gpu->get_queue_family_properties().size();
 			for (uint32_t queue_idx = 0; static_cast<size_t>(queue_idx) < queue_count; queue_idx++)
@@ -149,6 +149,16 @@ class HPPPhysicalDevice
 		return *static_cast<HPPStructureType *>(it->second.get());
 	}
 
+	/**
+	 * @brief Checks whether an extension features struct was added to the structure chain used for device creation
+	 * @returns True if HPPPhysicalDevice::add_extension_features() was called for this structure type
+	 */
+	template <typename HPPStructureType>
+	bool has_extension_features() const
+	{
+		return extension_features.find(HPPStructureType::structureType) != extension_features.end();
+	}
+
 	/**
 	 * @brief Request an optional features flag
 	 *
@@ -211,6 +221,25 @@ class HPPPhysicalDevice
 		return high_priority_graphics_queue;
 	}
 
+	/**
+	 * @brief Sets whether the framework should write descriptors to descriptor buffers instead of descriptor sets,
+	 * if VK_EXT_descriptor_buffer is enabled on the logical device.
+	 * @param enable If true, the device enables the features needed by the descriptor buffer backend of the command buffers.
+	 */
+	void set_descriptor_buffer_enable(bool enable)
+	{
+		descriptor_buffer = enable;
+	}
+
+	/**
+	 * @brief Returns whether the descriptor buffer backend was requested.
+	 * @return Descriptor buffer state.
+	 */
+	bool is_descriptor_buffer_requested() const
+	{
+		return descriptor_buffer;
+	}
+
   private:
 	// Handle to the Vulkan instance
 	HPPInstance &instance;
@@ -243,6 +272,8 @@ class HPPPhysicalDevice
 	std::map<vk::StructureType, std::shared_ptr<void>> extension_features;
 
 	bool high_priority_graphics_queue{false};
+
+	bool descriptor_buffer{false};
 };
 
 #define HPP_REQUEST_OPTIONAL_FEATURE(gpu, Feature, flag) gpu.request_optional_feature<Feature>(&Feature::flag, #Feature, #flag)
@@ -111,7 +111,8 @@ HPPPipelineLayout::HPPPipelineLayout(HPPPipelineLayout &&other) :
     shader_modules{std::move(other.shader_modules)},
     shader_resources{std::move(other.shader_resources)},
     shader_sets{std::move(other.shader_sets)},
-    descriptor_set_layouts{std::move(other.descriptor_set_layouts)}
+    descriptor_set_layouts{std::move(other.descriptor_set_layouts)},
+    descriptor_buffer{other.descriptor_buffer}
 {
 	other.handle = nullptr;
 }
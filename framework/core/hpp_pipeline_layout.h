@@ -59,6 +59,7 @@ class HPPPipelineLayout
 	std::unordered_map<std::string, vkb::core::HPPShaderResource>           shader_resources;              // The shader resources that this pipeline layout uses, indexed by their name
 	std::unordered_map<uint32_t, std::vector<vkb::core::HPPShaderResource>> shader_sets;                   // A map of each set and the resources it owns used by the pipeline layout
 	std::vector<vkb::core::HPPDescriptorSetLayout *>                        descriptor_set_layouts;        // The different descriptor set layouts for this pipeline layout
+	bool                                                                    descriptor_buffer = false;     // Mirrors vkb::PipelineLayout, the C++ bindings always use descriptor sets
 };
 }        // namespace core
 }        // namespace vkb
@@ -517,6 +517,12 @@ PhysicalDevice &Instance::get_suitable_gpu(VkSurfaceKHR surface, bool headless_s
 	{
 		if (gpu->get_properties().deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
 		{
+			// Without a surface, any discrete GPU can render offscreen
+			if (surface == VK_NULL_HANDLE)
+			{
+				return *gpu;
+			}
+
 			// See if it work with the surface
 			size_t queue_count = gpu->get_queue_family_properties().size();
 			for (uint32_t queue_idx = 0; static_cast<size_t>(queue_idx) < queue_count; queue_idx++)
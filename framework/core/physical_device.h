@@ -144,6 +144,16 @@ class PhysicalDevice
 		return *static_cast<T *>(it->second.get());
 	}
 
+	/**
+	 * @brief Checks whether an extension features struct was added to the structure chain used for device creation
+	 * @param type The VkStructureType of the extension features struct
+	 * @returns True if PhysicalDevice::add_extension_features() was called for this structure type
+	 */
+	bool has_extension_features(VkStructureType type) const
+	{
+		return extension_features.find(type) != extension_features.end();
+	}
+
 	/**
 	 * @brief Request an optional features flag
 	 *
@@ -206,6 +216,25 @@ class PhysicalDevice
 		return high_priority_graphics_queue;
 	}
 
+	/**
+	 * @brief Sets whether the framework should write descriptors to descriptor buffers instead of descriptor sets,
+	 * if VK_EXT_descriptor_buffer is enabled on the logical device.
+	 * @param enable If true, the device enables the features needed by the descriptor buffer backend of the command buffers.
+	 */
+	void set_descriptor_buffer_enable(bool enable)
+	{
+		descriptor_buffer = enable;
+	}
+
+	/**
+	 * @brief Returns whether the descriptor buffer backend was requested.
+	 * @return Descriptor buffer state.
+	 */
+	bool is_descriptor_buffer_requested() const
+	{
+		return descriptor_buffer;
+	}
+
   private:
 	// Handle to the Vulkan instance
 	Instance &instance;
@@ -238,6 +267,8 @@ class PhysicalDevice
 	std::map<VkStructureType, std::shared_ptr<void>> extension_features;
 
 	bool high_priority_graphics_queue{};
+
+	bool descriptor_buffer{};
 };
 
 #define REQUEST_OPTIONAL_FEATURE(gpu, Feature, type, flag) gpu.request_optional_feature<Feature>(type, &Feature::flag, #Feature, #flag)
@@ -30,7 +30,9 @@ Pipeline::Pipeline(Device &device) :
 Pipeline::Pipeline(Pipeline &&other) :
     device{other.device},
     handle{other.handle},
-    state{other.state}
+    state{other.state},
+    has_creation_feedback{other.has_creation_feedback},
+    creation_feedback{other.creation_feedback}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -54,6 +56,11 @@ const PipelineState &Pipeline::get_state() const
 	return state;
 }
 
+const VkPipelineCreationFeedbackEXT *Pipeline::get_creation_feedback() const
+{
+	return has_creation_feedback ? &creation_feedback : nullptr;
+}
+
 ComputePipeline::ComputePipeline(Device &        device,
                                  VkPipelineCache pipeline_cache,
                                  PipelineState & pipeline_state) :
@@ -112,6 +119,25 @@ ComputePipeline::ComputePipeline(Device &        device,
 	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
 	create_info.stage  = stage;
 
+	if (pipeline_state.get_pipeline_layout().is_descriptor_buffer())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	VkPipelineCreationFeedbackEXT           stage_creation_feedback{};
+	VkPipelineCreationFeedbackCreateInfoEXT creation_feedback_info{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+
+	has_creation_feedback = device.is_enabled(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+	if (has_creation_feedback)
+	{
+		creation_feedback_info.pPipelineCreationFeedback          = &creation_feedback;
+		creation_feedback_info.pipelineStageCreationFeedbackCount = 1;
+		creation_feedback_info.pPipelineStageCreationFeedbacks    = &stage_creation_feedback;
+
+		create_info.pNext = &creation_feedback_info;
+	}
+
 	result = vkCreateComputePipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
 	if (result != VK_SUCCESS)
@@ -289,6 +315,25 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
 	create_info.subpass    = pipeline_state.get_subpass_index();
 
+	if (pipeline_state.get_pipeline_layout().is_descriptor_buffer())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	std::vector<VkPipelineCreationFeedbackEXT> stage_creation_feedbacks(stage_create_infos.size());
+	VkPipelineCreationFeedbackCreateInfoEXT    creation_feedback_info{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+
+	has_creation_feedback = device.is_enabled(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+	if (has_creation_feedback)
+	{
+		creation_feedback_info.pPipelineCreationFeedback          = &creation_feedback;
+		creation_feedback_info.pipelineStageCreationFeedbackCount = to_u32(stage_creation_feedbacks.size());
+		creation_feedback_info.pPipelineStageCreationFeedbacks    = stage_creation_feedbacks.data();
+
+		create_info.pNext = &creation_feedback_info;
+	}
+
 	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
 	if (result != VK_SUCCESS)
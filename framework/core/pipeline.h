@@ -44,12 +44,21 @@ class Pipeline
 
 	const PipelineState &get_state() const;
 
+	/**
+	 * @return The creation feedback of the pipeline, or nullptr if VK_EXT_pipeline_creation_feedback is not enabled
+	 */
+	const VkPipelineCreationFeedbackEXT *get_creation_feedback() const;
+
   protected:
 	Device &device;
 
 	VkPipeline handle = VK_NULL_HANDLE;
 
 	PipelineState state;
+
+	bool has_creation_feedback{false};
+
+	VkPipelineCreationFeedbackEXT creation_feedback{};
 };
 
 class ComputePipeline : public Pipeline
@@ -0,0 +1,303 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pipeline_cache.h"
+
+#include <cstring>
+
+#include "common/strings.h"
+#include "core/device.h"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+PipelineCache::PipelineCache(Device &device, float save_interval) :
+    device{device},
+    owner_thread{std::this_thread::get_id()},
+    save_interval{save_interval}
+{
+	const auto &properties = device.get_gpu().get_properties();
+
+	// One file per GPU, so that switching between GPUs doesn't discard the cache of the other
+	path = (filesystem::get()->temp_directory() /
+	        fmt::format("vulkan_samples_pipeline_cache_{:08X}_{:08X}.bin", properties.vendorID, properties.deviceID))
+	           .string();
+
+	creation_feedback_enabled = device.is_enabled(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+	auto fs = filesystem::get();
+
+	if (fs->is_file(path))
+	{
+		try
+		{
+			initial_data = fs->read_file_binary(path);
+		}
+		catch (const std::exception &e)
+		{
+			LOGW("Failed to read pipeline cache file {}: {}", path, e.what());
+		}
+
+		if (!initial_data.empty() && !is_compatible(initial_data))
+		{
+			LOGW("Discarding pipeline cache file {}, it was created for another GPU or driver", path);
+			initial_data.clear();
+		}
+	}
+
+	handle = create_cache(initial_data);
+
+	if (handle == VK_NULL_HANDLE && !initial_data.empty())
+	{
+		LOGW("Discarding pipeline cache file {}, the driver rejected it", path);
+		initial_data.clear();
+
+		handle = create_cache(initial_data);
+	}
+
+	if (handle == VK_NULL_HANDLE)
+	{
+		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Cannot create PipelineCache"};
+	}
+
+	warm       = !initial_data.empty();
+	saved_size = initial_data.size();
+
+	if (warm)
+	{
+		LOGI("Loaded pipeline cache ({} bytes)", initial_data.size());
+	}
+}
+
+PipelineCache::~PipelineCache()
+{
+	save();
+
+	for (auto &thread_cache : thread_caches)
+	{
+		vkDestroyPipelineCache(device.get_handle(), thread_cache.second, nullptr);
+	}
+
+	vkDestroyPipelineCache(device.get_handle(), handle, nullptr);
+}
+
+VkPipelineCache PipelineCache::get_handle() const
+{
+	return handle;
+}
+
+VkPipelineCache PipelineCache::get_thread_handle()
+{
+	auto thread_id = std::this_thread::get_id();
+
+	if (thread_id == owner_thread)
+	{
+		return handle;
+	}
+
+	std::lock_guard<std::mutex> guard(thread_caches_mutex);
+
+	auto it = thread_caches.find(thread_id);
+
+	if (it != thread_caches.end())
+	{
+		return it->second;
+	}
+
+	VkPipelineCache thread_cache = create_cache(initial_data);
+
+	if (thread_cache == VK_NULL_HANDLE)
+	{
+		// The device cache must be externally synchronized while merge() writes to it,
+		// so the thread builds its pipelines without a cache rather than sharing it
+		LOGW("Failed to create the pipeline cache of a worker thread, its pipelines won't be cached");
+	}
+
+	// A failure is recorded as well, so that it isn't retried for every pipeline
+	thread_caches.emplace(thread_id, thread_cache);
+
+	return thread_cache;
+}
+
+void PipelineCache::merge()
+{
+	std::vector<VkPipelineCache> src_caches;
+
+	{
+		std::lock_guard<std::mutex> guard(thread_caches_mutex);
+
+		src_caches.reserve(thread_caches.size());
+
+		for (auto &thread_cache : thread_caches)
+		{
+			if (thread_cache.second != VK_NULL_HANDLE)
+			{
+				src_caches.push_back(thread_cache.second);
+			}
+		}
+	}
+
+	if (src_caches.empty())
+	{
+		return;
+	}
+
+	// Only the device cache has to be externally synchronized, worker threads may keep using their own
+	VkResult result = vkMergePipelineCaches(device.get_handle(), handle, to_u32(src_caches.size()), src_caches.data());
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Failed to merge the pipeline caches of the worker threads: {}", to_string(result));
+	}
+}
+
+bool PipelineCache::save()
+{
+	merge();
+
+	size_t size = get_data_size();
+
+	if (size == 0)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data(size);
+
+	VkResult result = vkGetPipelineCacheData(device.get_handle(), handle, &size, data.data());
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Failed to get pipeline cache data: {}", to_string(result));
+		return false;
+	}
+
+	data.resize(size);
+
+	try
+	{
+		filesystem::get()->write_file(path, data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write pipeline cache file {}: {}", path, e.what());
+		return false;
+	}
+
+	saved_size      = size;
+	time_since_save = 0.0f;
+
+	LOGD("Saved pipeline cache ({} bytes)", size);
+
+	return true;
+}
+
+void PipelineCache::update(float delta_time)
+{
+	time_since_save += delta_time;
+
+	if (time_since_save < save_interval)
+	{
+		return;
+	}
+
+	time_since_save = 0.0f;
+
+	merge();
+
+	// Drivers only add entries to a cache, so a change in size means new pipelines were compiled
+	if (get_data_size() != saved_size)
+	{
+		save();
+	}
+}
+
+bool PipelineCache::is_warm() const
+{
+	return warm;
+}
+
+bool PipelineCache::is_creation_feedback_enabled() const
+{
+	return creation_feedback_enabled;
+}
+
+void PipelineCache::count(PipelineCacheStats &stats, const VkPipelineCreationFeedbackEXT *feedback)
+{
+	if (feedback == nullptr || !(feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+	{
+		++stats.unknown;
+	}
+	else if (feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+	{
+		++stats.hits;
+	}
+	else
+	{
+		++stats.misses;
+	}
+}
+
+bool PipelineCache::is_compatible(const std::vector<uint8_t> &data) const
+{
+	VkPipelineCacheHeaderVersionOne header{};
+
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	const auto &properties = device.get_gpu().get_properties();
+
+	return header.headerSize >= sizeof(header) &&
+	       header.headerSize <= data.size() &&
+	       header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+	       header.vendorID == properties.vendorID &&
+	       header.deviceID == properties.deviceID &&
+	       std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+VkPipelineCache PipelineCache::create_cache(const std::vector<uint8_t> &data) const
+{
+	VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+	create_info.initialDataSize = data.size();
+	create_info.pInitialData    = data.data();
+
+	VkPipelineCache cache{VK_NULL_HANDLE};
+
+	if (vkCreatePipelineCache(device.get_handle(), &create_info, nullptr, &cache) != VK_SUCCESS)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return cache;
+}
+
+size_t PipelineCache::get_data_size() const
+{
+	size_t size = 0;
+
+	if (vkGetPipelineCacheData(device.get_handle(), handle, &size, nullptr) != VK_SUCCESS)
+	{
+		return 0;
+	}
+
+	return size;
+}
+}        // namespace vkb
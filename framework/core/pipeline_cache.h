@@ -0,0 +1,159 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Number of pipelines created with and without a pipeline cache hit,
+ *        as reported by VK_EXT_pipeline_creation_feedback
+ */
+struct PipelineCacheStats
+{
+	uint32_t hits{0};
+
+	uint32_t misses{0};
+
+	/// Pipelines created without creation feedback
+	uint32_t unknown{0};
+};
+
+/**
+ * @brief The pipeline cache of a device, persisted in the temporary directory between runs
+ *
+ * The cache data is only loaded if its header matches the vendor, the device and the pipeline cache UUID of the GPU.
+ * Worker threads building pipelines in parallel get caches of their own, seeded with the loaded data,
+ * to avoid contending on the device cache. They are merged back into the device cache when it is saved.
+ */
+class PipelineCache
+{
+  public:
+	/**
+	 * @brief Creates the pipeline cache, with the data of the previous run if it is valid for the GPU
+	 * @param device A valid device
+	 * @param save_interval Minimum time in seconds between two periodic saves
+	 */
+	PipelineCache(Device &device, float save_interval = 30.0f);
+
+	PipelineCache(const PipelineCache &) = delete;
+
+	PipelineCache(PipelineCache &&) = delete;
+
+	/**
+	 * @brief Saves the cache and destroys the Vulkan caches
+	 */
+	~PipelineCache();
+
+	PipelineCache &operator=(const PipelineCache &) = delete;
+
+	PipelineCache &operator=(PipelineCache &&) = delete;
+
+	/**
+	 * @return The device cache, to be used by the thread which created the pipeline cache
+	 */
+	VkPipelineCache get_handle() const;
+
+	/**
+	 * @return The cache of the calling thread, which is the device cache for the thread which created the pipeline cache,
+	 *         or VK_NULL_HANDLE if the cache of a worker thread could not be created
+	 */
+	VkPipelineCache get_thread_handle();
+
+	/**
+	 * @brief Merges the caches of the worker threads into the device cache
+	 *        It must be called from the thread which created the pipeline cache.
+	 */
+	void merge();
+
+	/**
+	 * @brief Merges the caches of the worker threads and writes the device cache to the temporary directory
+	 *        It must be called from the thread which created the pipeline cache.
+	 * @return Whether the cache was written
+	 */
+	bool save();
+
+	/**
+	 * @brief Saves the cache if it grew since the last save and the save interval elapsed
+	 * @param delta_time Time in seconds since the last update
+	 */
+	void update(float delta_time);
+
+	/**
+	 * @return Whether the data of the previous run was loaded into the cache
+	 */
+	bool is_warm() const;
+
+	/**
+	 * @return Whether the pipelines created by the framework report if they hit the cache
+	 */
+	bool is_creation_feedback_enabled() const;
+
+	/**
+	 * @brief Counts a pipeline creation from the feedback of the driver
+	 * @param stats The statistics to update
+	 * @param feedback Creation feedback of the pipeline, or nullptr if it was created without feedback
+	 */
+	static void count(PipelineCacheStats &stats, const VkPipelineCreationFeedbackEXT *feedback);
+
+  private:
+	Device &device;
+
+	std::string path;
+
+	VkPipelineCache handle{VK_NULL_HANDLE};
+
+	/// Thread which created the cache and owns the device cache
+	std::thread::id owner_thread;
+
+	/// Validated data of the previous run, to seed the caches of the worker threads
+	std::vector<uint8_t> initial_data;
+
+	std::mutex thread_caches_mutex;
+
+	std::unordered_map<std::thread::id, VkPipelineCache> thread_caches;
+
+	float save_interval;
+
+	float time_since_save{0.0f};
+
+	size_t saved_size{0};
+
+	bool warm{false};
+
+	bool creation_feedback_enabled{false};
+
+	/**
+	 * @return Whether the data starts with a pipeline cache header matching the GPU
+	 */
+	bool is_compatible(const std::vector<uint8_t> &data) const;
+
+	VkPipelineCache create_cache(const std::vector<uint8_t> &data) const;
+
+	size_t get_data_size() const;
+};
+}        // namespace vkb
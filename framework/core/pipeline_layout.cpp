@@ -24,6 +24,24 @@
 
 namespace vkb
 {
+namespace
+{
+/**
+ * @brief Checks whether the resources of a set can be written to a descriptor buffer
+ *        Dynamic and update-after-bind resources need descriptor sets, as do arrays of combined
+ *        image samplers on GPUs which split them into arrays of images and arrays of samplers.
+ *        The descriptor types of the other resources are all written by CommandBuffer::write_descriptor_buffer.
+ */
+inline bool supports_descriptor_buffer(const std::vector<ShaderResource> &resource_set, const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties)
+{
+	return std::none_of(resource_set.begin(), resource_set.end(), [&properties](const ShaderResource &resource) {
+		return resource.mode == ShaderResourceMode::Dynamic ||
+		       resource.mode == ShaderResourceMode::UpdateAfterBind ||
+		       (resource.type == ShaderResourceType::ImageSampler && resource.array_size > 1 && !properties.combinedImageSamplerDescriptorSingleArray);
+	});
+}
+}        // namespace
+
 PipelineLayout::PipelineLayout(Device &device, const std::vector<ShaderModule *> &shader_modules) :
     device{device},
     shader_modules{shader_modules}
@@ -78,10 +96,18 @@ PipelineLayout::PipelineLayout(Device &device, const std::vector<ShaderModule *>
 		}
 	}
 
+	// Descriptor buffers are only used if every set of the layout supports them
+	if (device.is_descriptor_buffer_enabled())
+	{
+		descriptor_buffer = std::all_of(shader_sets.begin(), shader_sets.end(), [&device](const auto &shader_set_it) {
+			return supports_descriptor_buffer(shader_set_it.second, device.get_descriptor_buffer_properties());
+		});
+	}
+
 	// Create a descriptor set layout for each shader set in the shader modules
 	for (auto &shader_set_it : shader_sets)
 	{
-		descriptor_set_layouts.emplace_back(&device.get_resource_cache().request_descriptor_set_layout(shader_set_it.first, shader_modules, shader_set_it.second));
+		descriptor_set_layouts.emplace_back(&device.get_resource_cache().request_descriptor_set_layout(shader_set_it.first, shader_modules, shader_set_it.second, descriptor_buffer));
 	}
 
 	// Collect all the descriptor set layout handles, maintaining set order
@@ -127,7 +153,8 @@ PipelineLayout::PipelineLayout(PipelineLayout &&other) :
     shader_modules{std::move(other.shader_modules)},
     shader_resources{std::move(other.shader_resources)},
     shader_sets{std::move(other.shader_sets)},
-    descriptor_set_layouts{std::move(other.descriptor_set_layouts)}
+    descriptor_set_layouts{std::move(other.descriptor_set_layouts)},
+    descriptor_buffer{other.descriptor_buffer}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -206,4 +233,9 @@ VkShaderStageFlags PipelineLayout::get_push_constant_range_stage(uint32_t size,
 	}
 	return stages;
 }
+
+bool PipelineLayout::is_descriptor_buffer() const
+{
+	return descriptor_buffer;
+}
 }        // namespace vkb
@@ -57,6 +57,11 @@ class PipelineLayout
 
 	VkShaderStageFlags get_push_constant_range_stage(uint32_t size, uint32_t offset = 0) const;
 
+	/**
+	 * @return Whether the descriptors of the layout are written to descriptor buffers instead of descriptor sets
+	 */
+	bool is_descriptor_buffer() const;
+
   private:
 	Device &device;
 
@@ -73,5 +78,8 @@ class PipelineLayout
 
 	// The different descriptor set layouts for this pipeline layout
 	std::vector<DescriptorSetLayout *> descriptor_set_layouts;
+
+	// Whether all the sets of the layout use descriptor buffers, they can't be mixed with descriptor sets
+	bool descriptor_buffer{false};
 };
 }        // namespace vkb
@@ -17,8 +17,12 @@
 
 #include "shader_module.h"
 
+#include <cstring>
+#include <map>
+
 #include "core/util/logging.hpp"
 #include "device.h"
+#include "filesystem/filesystem.hpp"
 #include "filesystem/legacy.h"
 #include "glsl_compiler.h"
 #include "spirv_reflection.h"
@@ -77,6 +81,326 @@ inline std::vector<uint8_t> convert_to_bytes(std::vector<std::string> &lines)
 	return bytes;
 }
 
+namespace
+{
+/// Identifies a shader cache file, "VKSC"
+constexpr uint32_t shader_cache_magic = 0x43534B56;
+
+/// Version of the shader cache file layout, to be bumped whenever it changes
+constexpr uint32_t shader_cache_version = 2;
+
+/// Directory of the shader cache files, relative to the temporary storage directory
+const char *shader_cache_directory = "vulkan_samples_shader_cache";
+
+/**
+ * @brief Computes the key of a compiled shader in the disk cache
+ *        It covers everything which affects the SPIR-V code and its reflection. The cache files are named after
+ *        a hash of the key and store the key itself, so that a hash collision is a cache miss.
+ */
+std::string get_shader_cache_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant)
+{
+	std::string key;
+
+	// Each field is prefixed with its size, so that the fields can't run into each other
+	auto append = [&key](const std::string &field) {
+		key += std::to_string(field.size());
+		key += ':';
+		key += field;
+	};
+
+	append(std::string{glsl_source.begin(), glsl_source.end()});
+	append(shader_variant.get_preamble());
+
+	append(std::to_string(shader_variant.get_processes().size()));
+
+	for (auto &process : shader_variant.get_processes())
+	{
+		append(process);
+	}
+
+	// Sort the runtime array sizes so that the key does not depend on the map order
+	std::map<std::string, size_t> runtime_array_sizes{shader_variant.get_runtime_array_sizes().begin(),
+	                                                  shader_variant.get_runtime_array_sizes().end()};
+
+	append(std::to_string(runtime_array_sizes.size()));
+
+	for (auto &runtime_array_size : runtime_array_sizes)
+	{
+		append(runtime_array_size.first);
+		append(std::to_string(runtime_array_size.second));
+	}
+
+	append(std::to_string(static_cast<uint32_t>(stage)));
+	append(entry_point);
+
+	auto glslang_version = glslang::GetVersion();
+	append(fmt::format("{}.{}.{}{}", glslang_version.major, glslang_version.minor, glslang_version.patch, glslang_version.flavor ? glslang_version.flavor : ""));
+
+	auto target_environment = GLSLCompiler::get_target_environment();
+	append(fmt::format("{}/{}", static_cast<uint32_t>(target_environment.first), static_cast<uint32_t>(target_environment.second)));
+
+	return key;
+}
+
+filesystem::Path get_shader_cache_path(const std::string &key)
+{
+	return filesystem::get()->temp_directory() / shader_cache_directory / fmt::format("{:016X}.bin", static_cast<uint64_t>(std::hash<std::string>{}(key)));
+}
+
+/**
+ * @brief Writes the fields of a shader cache file, see ShaderCacheReader
+ */
+class ShaderCacheWriter
+{
+  public:
+	void write_u32(uint32_t value)
+	{
+		write(&value, sizeof(value));
+	}
+
+	void write_u64(uint64_t value)
+	{
+		write(&value, sizeof(value));
+	}
+
+	void write(const void *data, size_t size)
+	{
+		auto first = reinterpret_cast<const uint8_t *>(data);
+		bytes.insert(bytes.end(), first, first + size);
+	}
+
+	void write_string(const std::string &value)
+	{
+		write_u32(to_u32(value.size()));
+		write(value.data(), value.size());
+	}
+
+	/**
+	 * @brief Appends a checksum of the data written so far, and returns the data
+	 */
+	std::vector<uint8_t> finish()
+	{
+		write_u64(std::hash<std::string>{}(std::string{bytes.begin(), bytes.end()}));
+		return std::move(bytes);
+	}
+
+  private:
+	std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Reads the fields of a shader cache file
+ *        Reads past the end of the data fail instead of throwing, so that a truncated file is a cache miss
+ */
+class ShaderCacheReader
+{
+  public:
+	ShaderCacheReader(const std::vector<uint8_t> &bytes) :
+	    bytes{bytes}
+	{}
+
+	/**
+	 * @brief Checks the checksum at the end of the data
+	 */
+	bool verify() const
+	{
+		uint64_t checksum = 0;
+
+		if (bytes.size() < sizeof(checksum))
+		{
+			return false;
+		}
+
+		auto payload_size = bytes.size() - sizeof(checksum);
+		std::memcpy(&checksum, bytes.data() + payload_size, sizeof(checksum));
+
+		return checksum == std::hash<std::string>{}(std::string{bytes.begin(), bytes.begin() + payload_size});
+	}
+
+	bool read_u32(uint32_t &value)
+	{
+		return read(&value, sizeof(value));
+	}
+
+	bool read_u64(uint64_t &value)
+	{
+		return read(&value, sizeof(value));
+	}
+
+	bool read(void *data, size_t size)
+	{
+		if (size > bytes.size() - offset)
+		{
+			return false;
+		}
+
+		std::memcpy(data, bytes.data() + offset, size);
+		offset += size;
+
+		return true;
+	}
+
+	bool read_string(std::string &value)
+	{
+		uint32_t size = 0;
+
+		if (!read_u32(size) || size > bytes.size() - offset)
+		{
+			return false;
+		}
+
+		value.assign(reinterpret_cast<const char *>(bytes.data() + offset), size);
+		offset += size;
+
+		return true;
+	}
+
+  private:
+	const std::vector<uint8_t> &bytes;
+
+	size_t offset{0};
+};
+
+/**
+ * @brief Loads a compiled shader and its resources from the disk cache
+ * @return Whether a valid cache file was found for the key
+ */
+bool load_cached_shader(const std::string &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	auto fs   = filesystem::get();
+	auto path = get_shader_cache_path(key);
+
+	if (!fs->is_file(path))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+
+	try
+	{
+		data = fs->read_file_binary(path);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read shader cache file {}: {}", path.string(), e.what());
+		return false;
+	}
+
+	ShaderCacheReader reader{data};
+
+	uint32_t    magic      = 0;
+	uint32_t    version    = 0;
+	std::string file_key;
+	uint32_t    spirv_size = 0;
+
+	// The whole key is compared, as different keys can share a file name
+	if (!reader.verify() ||
+	    !reader.read_u32(magic) || magic != shader_cache_magic ||
+	    !reader.read_u32(version) || version != shader_cache_version ||
+	    !reader.read_string(file_key) || file_key != key ||
+	    !reader.read_u32(spirv_size) || spirv_size == 0 || spirv_size > data.size() / sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	std::vector<uint32_t> cached_spirv(spirv_size);
+
+	uint32_t resource_count = 0;
+
+	if (!reader.read(cached_spirv.data(), spirv_size * sizeof(uint32_t)) ||
+	    !reader.read_u32(resource_count) || resource_count > data.size())
+	{
+		return false;
+	}
+
+	std::vector<ShaderResource> cached_resources(resource_count);
+
+	for (auto &resource : cached_resources)
+	{
+		uint32_t stages = 0;
+		uint32_t type   = 0;
+		uint32_t mode   = 0;
+
+		if (!reader.read_u32(stages) ||
+		    !reader.read_u32(type) ||
+		    !reader.read_u32(mode) ||
+		    !reader.read_u32(resource.set) ||
+		    !reader.read_u32(resource.binding) ||
+		    !reader.read_u32(resource.location) ||
+		    !reader.read_u32(resource.input_attachment_index) ||
+		    !reader.read_u32(resource.vec_size) ||
+		    !reader.read_u32(resource.columns) ||
+		    !reader.read_u32(resource.array_size) ||
+		    !reader.read_u32(resource.offset) ||
+		    !reader.read_u32(resource.size) ||
+		    !reader.read_u32(resource.constant_id) ||
+		    !reader.read_u32(resource.qualifiers) ||
+		    !reader.read_string(resource.name) ||
+		    type > static_cast<uint32_t>(ShaderResourceType::All) ||
+		    mode > static_cast<uint32_t>(ShaderResourceMode::UpdateAfterBind))
+		{
+			return false;
+		}
+
+		resource.stages = stages;
+		resource.type   = static_cast<ShaderResourceType>(type);
+		resource.mode   = static_cast<ShaderResourceMode>(mode);
+	}
+
+	spirv     = std::move(cached_spirv);
+	resources = std::move(cached_resources);
+
+	return true;
+}
+
+/**
+ * @brief Stores a compiled shader and its resources in the disk cache
+ *        Failing to write the cache is not an error, the shader will be compiled again next time
+ */
+void store_cached_shader(const std::string &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	ShaderCacheWriter writer;
+
+	writer.write_u32(shader_cache_magic);
+	writer.write_u32(shader_cache_version);
+	writer.write_string(key);
+	writer.write_u32(to_u32(spirv.size()));
+	writer.write(spirv.data(), spirv.size() * sizeof(uint32_t));
+	writer.write_u32(to_u32(resources.size()));
+
+	for (auto &resource : resources)
+	{
+		writer.write_u32(static_cast<uint32_t>(resource.stages));
+		writer.write_u32(static_cast<uint32_t>(resource.type));
+		writer.write_u32(static_cast<uint32_t>(resource.mode));
+		writer.write_u32(resource.set);
+		writer.write_u32(resource.binding);
+		writer.write_u32(resource.location);
+		writer.write_u32(resource.input_attachment_index);
+		writer.write_u32(resource.vec_size);
+		writer.write_u32(resource.columns);
+		writer.write_u32(resource.array_size);
+		writer.write_u32(resource.offset);
+		writer.write_u32(resource.size);
+		writer.write_u32(resource.constant_id);
+		writer.write_u32(resource.qualifiers);
+		writer.write_string(resource.name);
+	}
+
+	auto path = get_shader_cache_path(key);
+
+	try
+	{
+		filesystem::get()->write_file(path, writer.finish());
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write shader cache file {}: {}", path.string(), e.what());
+	}
+}
+}        // namespace
+
 ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant) :
     device{device},
     stage{stage},
@@ -101,23 +425,32 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 
 	// Precompile source into the final spirv bytecode
 	auto glsl_final_source = precompile_shader(source);
+	auto glsl_final_bytes  = convert_to_bytes(glsl_final_source);
 
-	// Compile the GLSL source
-	GLSLCompiler glsl_compiler;
+	// Reuse the SPIR-V and the reflection of a previous run if the disk cache has them
+	auto cache_key = get_shader_cache_key(stage, glsl_final_bytes, entry_point, shader_variant);
 
-	if (!glsl_compiler.compile_to_spirv(stage, convert_to_bytes(glsl_final_source), entry_point, shader_variant, spirv, info_log))
+	if (!load_cached_shader(cache_key, spirv, resources))
 	{
-		LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
-		LOGE("{}", info_log);
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
-	}
+		// Compile the GLSL source
+		GLSLCompiler glsl_compiler;
 
-	SPIRVReflection spirv_reflection;
+		if (!glsl_compiler.compile_to_spirv(stage, glsl_final_bytes, entry_point, shader_variant, spirv, info_log))
+		{
+			LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
+			LOGE("{}", info_log);
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
 
-	// Reflect all shader resources
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
-	{
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		SPIRVReflection spirv_reflection;
+
+		// Reflect all shader resources
+		if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		store_cached_shader(cache_key, spirv, resources);
 	}
 
 	// Generate a unique id, determined by source and variant
@@ -126,6 +459,25 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 	                        reinterpret_cast<const char *>(spirv.data() + spirv.size())});
 }
 
+ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, std::vector<uint32_t> &&spirv, std::vector<ShaderResource> &&resources, const std::string &entry_point, const std::string &debug_name) :
+    device{device},
+    stage{stage},
+    entry_point{entry_point},
+    debug_name{debug_name},
+    spirv{std::move(spirv)},
+    resources{std::move(resources)}
+{
+	if (this->spirv.empty() || entry_point.empty())
+	{
+		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+	}
+
+	// Same id as a shader module compiled to this code
+	std::hash<std::string> hasher{};
+	id = hasher(std::string{reinterpret_cast<const char *>(this->spirv.data()),
+	                        reinterpret_cast<const char *>(this->spirv.data() + this->spirv.size())});
+}
+
 ShaderModule::ShaderModule(ShaderModule &&other) :
     device{other.device},
     id{other.id},
@@ -201,6 +201,16 @@ class ShaderModule
 	             const std::string &   entry_point,
 	             const ShaderVariant & shader_variant);
 
+	/**
+	 * @brief Creates a shader module from SPIR-V code which was compiled and reflected beforehand
+	 */
+	ShaderModule(Device &                      device,
+	             VkShaderStageFlagBits         stage,
+	             std::vector<uint32_t> &&      spirv,
+	             std::vector<ShaderResource> &&resources,
+	             const std::string &           entry_point,
+	             const std::string &           debug_name);
+
 	ShaderModule(const ShaderModule &) = delete;
 
 	ShaderModule(ShaderModule &&other);
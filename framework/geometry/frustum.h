@@ -55,6 +55,14 @@ class Frustum
 	 */
 	bool check_sphere(glm::vec3 pos, float radius);
 
+	/**
+	 * @brief Checks if an axis aligned bounding box is inside the Frustum
+	 *        The test is conservative, some boxes outside of the Frustum near its corners may pass
+	 * @param min The minimum corner of the box
+	 * @param max The maximum corner of the box
+	 */
+	bool check_aabb(const glm::vec3 &min, const glm::vec3 &max) const;
+
 	const std::array<glm::vec4, 6> &get_planes() const;
 
   private:
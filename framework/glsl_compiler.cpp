@@ -95,6 +95,11 @@ void GLSLCompiler::reset_target_environment()
 	GLSLCompiler::env_target_language_version = static_cast<glslang::EShTargetLanguageVersion>(0);
 }
 
+std::pair<glslang::EShTargetLanguage, glslang::EShTargetLanguageVersion> GLSLCompiler::get_target_environment()
+{
+	return {GLSLCompiler::env_target_language, GLSLCompiler::env_target_language_version};
+}
+
 bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     const std::vector<uint8_t> &glsl_source,
                                     const std::string          &entry_point,
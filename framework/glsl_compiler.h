@@ -51,6 +51,11 @@ class GLSLCompiler
 	 */
 	static void reset_target_environment();
 
+	/**
+	 * @return The glslang target environment currently used to generate code
+	 */
+	static std::pair<glslang::EShTargetLanguage, glslang::EShTargetLanguageVersion> get_target_environment();
+
 	/**
 	 * @brief Compiles GLSL to SPIRV code
 	 * @param stage The Vulkan shader stage flag
@@ -19,6 +19,8 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <queue>
 
@@ -37,6 +39,7 @@
 #include "core/util/logging.hpp"
 #include "filesystem/legacy.h"
 #include "scene_graph/components/camera.h"
+#include "scene_graph/components/geometry_buffer.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/image/astc.h"
 #include "scene_graph/components/light.h"
@@ -117,7 +120,55 @@ inline VkSamplerAddressMode find_wrap_mode(int wrap)
 	}
 };
 
-inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId)
+/**
+ * @brief A view of the elements of a glTF accessor in the buffer of the model, to read them without copying the buffer
+ */
+struct AccessorView
+{
+	const uint8_t *data{nullptr};
+
+	size_t count{0};
+
+	/// Distance in bytes between the start of two elements
+	size_t stride{0};
+
+	/**
+	 * @return The size in bytes of the data viewed
+	 */
+	size_t size() const
+	{
+		return count * stride;
+	}
+
+	template <typename T>
+	T get(size_t index) const
+	{
+		T value;
+		std::memcpy(&value, data + index * stride, sizeof(T));
+		return value;
+	}
+
+	/**
+	 * @brief Copies a range of elements to a tightly packed destination
+	 *        Elements smaller than the destination stride are zero-extended, as done for 8-bit indices
+	 */
+	void copy_to(uint8_t *dst, size_t first, size_t element_count, size_t dst_stride) const
+	{
+		if (dst_stride == stride)
+		{
+			std::memcpy(dst, data + first * stride, element_count * stride);
+			return;
+		}
+
+		std::memset(dst, 0, element_count * dst_stride);
+		for (size_t i = 0; i < element_count; ++i)
+		{
+			std::memcpy(dst + i * dst_stride, data + (first + i) * stride, std::min(stride, dst_stride));
+		}
+	}
+};
+
+inline AccessorView get_accessor_view(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
 	auto &accessor = model->accessors[accessorId];
@@ -126,11 +177,19 @@ inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uin
 	assert(bufferView.buffer < model->buffers.size());
 	auto &buffer = model->buffers[bufferView.buffer];
 
-	size_t stride    = accessor.ByteStride(bufferView);
-	size_t startByte = accessor.byteOffset + bufferView.byteOffset;
-	size_t endByte   = startByte + accessor.count * stride;
+	AccessorView view;
+	view.data   = buffer.data.data() + accessor.byteOffset + bufferView.byteOffset;
+	view.count  = accessor.count;
+	view.stride = accessor.ByteStride(bufferView);
+
+	return view;
+}
+
+inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId)
+{
+	auto view = get_accessor_view(model, accessorId);
 
-	return {buffer.data.begin() + startByte, buffer.data.begin() + endByte};
+	return {view.data, view.data + view.size()};
 };
 
 inline size_t get_attribute_size(const tinygltf::Model *model, uint32_t accessorId)
@@ -334,6 +393,405 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::Buffer
 	}
 }
 
+/// Alignment of the geometry of each attribute and index list within the buffers holding them
+constexpr VkDeviceSize geometry_alignment = 16;
+
+/// Maximum size of a buffer suballocated for the geometry of a scene
+constexpr VkDeviceSize max_geometry_buffer_size = 256 * 1024 * 1024;
+
+inline VkDeviceSize align_geometry_offset(VkDeviceSize offset)
+{
+	return (offset + geometry_alignment - 1) & ~(geometry_alignment - 1);
+}
+
+/**
+ * @brief Uploads buffer data to device local memory through a staging buffer which is reused across batches
+ *        Data is written to the staging buffer until it is full, then the batch of copies is submitted and waited on
+ */
+class StagingRing
+{
+  public:
+	StagingRing(Device &device, VkDeviceSize capacity) :
+	    device{device},
+	    staging_buffer{vkb::core::BufferC::create_staging_buffer(device, std::max<VkDeviceSize>(capacity, 1), nullptr)}
+	{
+		staging_buffer.set_debug_name("glTF geometry staging buffer");
+	}
+
+	StagingRing(const StagingRing &) = delete;
+
+	StagingRing &operator=(const StagingRing &) = delete;
+
+	/**
+	 * @brief Stages the elements of an accessor to be copied to a buffer, which must outlive the next flush
+	 *        Elements are written straight from the glTF buffer to the staging memory, and zero-extended to dst_stride.
+	 *        Data larger than the staging buffer is split across several batches
+	 */
+	void upload(const vkb::core::BufferC &dst_buffer, VkDeviceSize dst_offset, const AccessorView &view, size_t dst_stride)
+	{
+		assert(dst_stride <= staging_buffer.get_size());
+
+		size_t first = 0;
+
+		while (first < view.count)
+		{
+			if (staging_buffer.get_size() - offset < dst_stride)
+			{
+				flush();
+			}
+
+			size_t count = std::min(view.count - first, static_cast<size_t>((staging_buffer.get_size() - offset) / dst_stride));
+
+			view.copy_to(staging_buffer.map() + offset, first, count, dst_stride);
+
+			VkDeviceSize size = static_cast<VkDeviceSize>(count) * dst_stride;
+
+			if (copies.empty() || copies.back().first != &dst_buffer)
+			{
+				copies.emplace_back(&dst_buffer, std::vector<VkBufferCopy>{});
+			}
+			copies.back().second.push_back({offset, dst_offset + static_cast<VkDeviceSize>(first) * dst_stride, size});
+
+			// Keep the copies aligned, as the data of some formats is read with a larger alignment
+			offset = std::min(staging_buffer.get_size(), align_geometry_offset(offset + size));
+			first += count;
+		}
+	}
+
+	/**
+	 * @brief Submits the copies staged so far and waits for them to complete, so the staging buffer can be reused
+	 */
+	void flush()
+	{
+		if (copies.empty())
+		{
+			return;
+		}
+
+		staging_buffer.flush();
+
+		auto &command_buffer = device.request_command_buffer();
+
+		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+		for (auto &copy : copies)
+		{
+			command_buffer.copy_buffer(staging_buffer, *copy.first, copy.second);
+
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_MEMORY_READ_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			command_buffer.buffer_memory_barrier(*copy.first, 0, VK_WHOLE_SIZE, memory_barrier);
+		}
+
+		command_buffer.end();
+
+		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+		queue.submit(command_buffer, device.request_fence());
+
+		device.get_fence_pool().wait();
+		device.get_fence_pool().reset();
+		device.get_command_pool().reset_pool();
+
+		copies.clear();
+		offset = 0;
+	}
+
+  private:
+	Device &device;
+
+	vkb::core::BufferC staging_buffer;
+
+	/// Offset of the free space of the staging buffer
+	VkDeviceSize offset{0};
+
+	/// Copy regions of the current batch, grouped by destination buffer
+	std::vector<std::pair<const vkb::core::BufferC *, std::vector<VkBufferCopy>>> copies;
+};
+
+/**
+ * @brief Computes upper bounds of the size of the vertex data and of the index data of a glTF model, including alignment
+ */
+inline void get_geometry_sizes(const tinygltf::Model &model, VkDeviceSize &vertex_size, VkDeviceSize &index_size)
+{
+	vertex_size = 0;
+	index_size  = 0;
+
+	for (auto &gltf_mesh : model.meshes)
+	{
+		for (auto &gltf_primitive : gltf_mesh.primitives)
+		{
+			for (auto &attribute : gltf_primitive.attributes)
+			{
+				vertex_size += align_geometry_offset(get_attribute_size(&model, attribute.second) * get_attribute_stride(&model, attribute.second));
+			}
+
+			if (gltf_primitive.indices >= 0)
+			{
+				// 8-bit indices are converted to 16-bit indices
+				index_size += align_geometry_offset(get_attribute_size(&model, gltf_primitive.indices) * std::max<size_t>(get_attribute_stride(&model, gltf_primitive.indices), 2));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Suballocates the geometry of a scene from a few large buffers
+ *        A buffer is created when the previous one is full, sized for the rest of the geometry up to a maximum size
+ */
+class GeometryArena
+{
+  public:
+	GeometryArena(Device &device, const std::string &name, VkBufferUsageFlags usage, VkDeviceSize total_size) :
+	    device{device},
+	    name{name},
+	    usage{usage},
+	    remaining_size{total_size}
+	{}
+
+	/**
+	 * @brief Allocates space for data in the current buffer, or in a new one if it doesn't fit
+	 * @return The buffer holding the data and the offset of the data in it
+	 */
+	std::pair<const vkb::core::BufferC *, VkDeviceSize> allocate(VkDeviceSize size)
+	{
+		VkDeviceSize offset = align_geometry_offset(used_size);
+
+		if (buffers.empty() || offset + size > buffers.back()->buffer.get_size())
+		{
+			vkb::core::BufferC buffer{device,
+			                          std::max(size, std::min(remaining_size, max_geometry_buffer_size)),
+			                          usage,
+			                          VMA_MEMORY_USAGE_GPU_ONLY};
+			buffer.set_debug_name(fmt::format("{} #{}", name, buffers.size()));
+
+			buffers.push_back(std::make_unique<sg::GeometryBuffer>(fmt::format("{} #{}", name, buffers.size()), std::move(buffer)));
+
+			offset = 0;
+		}
+
+		used_size      = offset + size;
+		remaining_size = remaining_size - std::min(remaining_size, align_geometry_offset(size));
+
+		return {&buffers.back()->buffer, offset};
+	}
+
+	std::vector<std::unique_ptr<sg::GeometryBuffer>> &get_buffers()
+	{
+		return buffers;
+	}
+
+  private:
+	Device &device;
+
+	std::string name;
+
+	VkBufferUsageFlags usage;
+
+	/// Size of the geometry left to allocate, to size the next buffer
+	VkDeviceSize remaining_size;
+
+	/// Size used in the current buffer
+	VkDeviceSize used_size{0};
+
+	std::vector<std::unique_ptr<sg::GeometryBuffer>> buffers;
+};
+
+/**
+ * @brief The geometry of a glTF primitive, prepared on a worker thread and uploaded on the loading thread
+ *        It refers to the data in the glTF buffers, which is only copied to the Vulkan buffers
+ */
+struct PrimitiveData
+{
+	struct Attribute
+	{
+		std::string name;
+
+		sg::VertexAttribute attribute;
+
+		AccessorView data;
+	};
+
+	std::vector<Attribute> attributes;
+
+	std::uint32_t vertices_count{0};
+
+	std::uint32_t vertex_indices{0};
+
+	VkIndexType index_type{};
+
+	AccessorView index_data;
+
+	/// Size of an index in the index buffer, which can be larger than in the glTF buffer
+	size_t index_stride{0};
+};
+
+/**
+ * @brief A glTF mesh with the geometry of its primitives
+ */
+struct MeshData
+{
+	std::unique_ptr<sg::Mesh> mesh;
+
+	std::vector<PrimitiveData> primitives;
+};
+
+/**
+ * @brief Reads the geometry of a glTF primitive, and extends the bounds of its mesh with it
+ */
+inline PrimitiveData read_primitive(const tinygltf::Model &model, const tinygltf::Primitive &gltf_primitive, sg::Mesh &mesh)
+{
+	PrimitiveData primitive;
+
+	for (auto &attribute : gltf_primitive.attributes)
+	{
+		std::string attrib_name = attribute.first;
+		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+		auto vertex_data = get_accessor_view(&model, attribute.second);
+
+		if (attrib_name == "position")
+		{
+			assert(attribute.second < model.accessors.size());
+			auto &accessor           = model.accessors[attribute.second];
+			primitive.vertices_count = to_u32(accessor.count);
+
+			// The mesh bounds are used to cull nodes, so they must enclose every primitive of the mesh
+			if (accessor.minValues.size() >= 3 && accessor.maxValues.size() >= 3)
+			{
+				mesh.update_bounds({glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]),
+				                    glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2])});
+			}
+			else if (get_attribute_format(&model, attribute.second) == VK_FORMAT_R32G32B32_SFLOAT && vertex_data.count > 0)
+			{
+				sg::AABB bounds;
+				for (size_t i = 0; i < vertex_data.count; ++i)
+				{
+					bounds.update(vertex_data.get<glm::vec3>(i));
+				}
+				mesh.update_bounds({bounds.get_min(), bounds.get_max()});
+			}
+		}
+
+		sg::VertexAttribute attrib;
+		attrib.format = get_attribute_format(&model, attribute.second);
+		attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+
+		primitive.attributes.push_back({attrib_name, attrib, vertex_data});
+	}
+
+	if (gltf_primitive.indices >= 0)
+	{
+		primitive.vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+
+		auto format = get_attribute_format(&model, gltf_primitive.indices);
+
+		primitive.index_data   = get_accessor_view(&model, gltf_primitive.indices);
+		primitive.index_stride = primitive.index_data.stride;
+
+		switch (format)
+		{
+			case VK_FORMAT_R8_UINT:
+				// uint8 data is converted into uint16 data when it is copied to the index buffer
+				primitive.index_stride = 2;
+				primitive.index_type   = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+	}
+	else
+	{
+		primitive.vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+	}
+
+	return primitive;
+}
+
+/**
+ * @brief Reads the keyframes of the samplers of a glTF animation
+ */
+inline std::vector<sg::AnimationSampler> read_animation_samplers(const tinygltf::Model &model, const tinygltf::Animation &gltf_animation)
+{
+	std::vector<sg::AnimationSampler> samplers;
+
+	for (size_t sampler_index = 0; sampler_index < gltf_animation.samplers.size(); ++sampler_index)
+	{
+		auto gltf_sampler = gltf_animation.samplers[sampler_index];
+
+		sg::AnimationSampler sampler;
+		if (gltf_sampler.interpolation == "LINEAR")
+		{
+			sampler.type = sg::AnimationType::Linear;
+		}
+		else if (gltf_sampler.interpolation == "STEP")
+		{
+			sampler.type = sg::AnimationType::Step;
+		}
+		else if (gltf_sampler.interpolation == "CUBICSPLINE")
+		{
+			sampler.type = sg::AnimationType::CubicSpline;
+		}
+		else
+		{
+			LOGW("Gltf animation sampler #{} has unknown interpolation value", sampler_index);
+		}
+
+		auto input_accessor_data = get_accessor_view(&model, gltf_sampler.input);
+
+		sampler.inputs.resize(input_accessor_data.count);
+		for (size_t i = 0; i < input_accessor_data.count; ++i)
+		{
+			sampler.inputs[i] = input_accessor_data.get<float>(i);
+		}
+
+		auto &output_accessor      = model.accessors[gltf_sampler.output];
+		auto  output_accessor_data = get_accessor_view(&model, gltf_sampler.output);
+
+		switch (output_accessor.type)
+		{
+			case TINYGLTF_TYPE_VEC3:
+			{
+				sampler.outputs.resize(output_accessor_data.count);
+				for (size_t i = 0; i < output_accessor_data.count; ++i)
+				{
+					sampler.outputs[i] = glm::vec4(output_accessor_data.get<glm::vec3>(i), 0.0f);
+				}
+				break;
+			}
+			case TINYGLTF_TYPE_VEC4:
+			{
+				sampler.outputs.resize(output_accessor_data.count);
+				for (size_t i = 0; i < output_accessor_data.count; ++i)
+				{
+					sampler.outputs[i] = output_accessor_data.get<glm::vec4>(i);
+				}
+				break;
+			}
+			default:
+			{
+				LOGW("Gltf animation sampler #{} has unknown output data type", sampler_index);
+				continue;
+			}
+		}
+
+		samplers.push_back(std::move(sampler));
+	}
+
+	return samplers;
+}
+
 inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
 {
 	Meshlet meshlet;
@@ -495,6 +953,11 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string
 	return std::move(load_model(index, storage_buffer, additional_buffer_usage_flags));
 }
 
+void GLTFLoader::set_host_visible_geometry(bool host_visible)
+{
+	host_visible_geometry = host_visible;
+}
+
 sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_buffer_usage_flags)
 {
 	PROFILE_SCOPE("Process Scene");
@@ -572,6 +1035,44 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 		image_component_futures.push_back(std::move(fut));
 	}
 
+	// Materials, meshes, nodes and animations are parsed on the same pool, so they are processed while images decode.
+	// This thread only waits for them to create GPU resources and link the components together
+	std::vector<std::future<std::unique_ptr<sg::PBRMaterial>>> material_futures;
+	for (auto &gltf_material : model.materials)
+	{
+		material_futures.push_back(thread_pool.push([this, &gltf_material](size_t) { return parse_material(gltf_material); }));
+	}
+
+	std::vector<std::future<MeshData>> mesh_futures;
+	for (auto &gltf_mesh : model.meshes)
+	{
+		mesh_futures.push_back(thread_pool.push([this, &gltf_mesh](size_t) {
+			PROFILE_SCOPE("Processing Mesh");
+
+			MeshData mesh_data;
+			mesh_data.mesh = parse_mesh(gltf_mesh);
+
+			for (auto &gltf_primitive : gltf_mesh.primitives)
+			{
+				mesh_data.primitives.push_back(read_primitive(model, gltf_primitive, *mesh_data.mesh));
+			}
+
+			return mesh_data;
+		}));
+	}
+
+	std::vector<std::future<std::unique_ptr<sg::Node>>> node_futures;
+	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+	{
+		node_futures.push_back(thread_pool.push([this, node_index](size_t) { return parse_node(model.nodes[node_index], node_index); }));
+	}
+
+	std::vector<std::future<std::vector<sg::AnimationSampler>>> animation_sampler_futures;
+	for (auto &gltf_animation : model.animations)
+	{
+		animation_sampler_futures.push_back(thread_pool.push([this, &gltf_animation](size_t) { return read_animation_samplers(model, gltf_animation); }));
+	}
+
 	std::vector<std::unique_ptr<sg::Image>> image_components;
 
 	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
@@ -684,9 +1185,10 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 		textures = scene.get_components<sg::Texture>();
 	}
 
-	for (auto &gltf_material : model.materials)
+	for (size_t material_index = 0; material_index < model.materials.size(); ++material_index)
 	{
-		auto material = parse_material(gltf_material);
+		auto &gltf_material = model.materials[material_index];
+		auto  material      = material_futures[material_index].get();
 
 		for (auto &gltf_value : gltf_material.values)
 		{
@@ -732,87 +1234,106 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	// Load meshes
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
-	for (auto &gltf_mesh : model.meshes)
+	// Unless the samples need to read the geometry back, vertex and index data is suballocated from a few large
+	// buffers in device local memory. Like images, it is staged in batches of 64MB, through a single staging buffer
+	// reused for every batch
+	std::unique_ptr<StagingRing>   geometry_staging;
+	std::unique_ptr<GeometryArena> vertex_arena;
+	std::unique_ptr<GeometryArena> index_arena;
+
+	if (!host_visible_geometry)
 	{
-		PROFILE_SCOPE("Processing Mesh");
+		VkDeviceSize vertex_size;
+		VkDeviceSize index_size;
+		get_geometry_sizes(model, vertex_size, index_size);
+
+		VkBufferUsageFlags vertex_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | additional_buffer_usage_flags;
+		VkBufferUsageFlags index_usage  = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | additional_buffer_usage_flags;
 
-		auto mesh = parse_mesh(gltf_mesh);
+		geometry_staging = std::make_unique<StagingRing>(device, std::min<VkDeviceSize>(vertex_size + index_size, 64 * 1024 * 1024));
+		vertex_arena     = std::make_unique<GeometryArena>(device, "Scene vertex buffer", vertex_usage, vertex_size);
+		index_arena      = std::make_unique<GeometryArena>(device, "Scene index buffer", index_usage, index_size);
+	}
+
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); ++mesh_index)
+	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+		auto  mesh_data = mesh_futures[mesh_index].get();
+		auto &mesh      = mesh_data.mesh;
 
 		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
+			auto       &primitive      = mesh_data.primitives[i_primitive];
 
 			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
 			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
 
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+			submesh->vertices_count = primitive.vertices_count;
 
-				auto vertex_data = get_attribute_data(&model, attribute.second);
+			for (auto &vertex_attribute : primitive.attributes)
+			{
+				auto &attrib_name = vertex_attribute.name;
+				auto &attrib      = vertex_attribute.attribute;
+				auto &vertex_data = vertex_attribute.data;
 
-				if (attrib_name == "position")
+				if (vertex_arena)
 				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
-
-				vkb::core::BufferC buffer{device,
-				                          vertex_data.size(),
-				                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | additional_buffer_usage_flags,
-				                          VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
+					auto allocation = vertex_arena->allocate(vertex_data.size());
 
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+					submesh->shared_vertex_buffers[attrib_name] = allocation.first;
+					attrib.buffer_offset                        = allocation.second;
 
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+					geometry_staging->upload(*allocation.first, allocation.second, vertex_data, vertex_data.stride);
+				}
+				else
+				{
+					vkb::core::BufferC buffer{device,
+					                          vertex_data.size(),
+					                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | additional_buffer_usage_flags,
+					                          VMA_MEMORY_USAGE_CPU_TO_GPU};
+					vertex_data.copy_to(buffer.map(), 0, vertex_data.count, vertex_data.stride);
+					buffer.flush();
+					buffer.unmap();
+					buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+					                                  gltf_mesh.name, i_primitive, attrib_name));
+
+					submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				}
 
 				submesh->set_attribute(attrib_name, attrib);
 			}
 
 			if (gltf_primitive.indices >= 0)
 			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
-
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
+				auto &index_data = primitive.index_data;
+				auto  index_size = index_data.count * primitive.index_stride;
 
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+				submesh->vertex_indices = primitive.vertex_indices;
+				submesh->index_type     = primitive.index_type;
 
-				switch (format)
+				if (index_arena)
 				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
-				}
+					auto allocation = index_arena->allocate(index_size);
 
-				submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
-				                                                             index_data.size(),
-				                                                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additional_buffer_usage_flags,
-				                                                             VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
+					submesh->shared_index_buffer = allocation.first;
+					submesh->index_offset        = to_u32(allocation.second);
 
-				submesh->index_buffer->update(index_data);
-			}
-			else
-			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+					geometry_staging->upload(*allocation.first, allocation.second, index_data, primitive.index_stride);
+				}
+				else
+				{
+					submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
+					                                                             index_size,
+					                                                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | additional_buffer_usage_flags,
+					                                                             VMA_MEMORY_USAGE_GPU_TO_CPU);
+					submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+					                                                  gltf_mesh.name, i_primitive));
+
+					index_data.copy_to(submesh->index_buffer->map(), 0, index_data.count, primitive.index_stride);
+					submesh->index_buffer->flush();
+					submesh->index_buffer->unmap();
+				}
 			}
 
 			if (gltf_primitive.material < 0)
@@ -833,6 +1354,21 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 		scene.add_component(std::move(mesh));
 	}
 
+	// Submit the last batch of geometry
+	if (geometry_staging)
+	{
+		geometry_staging->flush();
+		geometry_staging.reset();
+
+		for (auto *arena : {vertex_arena.get(), index_arena.get()})
+		{
+			for (auto &buffer : arena->get_buffers())
+			{
+				scene.add_component(std::move(buffer));
+			}
+		}
+	}
+
 	device.get_fence_pool().wait();
 	device.get_fence_pool().reset();
 	device.get_command_pool().reset_pool();
@@ -853,8 +1389,8 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 
 	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
 	{
-		auto gltf_node = model.nodes[node_index];
-		auto node      = parse_node(gltf_node, node_index);
+		auto &gltf_node = model.nodes[node_index];
+		auto  node      = node_futures[node_index].get();
 
 		if (gltf_node.mesh >= 0)
 		{
@@ -899,71 +1435,7 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	{
 		auto &gltf_animation = model.animations[animation_index];
 
-		std::vector<sg::AnimationSampler> samplers;
-
-		for (size_t sampler_index = 0; sampler_index < gltf_animation.samplers.size(); ++sampler_index)
-		{
-			auto gltf_sampler = gltf_animation.samplers[sampler_index];
-
-			sg::AnimationSampler sampler;
-			if (gltf_sampler.interpolation == "LINEAR")
-			{
-				sampler.type = sg::AnimationType::Linear;
-			}
-			else if (gltf_sampler.interpolation == "STEP")
-			{
-				sampler.type = sg::AnimationType::Step;
-			}
-			else if (gltf_sampler.interpolation == "CUBICSPLINE")
-			{
-				sampler.type = sg::AnimationType::CubicSpline;
-			}
-			else
-			{
-				LOGW("Gltf animation sampler #{} has unknown interpolation value", sampler_index);
-			}
-
-			auto input_accessor      = model.accessors[gltf_sampler.input];
-			auto input_accessor_data = get_attribute_data(&model, gltf_sampler.input);
-
-			const float *data = reinterpret_cast<const float *>(input_accessor_data.data());
-			for (size_t i = 0; i < input_accessor.count; ++i)
-			{
-				sampler.inputs.push_back(data[i]);
-			}
-
-			auto output_accessor      = model.accessors[gltf_sampler.output];
-			auto output_accessor_data = get_attribute_data(&model, gltf_sampler.output);
-
-			switch (output_accessor.type)
-			{
-				case TINYGLTF_TYPE_VEC3:
-				{
-					const glm::vec3 *data = reinterpret_cast<const glm::vec3 *>(output_accessor_data.data());
-					for (size_t i = 0; i < output_accessor.count; ++i)
-					{
-						sampler.outputs.push_back(glm::vec4(data[i], 0.0f));
-					}
-					break;
-				}
-				case TINYGLTF_TYPE_VEC4:
-				{
-					const glm::vec4 *data = reinterpret_cast<const glm::vec4 *>(output_accessor_data.data());
-					for (size_t i = 0; i < output_accessor.count; ++i)
-					{
-						sampler.outputs.push_back(glm::vec4(data[i]));
-					}
-					break;
-				}
-				default:
-				{
-					LOGW("Gltf animation sampler #{} has unknown output data type", sampler_index);
-					continue;
-				}
-			}
-
-			samplers.push_back(sampler);
-		}
+		auto samplers = animation_sampler_futures[animation_index].get();
 
 		auto animation = std::make_unique<sg::Animation>(gltf_animation.name);
 
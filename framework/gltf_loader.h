@@ -83,6 +83,13 @@ class GLTFLoader
 	 */
 	std::unique_ptr<sg::SubMesh> read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer = false, VkBufferUsageFlags additional_buffer_usage_flags = 0);
 
+	/**
+	 * @brief Keeps the vertex and index buffers of the scenes loaded in host visible memory
+	 *        By default they are uploaded to device local memory, which the CPU can't read back
+	 * @param host_visible Whether samples need to read back the geometry of the scenes loaded
+	 */
+	void set_host_visible_geometry(bool host_visible);
+
   protected:
 	virtual std::unique_ptr<sg::Node> parse_node(const tinygltf::Node &gltf_node, size_t index) const;
 
@@ -130,6 +137,9 @@ class GLTFLoader
 
 	std::string model_path;
 
+	/// Whether vertex and index buffers of scenes are kept in host visible memory
+	bool host_visible_geometry{false};
+
 	/// The extensions that the GLTFLoader can load mapped to whether they should be enabled or not
 	static std::unordered_map<std::string, bool> supported_extensions;
 
@@ -495,6 +495,7 @@ void Gui::draw(CommandBuffer &command_buffer)
 	}
 
 	ScopedDebugLabel debug_label{command_buffer, "GUI"};
+	ScopedGpuTimer   gpu_timer{command_buffer, "GUI"};
 
 	// Vertex input state
 	VkVertexInputBindingDescription vertex_input_binding{};
@@ -933,6 +934,17 @@ void Gui::show_stats(const Stats &stats)
 			ImGui::Text("%s", graph_label.str().c_str());
 		}
 	}
+
+	// GPU time of the scopes of a recent frame, nested scopes are indented under the scope containing them
+	const auto &gpu_scope_timings = stats.get_gpu_scope_timings();
+	if (!gpu_scope_timings.empty())
+	{
+		ImGui::Text("GPU scopes:");
+		for (const auto &timing : gpu_scope_timings)
+		{
+			ImGui::Text("%*s%s: %.3f ms", static_cast<int>(timing.depth + 1) * 2, "", timing.name.c_str(), timing.time);
+		}
+	}
 }
 
 void Gui::show_options_window(std::function<void()> body, const uint32_t lines)
@@ -492,6 +492,15 @@ void HPPApiVulkanSample::prepare_frame()
 		// VK_SUBOPTIMAL_KHR is a success code and means that acquire was successful and semaphore is signaled but image is suboptimal
 		// allow rendering frame to suboptimal swapchain as otherwise we would have to manually unsignal semaphore and acquire image again
 	}
+	else
+	{
+		// Without a swapchain the images of the render context are used in turn
+		current_buffer = (current_buffer + 1) % static_cast<uint32_t>(swapchain_buffers.size());
+
+		// Stands in for the acquire, which would have signaled the semaphore the submission waits for
+		vk::SubmitInfo acquire_info({}, {}, {}, semaphores.acquired_image_ready);
+		queue.submit(acquire_info);
+	}
 }
 
 void HPPApiVulkanSample::submit_frame()
@@ -538,11 +547,18 @@ void HPPApiVulkanSample::submit_frame()
 			}
 		}
 	}
+	else if (semaphores.render_complete)
+	{
+		// Stands in for the present, which would have waited for the semaphore the submission signaled
+		vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eBottomOfPipe;
+		vk::SubmitInfo         present_info(semaphores.render_complete, wait_stage);
+		queue.submit(present_info);
+	}
 
 	// DO NOT USE
 	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
 	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	get_device().get_queue_by_present(0).get_handle().waitIdle();
+	get_device().get_suitable_graphics_queue().get_handle().waitIdle();
 }
 
 HPPApiVulkanSample::~HPPApiVulkanSample()
@@ -461,6 +461,7 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 	}
 
 	vkb::core::HPPScopedDebugLabel debug_label(command_buffer, "GUI");
+	vkb::core::HPPScopedGpuTimer   gpu_timer(command_buffer, "GUI");
 
 	// Vertex input state
 	vk::VertexInputBindingDescription vertex_input_binding({}, to_u32(sizeof(ImDrawVert)));
@@ -880,6 +881,17 @@ void HPPGui::show_stats(const vkb::stats::HPPStats &stats)
 			ImGui::Text("%s", graph_label.str().c_str());
 		}
 	}
+
+	// GPU time of the scopes of a recent frame, nested scopes are indented under the scope containing them
+	const auto &gpu_scope_timings = stats.get_gpu_scope_timings();
+	if (!gpu_scope_timings.empty())
+	{
+		ImGui::Text("GPU scopes:");
+		for (const auto &timing : gpu_scope_timings)
+		{
+			ImGui::Text("%*s%s: %.3f ms", static_cast<int>(timing.depth + 1) * 2, "", timing.name.c_str(), timing.time);
+		}
+	}
 }
 
 void HPPGui::show_options_window(std::function<void()> body, const uint32_t lines) const
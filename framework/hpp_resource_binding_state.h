@@ -38,15 +38,25 @@ struct HPPResourceInfo
 	const vkb::core::HPPSampler   *sampler    = nullptr;
 };
 
+struct HPPResourceBinding
+{
+	uint32_t        binding       = 0;
+	uint32_t        array_element = 0;
+	HPPResourceInfo info;
+	size_t          hash          = 0;
+	size_t          dynamic_hash  = 0;
+};
+
 class HPPResourceSet : private vkb::ResourceSet
 {
   public:
 	using vkb::ResourceSet::is_dirty;
+	using vkb::ResourceSet::is_empty;
 
   public:
-	const BindingMap<HPPResourceInfo> &get_resource_bindings() const
+	const std::vector<HPPResourceBinding> &get_resource_bindings() const
 	{
-		return reinterpret_cast<BindingMap<HPPResourceInfo> const &>(vkb::ResourceSet::get_resource_bindings());
+		return reinterpret_cast<std::vector<HPPResourceBinding> const &>(vkb::ResourceSet::get_resource_bindings());
 	}
 };
 
@@ -84,9 +94,9 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 		vkb::ResourceBindingState::bind_input(reinterpret_cast<vkb::core::ImageView const &>(image_view), set, binding, array_element);
 	}
 
-	const std::unordered_map<uint32_t, vkb::HPPResourceSet> &get_resource_sets()
+	const std::vector<vkb::HPPResourceSet> &get_resource_sets()
 	{
-		return reinterpret_cast<std::unordered_map<uint32_t, vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
+		return reinterpret_cast<std::vector<vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
 	}
 };
 }        // namespace vkb
@@ -122,7 +122,7 @@ vkb::core::HPPShaderModule &HPPResourceCache::request_shader_module(vk::ShaderSt
 
 std::vector<uint8_t> HPPResourceCache::serialize()
 {
-	return recorder.get_data();
+	return recorder.get_data(device.get_gpu().get_properties());
 }
 
 void HPPResourceCache::set_pipeline_cache(vk::PipelineCache new_pipeline_cache)
@@ -205,8 +205,6 @@ void HPPResourceCache::update_descriptor_sets(const std::vector<vkb::core::HPPIm
 
 void HPPResourceCache::warmup(const std::vector<uint8_t> &data)
 {
-	recorder.set_data(data);
-
-	replayer.play(*this, recorder);
+	replayer.play(*this, data, device.get_gpu().get_properties());
 }
 }        // namespace vkb
@@ -37,8 +37,6 @@ namespace core
 class HPPPipelineLayout;
 class HPPRenderPass;
 class HPPShaderModule;
-class HPPShaderSource;
-class HPPShaderVariant;
 struct HPPSubpassInfo;
 }        // namespace core
 
@@ -50,8 +48,10 @@ struct HPPSubpassInfo;
 class HPPResourceRecord : private vkb::ResourceRecord
 {
   public:
-	using vkb::ResourceRecord::get_data;
-	using vkb::ResourceRecord::set_data;
+	std::vector<uint8_t> get_data(const vk::PhysicalDeviceProperties &properties)
+	{
+		return vkb::ResourceRecord::get_data(static_cast<VkPhysicalDeviceProperties const &>(properties));
+	}
 
 	size_t register_graphics_pipeline(vk::PipelineCache pipeline_cache, vkb::rendering::HPPPipelineState &pipeline_state)
 	{
@@ -73,20 +73,9 @@ class HPPResourceRecord : private vkb::ResourceRecord
 		                                                 reinterpret_cast<std::vector<vkb::SubpassInfo> const &>(subpasses));
 	}
 
-	size_t register_shader_module(vk::ShaderStageFlagBits            stage,
-	                              const vkb::core::HPPShaderSource  &glsl_source,
-	                              const std::string                 &entry_point,
-	                              const vkb::core::HPPShaderVariant &shader_variant)
-	{
-		return vkb::ResourceRecord::register_shader_module(static_cast<VkShaderStageFlagBits>(stage),
-		                                                   reinterpret_cast<vkb::ShaderSource const &>(glsl_source),
-		                                                   entry_point,
-		                                                   reinterpret_cast<vkb::ShaderVariant const &>(shader_variant));
-	}
-
-	void set_graphics_pipeline(size_t index, const vkb::core::HPPGraphicsPipeline &graphics_pipeline)
+	size_t register_shader_module(size_t hash)
 	{
-		vkb::ResourceRecord::set_graphics_pipeline(index, reinterpret_cast<vkb::GraphicsPipeline const &>(graphics_pipeline));
+		return vkb::ResourceRecord::register_shader_module(hash);
 	}
 
 	void set_pipeline_layout(size_t index, const vkb::core::HPPPipelineLayout &pipeline_layout)
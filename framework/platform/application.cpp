@@ -59,6 +59,11 @@ Drawer *Application::get_drawer()
 	return nullptr;
 }
 
+FrameCapture *Application::get_frame_capture()
+{
+	return nullptr;
+}
+
 void Application::update(float delta_time)
 {
 	fps        = 1.0f / delta_time;
@@ -69,6 +74,11 @@ void Application::update_overlay(float delta_time, const std::function<void()> &
 {
 }
 
+float Application::get_gpu_frame_time() const
+{
+	return gpu_frame_time;
+}
+
 const std::string &Application::get_name() const
 {
 	return name;
@@ -27,6 +27,7 @@
 
 namespace vkb
 {
+class FrameCapture;
 class Window;
 
 struct ApplicationOptions
@@ -84,12 +85,24 @@ class Application
 	 */
 	virtual Drawer *get_drawer();
 
+	/**
+	 * @brief Returns the object capturing the frames of the sample without stalling
+	 * @return The frame capture, or nullptr if the sample doesn't record the copies of its frames
+	 */
+	virtual FrameCapture *get_frame_capture();
+
 	const std::string &get_name() const;
 
 	void set_name(const std::string &name);
 
 	DebugInfo &get_debug_info();
 
+	/**
+	 * @brief Returns the GPU time of the last frame the stats were sampled for
+	 * @return The time in milliseconds, or 0 if the sample doesn't measure it
+	 */
+	float get_gpu_frame_time() const;
+
 	inline bool should_close() const
 	{
 		return requested_close;
@@ -136,6 +149,8 @@ class Application
 
 	float frame_time{0.0f};        // In ms
 
+	float gpu_frame_time{0.0f};        // In ms, 0 if not measured
+
 	uint32_t frame_count{0};
 
 	uint32_t last_frame_count{0};
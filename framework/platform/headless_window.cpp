@@ -33,7 +33,7 @@ VkSurfaceKHR HeadlessWindow::create_surface(VkInstance instance, VkPhysicalDevic
 {
 	VkSurfaceKHR surface = VK_NULL_HANDLE;
 
-	if (instance)
+	if (instance && properties.mode != Mode::Offscreen)
 	{
 		VkHeadlessSurfaceCreateInfoEXT info{};
 		info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
@@ -62,6 +62,10 @@ float HeadlessWindow::get_dpi_factor() const
 
 std::vector<const char *> HeadlessWindow::get_required_surface_extensions() const
 {
+	if (properties.mode == Mode::Offscreen)
+	{
+		return {};
+	}
 	return {VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
 }
 }        // namespace vkb
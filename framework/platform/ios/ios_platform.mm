@@ -77,7 +77,7 @@ const char *IosPlatform::get_surface_extension()
 
 void IosPlatform::create_window(const Window::Properties &properties)
 {
-	if (properties.mode == vkb::Window::Mode::Headless)
+	if (properties.mode == vkb::Window::Mode::Headless || properties.mode == vkb::Window::Mode::Offscreen)
 	{
 		window = std::make_unique<HeadlessWindow>(properties);
 	}
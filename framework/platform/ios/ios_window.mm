@@ -36,7 +36,7 @@ VkSurfaceKHR IosWindow::create_surface(Instance &instance)
 
 VkSurfaceKHR IosWindow::create_surface(VkInstance instance, VkPhysicalDevice)
 {
-	if (instance == VK_NULL_HANDLE || properties.mode == Mode::Headless)
+	if (instance == VK_NULL_HANDLE || properties.mode == Mode::Headless || properties.mode == Mode::Offscreen)
 	{
 		return VK_NULL_HANDLE;
 	}
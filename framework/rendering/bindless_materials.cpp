@@ -0,0 +1,234 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/bindless_materials.h"
+
+#include "core/descriptor_set_layout.h"
+#include "core/device.h"
+#include "core/physical_device.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/sampler.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+void BindlessMaterials::request_gpu_features(PhysicalDevice &gpu)
+{
+	auto descriptor_indexing_features =
+	    gpu.get_extension_features<VkPhysicalDeviceDescriptorIndexingFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT);
+
+	// Both are needed, the texture array is indexed with the material index of the draw and written after it is bound
+	if (gpu.get_features().shaderSampledImageArrayDynamicIndexing && descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind)
+	{
+		gpu.get_mutable_requested_features().shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
+		gpu.add_extension_features<VkPhysicalDeviceDescriptorIndexingFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT)
+		    .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	}
+}
+
+bool BindlessMaterials::is_supported(Device &device)
+{
+	return device.is_enabled(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) &&
+	       device.get_gpu().get_requested_features().shaderSampledImageArrayDynamicIndexing;
+}
+
+BindlessMaterials::BindlessMaterials(Device &device, sg::Scene &scene, const DescriptorSetLayout &descriptor_set_layout) :
+    device{device},
+    descriptor_pool{device, descriptor_set_layout, 1}
+{
+	auto textures_layout_binding  = descriptor_set_layout.get_layout_binding(textures_name);
+	auto materials_layout_binding = descriptor_set_layout.get_layout_binding(materials_name);
+
+	if (!textures_layout_binding || !materials_layout_binding)
+	{
+		throw std::runtime_error("Cannot create BindlessMaterials, the shaders don't declare the texture array and the material buffer");
+	}
+
+	textures_binding  = textures_layout_binding->binding;
+	max_texture_count = textures_layout_binding->descriptorCount;
+
+	auto textures = scene.get_components<sg::Texture>();
+
+	if (textures.empty())
+	{
+		throw std::runtime_error("Cannot create BindlessMaterials, the scene has no textures to fill the texture array with");
+	}
+
+	descriptor_set = descriptor_pool.allocate();
+
+	for (auto *texture : textures)
+	{
+		register_texture(*texture);
+	}
+
+	// The array isn't partially bound, so the free elements hold the first texture until textures are registered to them
+	for (uint32_t array_element = to_u32(texture_indices.size()); array_element < max_texture_count; ++array_element)
+	{
+		write_texture(*textures[0], array_element);
+	}
+
+	// Pack the parameters of the materials, the first one is also used for the materials which are not in the scene
+	std::vector<MaterialData> materials;
+
+	// The materials are collected from the submeshes, which also refer to materials the scene doesn't own, like the default one
+	for (auto *sub_mesh : scene.get_components<sg::SubMesh>())
+	{
+		auto *material = sub_mesh->get_material();
+
+		if (material == nullptr || material_indices.count(material) > 0)
+		{
+			continue;
+		}
+
+		MaterialData material_data{};
+		material_data.base_color_factor = glm::vec4(1.0f);
+		material_data.emissive_factor   = glm::vec4(material->emissive, material->alpha_cutoff);
+		material_data.metallic_factor   = 1.0f;
+		material_data.roughness_factor  = 1.0f;
+
+		if (auto *pbr_material = dynamic_cast<const sg::PBRMaterial *>(material))
+		{
+			material_data.base_color_factor = pbr_material->base_color_factor;
+			material_data.metallic_factor   = pbr_material->metallic_factor;
+			material_data.roughness_factor  = pbr_material->roughness_factor;
+		}
+
+		material_data.base_color_texture         = get_texture_index(*material, "base_color_texture");
+		material_data.normal_texture             = get_texture_index(*material, "normal_texture");
+		material_data.metallic_roughness_texture = get_texture_index(*material, "metallic_roughness_texture");
+		material_data.occlusion_texture          = get_texture_index(*material, "occlusion_texture");
+		material_data.emissive_texture           = get_texture_index(*material, "emissive_texture");
+
+		material_indices.emplace(material, to_u32(materials.size()));
+		materials.push_back(material_data);
+	}
+
+	if (materials.empty())
+	{
+		MaterialData material_data{};
+		material_data.base_color_factor          = glm::vec4(1.0f);
+		material_data.base_color_texture         = no_texture;
+		material_data.normal_texture             = no_texture;
+		material_data.metallic_roughness_texture = no_texture;
+		material_data.occlusion_texture          = no_texture;
+		material_data.emissive_texture           = no_texture;
+
+		materials.push_back(material_data);
+	}
+
+	// The materials are written once, so they stay in host visible memory rather than going through a staging buffer
+	material_buffer = std::make_unique<core::BufferC>(device,
+	                                                  materials.size() * sizeof(MaterialData),
+	                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                  VMA_MEMORY_USAGE_CPU_TO_GPU);
+	material_buffer->update(materials);
+	material_buffer->flush();
+
+	VkDescriptorBufferInfo buffer_info{};
+	buffer_info.buffer = material_buffer->get_handle();
+	buffer_info.offset = 0;
+	buffer_info.range  = material_buffer->get_size();
+
+	VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+	write_descriptor_set.dstSet          = descriptor_set;
+	write_descriptor_set.dstBinding      = materials_layout_binding->binding;
+	write_descriptor_set.descriptorCount = 1;
+	write_descriptor_set.descriptorType  = materials_layout_binding->descriptorType;
+	write_descriptor_set.pBufferInfo     = &buffer_info;
+
+	vkUpdateDescriptorSets(device.get_handle(), 1, &write_descriptor_set, 0, nullptr);
+
+	LOGI("Bindless materials: {} textures, {} materials", texture_indices.size(), materials.size());
+}
+
+uint32_t BindlessMaterials::register_texture(sg::Texture &texture)
+{
+	auto texture_it = texture_indices.find(&texture);
+	if (texture_it != texture_indices.end())
+	{
+		return texture_it->second;
+	}
+
+	if (texture_indices.size() >= max_texture_count)
+	{
+		LOGW("Texture '{}' doesn't fit in the bindless texture array of {} textures", texture.get_name(), max_texture_count);
+		return no_texture;
+	}
+
+	uint32_t array_element = to_u32(texture_indices.size());
+
+	write_texture(texture, array_element);
+
+	texture_indices.emplace(&texture, array_element);
+
+	return array_element;
+}
+
+uint32_t BindlessMaterials::get_material_index(const sg::Material &material) const
+{
+	auto material_it = material_indices.find(&material);
+	return material_it != material_indices.end() ? material_it->second : 0;
+}
+
+VkDescriptorSet BindlessMaterials::get_descriptor_set() const
+{
+	return descriptor_set;
+}
+
+uint32_t BindlessMaterials::get_texture_count() const
+{
+	return to_u32(texture_indices.size());
+}
+
+uint32_t BindlessMaterials::get_material_count() const
+{
+	return to_u32(material_indices.size());
+}
+
+void BindlessMaterials::write_texture(sg::Texture &texture, uint32_t array_element)
+{
+	VkDescriptorImageInfo image_info{};
+	image_info.sampler     = texture.get_sampler()->vk_sampler.get_handle();
+	image_info.imageView   = texture.get_image()->get_vk_image_view().get_handle();
+	image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+	write_descriptor_set.dstSet          = descriptor_set;
+	write_descriptor_set.dstBinding      = textures_binding;
+	write_descriptor_set.dstArrayElement = array_element;
+	write_descriptor_set.descriptorCount = 1;
+	write_descriptor_set.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	write_descriptor_set.pImageInfo      = &image_info;
+
+	vkUpdateDescriptorSets(device.get_handle(), 1, &write_descriptor_set, 0, nullptr);
+}
+
+uint32_t BindlessMaterials::get_texture_index(const sg::Material &material, const std::string &name)
+{
+	auto texture_it = material.textures.find(name);
+	if (texture_it == material.textures.end() || texture_it->second == nullptr)
+	{
+		return no_texture;
+	}
+
+	return register_texture(*texture_it->second);
+}
+}        // namespace vkb
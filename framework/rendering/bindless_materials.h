@@ -0,0 +1,166 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/descriptor_pool.h"
+
+namespace vkb
+{
+class DescriptorSetLayout;
+class Device;
+class PhysicalDevice;
+
+namespace sg
+{
+class Material;
+class Scene;
+class Texture;
+}        // namespace sg
+
+/**
+ * @brief The textures and PBR material parameters of a scene, in a descriptor set bound once for all the draws
+ *
+ * Every texture of the scene is written once to an update-after-bind array of combined image samplers,
+ * and the parameters of every material are packed into a storage buffer, along with the array indices
+ * of their textures. Draws then only select their material with an index, so changing materials
+ * doesn't need a new descriptor set.
+ *
+ * Shaders declare the set as follows, with the array size matching the one of the shader:
+ *
+ *     layout(set = 1, binding = 0) uniform sampler2D textures[MAX_BINDLESS_TEXTURES];
+ *     layout(set = 1, binding = 1) readonly buffer MaterialData { Material materials[]; };
+ */
+class BindlessMaterials
+{
+  public:
+	/**
+	 * @brief The parameters of a material as read by the shaders
+	 */
+	struct alignas(16) MaterialData
+	{
+		glm::vec4 base_color_factor;
+
+		/// Emissive color in xyz, alpha cutoff in w
+		glm::vec4 emissive_factor;
+
+		float metallic_factor;
+
+		float roughness_factor;
+
+		/// Indices in the texture array, or no_texture if the material doesn't have the texture
+		uint32_t base_color_texture;
+
+		uint32_t normal_texture;
+
+		uint32_t metallic_roughness_texture;
+
+		uint32_t occlusion_texture;
+
+		uint32_t emissive_texture;
+
+		uint32_t padding;
+	};
+
+	static constexpr uint32_t no_texture = ~0u;
+
+	/// Set index of the textures and materials in the shaders
+	static constexpr uint32_t set_index = 1;
+
+	static constexpr const char *textures_name = "textures";
+
+	static constexpr const char *materials_name = "MaterialData";
+
+	/**
+	 * @brief Requests the features needed to index the texture array, if the GPU supports them
+	 *        Samples also need to enable VK_EXT_descriptor_indexing
+	 */
+	static void request_gpu_features(PhysicalDevice &gpu);
+
+	/**
+	 * @return Whether the device has the features needed to index the texture array enabled
+	 */
+	static bool is_supported(Device &device);
+
+	/**
+	 * @brief Registers the textures and the materials of a scene
+	 * @param device A valid device
+	 * @param scene The scene whose materials are drawn
+	 * @param descriptor_set_layout Layout of the bindless set, as built for the shaders which read it
+	 */
+	BindlessMaterials(Device &device, sg::Scene &scene, const DescriptorSetLayout &descriptor_set_layout);
+
+	BindlessMaterials(const BindlessMaterials &) = delete;
+
+	BindlessMaterials(BindlessMaterials &&) = delete;
+
+	BindlessMaterials &operator=(const BindlessMaterials &) = delete;
+
+	BindlessMaterials &operator=(BindlessMaterials &&) = delete;
+
+	/**
+	 * @brief Writes a texture to the next free element of the texture array
+	 *        The array is update-after-bind, so textures can be added while frames using the set are in flight.
+	 * @return The index of the texture in the array, or no_texture if the array is full
+	 */
+	uint32_t register_texture(sg::Texture &texture);
+
+	/**
+	 * @return The index of a material in the material buffer, 0 for materials which no submesh of the scene uses
+	 */
+	uint32_t get_material_index(const sg::Material &material) const;
+
+	VkDescriptorSet get_descriptor_set() const;
+
+	uint32_t get_texture_count() const;
+
+	uint32_t get_material_count() const;
+
+  private:
+	Device &device;
+
+	DescriptorPool descriptor_pool;
+
+	VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
+
+	uint32_t textures_binding{0};
+
+	/// Size of the texture array declared by the shaders
+	uint32_t max_texture_count{0};
+
+	std::unordered_map<const sg::Texture *, uint32_t> texture_indices;
+
+	std::unordered_map<const sg::Material *, uint32_t> material_indices;
+
+	std::unique_ptr<core::BufferC> material_buffer;
+
+	/**
+	 * @brief Writes a texture to an element of the texture array
+	 */
+	void write_texture(sg::Texture &texture, uint32_t array_element);
+
+	uint32_t get_texture_index(const sg::Material &material, const std::string &name);
+};
+}        // namespace vkb
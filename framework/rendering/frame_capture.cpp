@@ -0,0 +1,335 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_capture.h"
+
+#include <algorithm>
+
+#include "core/command_buffer.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include "filesystem/legacy.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+FrameCapture::FrameCapture(RenderContext &render_context, uint32_t max_readback_buffers) :
+    render_context{render_context},
+    max_readback_buffers{std::max(max_readback_buffers, 1u)},
+    worker{&FrameCapture::run_worker, this}
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+	flush();
+
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		stopping = true;
+	}
+	condition.notify_all();
+
+	worker.join();
+}
+
+void FrameCapture::request(const std::string &filename, Format format)
+{
+	requested_filename = filename;
+	requested_format   = format;
+}
+
+bool FrameCapture::is_request_pending() const
+{
+	return !requested_filename.empty() || (sequence_interval > 0 && sequence_frame == 0);
+}
+
+void FrameCapture::cancel_request()
+{
+	requested_filename.clear();
+
+	if (sequence_frame == 0)
+	{
+		sequence_interval = 0;
+	}
+}
+
+void FrameCapture::start_sequence(uint32_t interval, const std::string &prefix, Format format)
+{
+	sequence_interval = std::max(interval, 1u);
+	sequence_prefix   = prefix;
+	sequence_format   = format;
+	sequence_frame    = 0;
+}
+
+void FrameCapture::stop_sequence()
+{
+	sequence_interval = 0;
+}
+
+void FrameCapture::update()
+{
+	auto &frames = render_context.get_render_frames();
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	++update_count;
+
+	bool queued = false;
+	for (auto &slot : slots)
+	{
+		// A slot recorded since the last update belongs to a frame which hasn't been submitted yet
+		// Frames recreated with the swapchain were waited on before being destroyed
+		if (slot->state == SlotState::Recorded && slot->recorded_update < update_count &&
+		    (slot->frame_index >= frames.size() || frames[slot->frame_index]->is_complete()))
+		{
+			slot->state = SlotState::Encoding;
+			jobs.push(slot.get());
+			queued = true;
+		}
+	}
+
+	if (queued)
+	{
+		condition.notify_all();
+	}
+}
+
+void FrameCapture::record(CommandBuffer &command_buffer)
+{
+	std::string filename;
+	Format      format;
+
+	if (!requested_filename.empty())
+	{
+		filename = requested_filename;
+		format   = requested_format;
+		requested_filename.clear();
+	}
+	else if (sequence_interval > 0)
+	{
+		uint32_t frame = sequence_frame++;
+		if (frame % sequence_interval != 0)
+		{
+			return;
+		}
+
+		filename = fmt::format("{}-{:06}", sequence_prefix, frame);
+		format   = sequence_format;
+	}
+	else
+	{
+		return;
+	}
+
+	auto &frame = render_context.get_active_frame();
+	assert(!frame.get_render_target().get_views().empty());
+	auto &src_image_view = frame.get_render_target().get_views()[0];
+
+	assert(src_image_view.get_format() == VK_FORMAT_R8G8B8A8_UNORM ||
+	       src_image_view.get_format() == VK_FORMAT_B8G8R8A8_UNORM ||
+	       src_image_view.get_format() == VK_FORMAT_R8G8B8A8_SRGB ||
+	       src_image_view.get_format() == VK_FORMAT_B8G8R8A8_SRGB);
+
+	auto width    = frame.get_render_target().get_extent().width;
+	auto height   = frame.get_render_target().get_extent().height;
+	auto dst_size = static_cast<VkDeviceSize>(width) * height * 4;
+
+	ReadbackSlot *slot = acquire_slot(dst_size);
+	if (!slot)
+	{
+		LOGW("Dropped the capture of {}, all the readback buffers are in use", filename);
+		return;
+	}
+
+	// Check if framebuffer images are in a BGR format
+	auto bgr_formats = {VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_B8G8R8A8_SNORM};
+
+	slot->frame_index     = render_context.get_active_frame_index();
+	slot->recorded_update = update_count;
+	slot->width           = width;
+	slot->height          = height;
+	slot->swizzle         = std::find(bgr_formats.begin(), bgr_formats.end(), src_image_view.get_format()) != bgr_formats.end();
+	slot->filename        = filename;
+	slot->format          = format;
+
+	// Wait for the frame to be drawn before reading the framebuffer image
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		command_buffer.image_memory_barrier(src_image_view, memory_barrier);
+	}
+
+	// Copy framebuffer image memory
+	VkBufferImageCopy image_copy_region{};
+	image_copy_region.bufferRowLength             = width;
+	image_copy_region.bufferImageHeight           = height;
+	image_copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	image_copy_region.imageSubresource.layerCount = 1;
+	image_copy_region.imageExtent.width           = width;
+	image_copy_region.imageExtent.height          = height;
+	image_copy_region.imageExtent.depth           = 1;
+
+	command_buffer.copy_image_to_buffer(src_image_view.get_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *slot->buffer, {image_copy_region});
+
+	// Make the copy visible to the host once the frame completes
+	{
+		BufferMemoryBarrier memory_barrier{};
+		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_HOST_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+
+		command_buffer.buffer_memory_barrier(*slot->buffer, 0, dst_size, memory_barrier);
+	}
+
+	// Revert back the framebuffer image view from transfer to present
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_READ_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		command_buffer.image_memory_barrier(src_image_view, memory_barrier);
+	}
+}
+
+void FrameCapture::flush()
+{
+	render_context.get_device().wait_idle();
+
+	std::unique_lock<std::mutex> lock{mutex};
+
+	// Every recorded copy was submitted with its frame, and the device is idle
+	for (auto &slot : slots)
+	{
+		if (slot->state == SlotState::Recorded)
+		{
+			slot->state = SlotState::Encoding;
+			jobs.push(slot.get());
+		}
+	}
+	condition.notify_all();
+
+	condition.wait(lock, [this] {
+		return std::all_of(slots.begin(), slots.end(), [](auto &slot) { return slot->state == SlotState::Free; });
+	});
+}
+
+FrameCapture::ReadbackSlot *FrameCapture::acquire_slot(VkDeviceSize size)
+{
+	std::lock_guard<std::mutex> lock{mutex};
+
+	auto it = std::find_if(slots.begin(), slots.end(), [](auto &slot) { return slot->state == SlotState::Free; });
+	if (it == slots.end())
+	{
+		if (slots.size() == max_readback_buffers)
+		{
+			return nullptr;
+		}
+
+		slots.push_back(std::make_unique<ReadbackSlot>());
+		it = std::prev(slots.end());
+	}
+
+	auto &slot = **it;
+
+	// Buffers are created on first use and again when the size of the render target changes
+	if (!slot.buffer || slot.buffer->get_size() != size)
+	{
+		slot.buffer = std::make_unique<core::BufferC>(render_context.get_device(),
+		                                              size,
+		                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                              VMA_MEMORY_USAGE_GPU_TO_CPU,
+		                                              VMA_ALLOCATION_CREATE_MAPPED_BIT);
+	}
+
+	slot.state = SlotState::Recorded;
+
+	return &slot;
+}
+
+void FrameCapture::run_worker()
+{
+	while (true)
+	{
+		ReadbackSlot *slot{nullptr};
+
+		{
+			std::unique_lock<std::mutex> lock{mutex};
+			condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+			if (jobs.empty())
+			{
+				return;
+			}
+
+			slot = jobs.front();
+			jobs.pop();
+		}
+
+		encode(*slot);
+
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			slot->state = SlotState::Free;
+		}
+		condition.notify_all();
+	}
+}
+
+void FrameCapture::encode(ReadbackSlot &slot)
+{
+	uint8_t *raw_data = slot.buffer->map();
+
+	// Replace the A component with 255 (remove transparency)
+	// If the format is BGR, swap the R and B components
+	uint8_t *data = raw_data;
+	for (size_t i = 0; i < static_cast<size_t>(slot.width) * slot.height; ++i)
+	{
+		if (slot.swizzle)
+		{
+			std::swap(data[0], data[2]);
+		}
+		data[3] = 255;
+
+		// Get next pixel
+		data += 4;
+	}
+
+	if (slot.format == Format::Png)
+	{
+		vkb::fs::write_image(raw_data, slot.filename, slot.width, slot.height, 4, slot.width * 4);
+	}
+	else
+	{
+		auto filename = fmt::format("{}-{}x{}.rgba", slot.filename, slot.width, slot.height);
+		vkb::filesystem::get()->write_file(vkb::fs::path::get(vkb::fs::path::Type::Screenshots, filename),
+		                                   std::vector<uint8_t>(raw_data, raw_data + static_cast<size_t>(slot.width) * slot.height * 4));
+	}
+
+	slot.buffer->unmap();
+}
+}        // namespace vkb
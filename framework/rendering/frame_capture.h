@@ -0,0 +1,192 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/buffer.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class RenderContext;
+
+/**
+ * @brief Captures the images rendered by a RenderContext without stalling the render thread
+ *
+ * The copy of the render target is recorded into the command buffer of the captured frame, towards one of a ring
+ * of readback buffers. Once the GPU completed the frame, a worker thread swizzles the pixels and writes the image
+ * to the screenshots directory, after which the readback buffer is reused.
+ * A capture which finds no free readback buffer is dropped rather than waiting for one.
+ */
+class FrameCapture
+{
+  public:
+	enum class Format
+	{
+		/// A PNG image
+		Png,
+
+		/// Tightly packed RGBA8 pixels, the size of the image is appended to the file name
+		Raw
+	};
+
+	/**
+	 * @param render_context The render context whose frames are captured
+	 * @param max_readback_buffers Maximum number of captures in progress at once
+	 */
+	FrameCapture(RenderContext &render_context, uint32_t max_readback_buffers = 8);
+
+	FrameCapture(const FrameCapture &) = delete;
+
+	FrameCapture(FrameCapture &&) = delete;
+
+	/**
+	 * @brief Completes the captures in progress
+	 */
+	~FrameCapture();
+
+	FrameCapture &operator=(const FrameCapture &) = delete;
+
+	FrameCapture &operator=(FrameCapture &&) = delete;
+
+	/**
+	 * @brief Captures the next frame recorded
+	 * @param filename The name of the image file without an extension
+	 * @param format The format of the image file
+	 */
+	void request(const std::string &filename, Format format = Format::Png);
+
+	/**
+	 * @return Whether a capture or a sequence was requested and no frame was recorded for it yet
+	 */
+	bool is_request_pending() const;
+
+	/**
+	 * @brief Cancels a capture or a sequence which was requested but not recorded
+	 */
+	void cancel_request();
+
+	/**
+	 * @brief Captures one frame out of every interval frames recorded, until stop_sequence is called
+	 * @param interval Number of frames between two captures, 1 captures every frame
+	 * @param prefix Prefix of the file names, which is followed by the index of the frame in the sequence
+	 * @param format The format of the image files
+	 */
+	void start_sequence(uint32_t interval, const std::string &prefix, Format format = Format::Png);
+
+	void stop_sequence();
+
+	/**
+	 * @brief Hands the captures of the frames the GPU completed to the worker thread, without waiting
+	 *        Should be called once per frame, after the render context began it.
+	 */
+	void update();
+
+	/**
+	 * @brief Records the copy of the render target of the active frame, if the frame is captured
+	 *        Must be called outside of a render pass, once the frame was drawn and its first attachment
+	 *        is in the present layout.
+	 * @param command_buffer The command buffer of the active frame
+	 */
+	void record(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Waits for the GPU and the worker thread to complete the captures in progress
+	 */
+	void flush();
+
+  private:
+	enum class SlotState
+	{
+		Free,
+		Recorded,
+		Encoding
+	};
+
+	struct ReadbackSlot
+	{
+		std::unique_ptr<core::BufferC> buffer;
+
+		SlotState state{SlotState::Free};
+
+		/// Index of the frame of the render context which copies the image into the buffer
+		uint32_t frame_index{0};
+
+		/// Value of the update count when the copy was recorded
+		uint64_t recorded_update{0};
+
+		uint32_t width{0};
+
+		uint32_t height{0};
+
+		/// Whether the image has a BGR format
+		bool swizzle{false};
+
+		std::string filename;
+
+		Format format{Format::Png};
+	};
+
+	/**
+	 * @brief Finds a free readback buffer, or creates one if the ring isn't full
+	 * @return The slot of the buffer, or nullptr if all the buffers are in use
+	 */
+	ReadbackSlot *acquire_slot(VkDeviceSize size);
+
+	void run_worker();
+
+	static void encode(ReadbackSlot &slot);
+
+	RenderContext &render_context;
+
+	uint32_t max_readback_buffers;
+
+	/// Name and format of the capture requested for the next frame
+	std::string requested_filename;
+	Format      requested_format{Format::Png};
+
+	/// Number of frames between the captures of the sequence, 0 if no sequence is captured
+	uint32_t    sequence_interval{0};
+	std::string sequence_prefix;
+	Format      sequence_format{Format::Png};
+	uint32_t    sequence_frame{0};
+
+	/// Number of times update was called, which tells the copies recorded in the current frame apart
+	uint64_t update_count{0};
+
+	std::vector<std::unique_ptr<ReadbackSlot>> slots;
+
+	/// Guards the slot states and the jobs of the worker thread
+	std::mutex mutex;
+
+	std::condition_variable condition;
+
+	std::queue<ReadbackSlot *> jobs;
+
+	bool stopping{false};
+
+	std::thread worker;
+};
+}        // namespace vkb
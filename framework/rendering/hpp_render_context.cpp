@@ -48,43 +48,79 @@ HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &devi
 			swapchain = std::make_unique<vkb::core::HPPSwapchain>(device, surface, present_mode, present_mode_priority_list, surface_format_priority_list);
 		}
 	}
+
+	timeline_semaphore_enabled = device.is_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+}
+
+HPPRenderContext::~HPPRenderContext()
+{
+	for (auto &queue_timeline : queue_timelines)
+	{
+		device.get_handle().destroySemaphore(queue_timeline.second.semaphore);
+	}
 }
 
 void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTarget::CreateFunc create_render_target_func)
 {
 	device.get_handle().waitIdle();
 
+	this->create_render_target_func = create_render_target_func;
+	this->thread_count              = thread_count;
+
 	if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
 
-		vk::Extent3D extent{surface_extent.width, surface_extent.height, 1};
+		update_render_targets();
+	}
+	else
+	{
+		// Otherwise, create a ring of RenderTargets, so that frames in flight don't wait for each other's image
+		swapchain = nullptr;
 
-		for (auto &image_handle : swapchain->get_images())
+		render_targets.clear();
+		for (uint32_t i = 0; i < offscreen_image_count; ++i)
 		{
-			auto swapchain_image = core::HPPImage{device, image_handle, extent, swapchain->get_format(), swapchain->get_usage()};
-			auto render_target   = create_render_target_func(std::move(swapchain_image));
-			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+			auto color_image = vkb::core::HPPImage{device,
+			                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
+			                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			                                       VMA_MEMORY_USAGE_GPU_ONLY};
+
+			render_targets.push_back(create_render_target_func(std::move(color_image)));
 		}
+		image_frame_indices.assign(render_targets.size(), no_frame);
 	}
-	else
+
+	create_frames();
+
+	// The first frame to begin is the first one of the ring
+	active_frame_index = to_u32(frames.size()) - 1;
+
+	this->prepared = true;
+}
+
+void HPPRenderContext::set_frames_in_flight(uint32_t count)
+{
+	frames_in_flight = count;
+
+	if (prepared)
 	{
-		// Otherwise, create a single RenderFrame
-		swapchain = nullptr;
+		assert(!frame_active && "Frame is still active, please call end_frame");
 
-		auto color_image = vkb::core::HPPImage{device,
-		                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
-		                                       DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
-		                                       VMA_MEMORY_USAGE_GPU_ONLY};
+		device.get_handle().waitIdle();
+
+		frames.clear();
+		create_frames();
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+		image_frame_indices.assign(render_targets.size(), no_frame);
+		active_frame_index = to_u32(frames.size()) - 1;
 	}
+}
 
-	this->create_render_target_func = create_render_target_func;
-	this->thread_count              = thread_count;
-	this->prepared                  = true;
+uint32_t HPPRenderContext::get_frames_in_flight() const
+{
+	return to_u32(frames.size());
 }
 
 vk::Format HPPRenderContext::get_format() const
@@ -169,29 +205,10 @@ void HPPRenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
-	vk::Extent2D swapchain_extent = swapchain->get_extent();
-	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
-
-	for (auto &image_handle : swapchain->get_images())
-	{
-		vkb::core::HPPImage swapchain_image{device, image_handle, extent, swapchain->get_format(), swapchain->get_usage()};
-
-		auto render_target = create_render_target_func(std::move(swapchain_image));
+	update_render_targets();
 
-		if (frame_it != frames.end())
-		{
-			(*frame_it)->update_render_target(std::move(render_target));
-		}
-		else
-		{
-			// Create a new frame if the new swapchain has more images than current frames
-			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
-		}
-
-		++frame_it;
-	}
+	// Create new frames if the new swapchain has more images than current frames
+	create_frames();
 
 	device.get_resource_cache().clear_framebuffers();
 }
@@ -283,18 +300,28 @@ void HPPRenderContext::begin_frame()
 
 	assert(!frame_active && "Frame is still active, please call end_frame");
 
-	auto &prev_frame = *frames[active_frame_index];
+	// Frames are used in turn, whichever swapchain image they render to
+	active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+
+	// Now the frame is active again
+	frame_active = true;
+
+	// Wait on all resource to be freed from the previous render to this frame
+	wait_frame();
 
-	// We will use the acquired semaphore in a different frame context,
-	// so we need to hold ownership.
-	acquired_semaphore = prev_frame.request_semaphore_with_ownership();
+	auto &frame = get_active_frame();
+
+	// The acquired semaphore may be consumed by the sample, so the frame only gets it back in end_frame
+	acquired_semaphore = frame.request_semaphore_with_ownership();
+
+	active_image_index = 0;
 
 	if (swapchain)
 	{
 		vk::Result result;
 		try
 		{
-			std::tie(result, active_frame_index) = swapchain->acquire_next_image(acquired_semaphore);
+			std::tie(result, active_image_index) = swapchain->acquire_next_image(acquired_semaphore);
 		}
 		catch (vk::OutOfDateKHRError & /*err*/)
 		{
@@ -315,23 +342,34 @@ void HPPRenderContext::begin_frame()
 			{
 				// Need to destroy and reallocate acquired_semaphore since it may have already been signaled
 				device.get_handle().destroySemaphore(acquired_semaphore);
-				acquired_semaphore                   = prev_frame.request_semaphore_with_ownership();
-				std::tie(result, active_frame_index) = swapchain->acquire_next_image(acquired_semaphore);
+				acquired_semaphore                   = frame.request_semaphore_with_ownership();
+				std::tie(result, active_image_index) = swapchain->acquire_next_image(acquired_semaphore);
 			}
 		}
 
 		if (result != vk::Result::eSuccess)
 		{
-			prev_frame.reset();
+			// No image was acquired, so the semaphore wasn't signaled and can be reused
+			frame.release_owned_semaphore(std::exchange(acquired_semaphore, nullptr));
+			frame_active = false;
 			return;
 		}
 	}
+	else
+	{
+		// Without a presentation engine, the frames render to the images in turn
+		active_image_index = active_frame_index % to_u32(render_targets.size());
+	}
 
-	// Now the frame is active again
-	frame_active = true;
+	// The attachments of the image other than the swapchain image may still be used by the frame which rendered to it last
+	uint32_t &image_frame_index = image_frame_indices[active_image_index];
+	if (image_frame_index != active_frame_index && image_frame_index < frames.size())
+	{
+		frames[image_frame_index]->wait();
+	}
+	image_frame_index = active_frame_index;
 
-	// Wait on all resource to be freed from the previous render to this frame
-	wait_frame();
+	frame.set_render_target(*render_targets[active_image_index]);
 }
 
 vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue                        &queue,
@@ -342,34 +380,111 @@ vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue
 	std::vector<vk::CommandBuffer> cmd_buf_handles(command_buffers.size(), nullptr);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const vkb::core::HPPCommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	vkb::rendering::HPPRenderFrame &frame = get_active_frame();
+	// The binary semaphore is still needed by the presentation engine, which can't wait on timeline semaphores
+	vk::Semaphore signal_semaphore = get_active_frame().request_semaphore();
 
-	vk::Semaphore signal_semaphore = frame.request_semaphore();
+	submit_to_queue(queue, command_buffers, wait_semaphore, wait_pipeline_stage, signal_semaphore);
 
-	vk::SubmitInfo submit_info(nullptr, nullptr, cmd_buf_handles, signal_semaphore);
-	if (wait_semaphore)
+	return signal_semaphore;
+}
+
+void HPPRenderContext::submit(const vkb::core::HPPQueue &queue, const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers)
+{
+	submit_to_queue(queue, command_buffers, nullptr, {}, nullptr);
+}
+
+void HPPRenderContext::wait_for_queue(const vkb::core::HPPQueue &queue, vk::PipelineStageFlags wait_stage)
+{
+	assert(timeline_semaphore_enabled && "Waiting for a queue requires timeline semaphores");
+
+	QueueTimeline &timeline = get_queue_timeline(queue);
+	if (timeline.value > 0)
 	{
-		submit_info.setWaitSemaphores(wait_semaphore);
-		submit_info.pWaitDstStageMask = &wait_pipeline_stage;
+		timeline_waits.push_back({timeline.semaphore, timeline.value, wait_stage});
 	}
+}
 
-	vk::Fence fence = frame.request_fence();
+bool HPPRenderContext::is_timeline_semaphore_enabled() const
+{
+	return timeline_semaphore_enabled;
+}
 
-	queue.get_handle().submit(submit_info, fence);
+HPPRenderContext::QueueTimeline &HPPRenderContext::get_queue_timeline(const vkb::core::HPPQueue &queue)
+{
+	auto it = queue_timelines.find(queue.get_handle());
+	if (it == queue_timelines.end())
+	{
+		vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfoKHR> create_info_chain{{}, {vk::SemaphoreType::eTimeline, 0}};
 
-	return signal_semaphore;
+		QueueTimeline timeline{device.get_handle().createSemaphore(create_info_chain.get<vk::SemaphoreCreateInfo>())};
+
+		it = queue_timelines.emplace(queue.get_handle(), timeline).first;
+	}
+
+	return it->second;
 }
 
-void HPPRenderContext::submit(const vkb::core::HPPQueue &queue, const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers)
+void HPPRenderContext::submit_to_queue(const vkb::core::HPPQueue                        &queue,
+                                       const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers,
+                                       vk::Semaphore                                     wait_semaphore,
+                                       vk::PipelineStageFlags                            wait_pipeline_stage,
+                                       vk::Semaphore                                     signal_semaphore)
 {
 	std::vector<vk::CommandBuffer> cmd_buf_handles(command_buffers.size(), nullptr);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const vkb::core::HPPCommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
 	vkb::rendering::HPPRenderFrame &frame = get_active_frame();
 
-	vk::SubmitInfo submit_info(nullptr, nullptr, cmd_buf_handles);
+	// Values of binary semaphores are ignored, but the value arrays must match the semaphore arrays
+	std::vector<vk::Semaphore>          wait_semaphores;
+	std::vector<vk::PipelineStageFlags> wait_stages;
+	std::vector<uint64_t>               wait_values;
+	if (wait_semaphore)
+	{
+		wait_semaphores.push_back(wait_semaphore);
+		wait_stages.push_back(wait_pipeline_stage);
+		wait_values.push_back(0);
+	}
+	for (auto &timeline_wait : timeline_waits)
+	{
+		wait_semaphores.push_back(timeline_wait.semaphore);
+		wait_stages.push_back(timeline_wait.stage);
+		wait_values.push_back(timeline_wait.value);
+	}
+	timeline_waits.clear();
+
+	std::vector<vk::Semaphore> signal_semaphores;
+	std::vector<uint64_t>      signal_values;
+	if (signal_semaphore)
+	{
+		signal_semaphores.push_back(signal_semaphore);
+		signal_values.push_back(0);
+	}
+
+	vk::TimelineSemaphoreSubmitInfoKHR timeline_submit_info;
+	vk::Fence                          fence;
+
+	if (timeline_semaphore_enabled)
+	{
+		// The frame is retired once the timeline semaphore of the queue reaches the value of this submission
+		QueueTimeline &timeline = get_queue_timeline(queue);
+		signal_semaphores.push_back(timeline.semaphore);
+		signal_values.push_back(++timeline.value);
+		frame.add_timeline_signal(timeline.semaphore, timeline.value);
+
+		timeline_submit_info.setWaitSemaphoreValues(wait_values);
+		timeline_submit_info.setSignalSemaphoreValues(signal_values);
+	}
+	else
+	{
+		fence = frame.request_fence();
+	}
 
-	vk::Fence fence = frame.request_fence();
+	vk::SubmitInfo submit_info(wait_semaphores, wait_stages, cmd_buf_handles, signal_semaphores);
+	if (timeline_semaphore_enabled)
+	{
+		submit_info.pNext = &timeline_submit_info;
+	}
 
 	queue.get_handle().submit(submit_info, fence);
 }
@@ -386,7 +501,7 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 	if (swapchain)
 	{
 		vk::SwapchainKHR   vk_swapchain = swapchain->get_handle();
-		vk::PresentInfoKHR present_info(semaphore, vk_swapchain, active_frame_index);
+		vk::PresentInfoKHR present_info(semaphore, vk_swapchain, active_image_index);
 
 		vk::DisplayPresentInfoKHR disp_present_info;
 		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
@@ -411,6 +526,14 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 			handle_surface_changes();
 		}
 	}
+	else if (semaphore)
+	{
+		// Stands in for the present, which would have waited for the semaphore, so that it can be signaled again
+		vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eBottomOfPipe;
+		vk::SubmitInfo         submit_info(semaphore, wait_stage);
+
+		queue.get_handle().submit(submit_info);
+	}
 
 	// Frame is not active anymore
 	if (acquired_semaphore)
@@ -424,6 +547,15 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 vk::Semaphore HPPRenderContext::consume_acquired_semaphore()
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
+
+	if (!swapchain && acquired_semaphore)
+	{
+		// Stands in for the acquire, which would have signaled the semaphore
+		vk::SubmitInfo submit_info({}, {}, {}, acquired_semaphore);
+
+		queue.get_handle().submit(submit_info);
+	}
+
 	return std::exchange(acquired_semaphore, nullptr);
 }
 
@@ -439,6 +571,12 @@ uint32_t HPPRenderContext::get_active_frame_index()
 	return active_frame_index;
 }
 
+uint32_t HPPRenderContext::get_active_image_index() const
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+	return active_image_index;
+}
+
 vkb::rendering::HPPRenderFrame &HPPRenderContext::get_last_rendered_frame()
 {
 	assert(!frame_active && "Frame is still active, please call end_frame");
@@ -470,19 +608,8 @@ void HPPRenderContext::recreate_swapchain()
 	device.get_handle().waitIdle();
 	device.get_resource_cache().clear_framebuffers();
 
-	vk::Extent2D swapchain_extent = swapchain->get_extent();
-	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
-
-	for (auto &image_handle : swapchain->get_images())
-	{
-		vkb::core::HPPImage swapchain_image{device, image_handle, extent, swapchain->get_format(), swapchain->get_usage()};
-		auto                render_target = create_render_target_func(std::move(swapchain_image));
-		(*frame_it)->update_render_target(std::move(render_target));
-
-		++frame_it;
-	}
+	update_render_targets();
+	create_frames();
 }
 
 bool HPPRenderContext::has_swapchain()
@@ -511,5 +638,38 @@ std::vector<std::unique_ptr<vkb::rendering::HPPRenderFrame>> &HPPRenderContext::
 	return frames;
 }
 
+void HPPRenderContext::update_render_targets()
+{
+	vk::Extent2D swapchain_extent = swapchain->get_extent();
+	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
+
+	render_targets.clear();
+
+	for (auto &image_handle : swapchain->get_images())
+	{
+		vkb::core::HPPImage swapchain_image{device, image_handle, extent, swapchain->get_format(), swapchain->get_usage()};
+		render_targets.push_back(create_render_target_func(std::move(swapchain_image)));
+	}
+
+	image_frame_indices.assign(render_targets.size(), no_frame);
+}
+
+void HPPRenderContext::create_frames()
+{
+	// Without a frame count, there is a frame per image, as samples may keep per-image resources sized by the frame count
+	size_t frame_count = frames_in_flight > 0 ? frames_in_flight : render_targets.size();
+
+	while (frames.size() < frame_count)
+	{
+		frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, nullptr, thread_count));
+	}
+
+	// Until they acquire an image, frames render to the image of the same index, as expected by samples which don't call begin_frame
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		frames[i]->set_render_target(*render_targets[i % render_targets.size()]);
+	}
+}
+
 }        // namespace rendering
 }        // namespace vkb
@@ -59,7 +59,7 @@ class HPPRenderContext
 
 	HPPRenderContext(HPPRenderContext &&) = delete;
 
-	virtual ~HPPRenderContext() = default;
+	virtual ~HPPRenderContext();
 
 	HPPRenderContext &operator=(const HPPRenderContext &) = delete;
 
@@ -72,6 +72,14 @@ class HPPRenderContext
 	 */
 	void prepare(size_t thread_count = 1, HPPRenderTarget::CreateFunc create_render_target_func = HPPRenderTarget::DEFAULT_CREATE_FUNC);
 
+	/**
+	 * @brief Sets how many frames can be recorded before waiting for the GPU to complete the oldest one
+	 * @param count The number of frames in flight, 0 for one frame per swapchain image
+	 */
+	void set_frames_in_flight(uint32_t count);
+
+	uint32_t get_frames_in_flight() const;
+
 	/**
 	 * @brief Updates the swapchains extent, if a swapchain exists
 	 * @param extent The width and height of the new swapchain images
@@ -147,6 +155,20 @@ class HPPRenderContext
 	 */
 	void submit(const vkb::core::HPPQueue &queue, const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers);
 
+	/**
+	 * @brief Makes the next submission wait for the work submitted to a queue so far
+	 *        Uses the timeline semaphore of the queue, so that work of async compute or transfer queues
+	 *        can be consumed without binary semaphores. Only available if timeline semaphores are enabled.
+	 * @param queue A queue work was submitted to through the HPPRenderContext
+	 * @param wait_stage The pipeline stages of the next submission which wait for the work
+	 */
+	void wait_for_queue(const vkb::core::HPPQueue &queue, vk::PipelineStageFlags wait_stage);
+
+	/**
+	 * @return Whether the frames track the progress of the queues with timeline semaphores rather than with fences
+	 */
+	bool is_timeline_semaphore_enabled() const;
+
 	/**
 	 * @brief Waits a frame to finish its rendering
 	 */
@@ -168,6 +190,13 @@ class HPPRenderContext
 	 */
 	uint32_t get_active_frame_index();
 
+	/**
+	 * @brief An error should be raised if the frame is not active.
+	 *        A frame is active after @ref begin_frame has been called.
+	 * @return The index of the swapchain image the active frame renders to
+	 */
+	uint32_t get_active_image_index() const;
+
 	/**
 	 * @brief An error should be raised if a frame is active.
 	 *        A frame is active after @ref begin_frame has been called.
@@ -201,6 +230,7 @@ class HPPRenderContext
 
 	/**
 	 * @brief Returns the WSI acquire semaphore. Only to be used in very special circumstances.
+	 *        Without a swapchain, the semaphore is signaled by an empty submission so that waiting for it doesn't block.
 	 * @return The WSI acquire semaphore.
 	 */
 	vk::Semaphore consume_acquired_semaphore();
@@ -209,6 +239,26 @@ class HPPRenderContext
 	vk::Extent2D surface_extent;
 
   private:
+	static constexpr uint32_t no_frame = std::numeric_limits<uint32_t>::max();
+
+	/// Number of render targets created for offscreen rendering, as many images as a swapchain usually has
+	static constexpr uint32_t offscreen_image_count = 3;
+
+	/// Timeline semaphore of a queue and the last value signaled on it
+	struct QueueTimeline
+	{
+		vk::Semaphore semaphore;
+		uint64_t      value{0};
+	};
+
+	/// Timeline value of a queue the next submission waits for
+	struct TimelineWait
+	{
+		vk::Semaphore          semaphore;
+		uint64_t               value{0};
+		vk::PipelineStageFlags stage;
+	};
+
 	vkb::core::HPPDevice &device;
 
 	const vkb::Window &window;
@@ -226,7 +276,7 @@ class HPPRenderContext
 
 	bool prepared{false};
 
-	/// Current active frame index
+	/// Index of the active frame in the ring of frames
 	uint32_t active_frame_index{0};
 
 	/// Whether a frame is active or not
@@ -237,6 +287,39 @@ class HPPRenderContext
 	vk::SurfaceTransformFlagBitsKHR pre_transform{vk::SurfaceTransformFlagBitsKHR::eIdentity};
 
 	size_t thread_count{1};
+
+	/// Render targets of the swapchain images, or the offscreen render targets
+	std::vector<std::unique_ptr<HPPRenderTarget>> render_targets;
+
+	/// Index of the frame which rendered to each image last
+	std::vector<uint32_t> image_frame_indices;
+
+	/// Number of frames requested with set_frames_in_flight, 0 for one per image
+	uint32_t frames_in_flight{0};
+
+	/// Index of the image the active frame renders to
+	uint32_t active_image_index{0};
+
+	/// Whether submissions signal the timeline semaphore of their queue instead of a fence
+	bool timeline_semaphore_enabled{false};
+
+	/// Timeline semaphores of the queues the frames were submitted to
+	std::unordered_map<vk::Queue, QueueTimeline> queue_timelines;
+
+	/// Timeline values requested with wait_for_queue, waited for by the next submission
+	std::vector<TimelineWait> timeline_waits;
+
+	void update_render_targets();
+
+	void create_frames();
+
+	QueueTimeline &get_queue_timeline(const vkb::core::HPPQueue &queue);
+
+	void submit_to_queue(const vkb::core::HPPQueue                        &queue,
+	                     const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers,
+	                     vk::Semaphore                                     wait_semaphore,
+	                     vk::PipelineStageFlags                            wait_pipeline_stage,
+	                     vk::Semaphore                                     signal_semaphore);
 };
 
 }        // namespace rendering
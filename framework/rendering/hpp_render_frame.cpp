@@ -29,9 +29,32 @@ HPPRenderFrame::HPPRenderFrame(vkb::core::HPPDevice &device, std::unique_ptr<vkb
     device{device},
     fence_pool{device},
     semaphore_pool{device},
+    thread_count{thread_count},
     swapchain_render_target{std::move(render_target)},
-    thread_count{thread_count}
+    render_target{swapchain_render_target.get()},
+    gpu_profiler{static_cast<VkPhysicalDevice>(device.get_gpu().get_handle()),
+                 static_cast<VkDevice>(device.get_handle()),
+                 static_cast<VkQueue>(device.get_suitable_graphics_queue().get_handle()),
+                 device.get_suitable_graphics_queue().get_family_index(),
+                 device.is_enabled(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) && device.get_gpu().get_properties().limits.timestampComputeAndGraphics}
 {
+	// Samples using the C bindings record into frames created by the vulkan.hpp RenderContext, so the descriptor buffers
+	// of vkb::RenderFrame are created under the same conditions as vkb::Device enables them
+	bool descriptor_buffer_enabled = false;
+	if (device.get_gpu().is_descriptor_buffer_requested() &&
+	    device.is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+	    device.is_enabled(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME))
+	{
+		auto features = device.get_gpu().get_handle().getFeatures2KHR<vk::PhysicalDeviceFeatures2KHR,
+		                                                              vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+		                                                              vk::PhysicalDeviceBufferDeviceAddressFeatures>();
+
+		descriptor_buffer_enabled = features.get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>().descriptorBuffer &&
+		                            features.get<vk::PhysicalDeviceBufferDeviceAddressFeatures>().bufferDeviceAddress;
+	}
+
+	vk::BufferUsageFlags device_address_usage = descriptor_buffer_enabled ? vk::BufferUsageFlagBits::eShaderDeviceAddress : vk::BufferUsageFlags{};
+
 	for (auto &usage_it : supported_usage_map)
 	{
 		auto [buffer_pools_it, inserted] = buffer_pools.emplace(usage_it.first, std::vector<std::pair<vkb::BufferPoolCpp, vkb::BufferBlockCpp *>>{});
@@ -42,17 +65,42 @@ HPPRenderFrame::HPPRenderFrame(vkb::core::HPPDevice &device, std::unique_ptr<vkb
 
 		for (size_t i = 0; i < thread_count; ++i)
 		{
-			buffer_pools_it->second.push_back(std::make_pair(vkb::BufferPoolCpp{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first}, nullptr));
+			buffer_pools_it->second.push_back(
+			    std::make_pair(vkb::BufferPoolCpp{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first | device_address_usage}, nullptr));
+		}
+	}
+
+	if (descriptor_buffer_enabled)
+	{
+		auto properties = device.get_gpu().get_handle().getProperties2KHR<vk::PhysicalDeviceProperties2KHR, vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+
+		vk::DeviceSize block_size = std::min<vk::DeviceSize>(BUFFER_POOL_BLOCK_SIZE * 1024,
+		                                                     properties.get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>().maxSamplerDescriptorBufferRange);
+
+		for (size_t i = 0; i < thread_count; ++i)
+		{
+			descriptor_buffer_pools.push_back(std::make_pair(vkb::BufferPoolCpp{device,
+			                                                                    block_size,
+			                                                                    vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+			                                                                        vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+			                                                                        vk::BufferUsageFlagBits::eShaderDeviceAddress},
+			                                                  nullptr));
 		}
 	}
 
 	for (size_t i = 0; i < thread_count; ++i)
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>>());
-		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>());
+		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, CachedDescriptorSet>>());
 	}
 }
 
+void HPPRenderFrame::add_draw_statistics(uint32_t visible_draws, uint32_t culled_draws)
+{
+	visible_draw_count += visible_draws;
+	culled_draw_count += culled_draws;
+}
+
 vkb::BufferAllocationCpp HPPRenderFrame::allocate_buffer(const vk::BufferUsageFlags usage, const vk::DeviceSize size, size_t thread_index)
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
@@ -95,6 +143,8 @@ void HPPRenderFrame::clear_descriptors()
 			desc_pool.second.reset();
 		}
 	}
+
+	descriptor_set_statistics.resident = 0;
 }
 
 std::vector<uint32_t> HPPRenderFrame::collect_bindings_to_update(const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
@@ -159,6 +209,26 @@ vkb::core::HPPDevice &HPPRenderFrame::get_device()
 	return device;
 }
 
+HPPRenderFrame::DrawStatistics const &HPPRenderFrame::get_draw_statistics() const
+{
+	return draw_statistics;
+}
+
+HPPRenderFrame::DescriptorSetStatistics const &HPPRenderFrame::get_descriptor_set_statistics() const
+{
+	return descriptor_set_statistics;
+}
+
+vkb::GpuProfiler &HPPRenderFrame::get_gpu_profiler()
+{
+	return gpu_profiler;
+}
+
+vkb::GpuProfiler const &HPPRenderFrame::get_gpu_profiler() const
+{
+	return gpu_profiler;
+}
+
 const vkb::HPPFencePool &HPPRenderFrame::get_fence_pool() const
 {
 	return fence_pool;
@@ -166,12 +236,14 @@ const vkb::HPPFencePool &HPPRenderFrame::get_fence_pool() const
 
 vkb::rendering::HPPRenderTarget &HPPRenderFrame::get_render_target()
 {
-	return *swapchain_render_target;
+	assert(render_target && "The frame has no render target");
+	return *render_target;
 }
 
 vkb::rendering::HPPRenderTarget const &HPPRenderFrame::get_render_target() const
 {
-	return *swapchain_render_target;
+	assert(render_target && "The frame has no render target");
+	return *render_target;
 }
 
 const vkb::HPPSemaphorePool &HPPRenderFrame::get_semaphore_pool() const
@@ -222,12 +294,20 @@ vk::DescriptorSet HPPRenderFrame::request_descriptor_set(const vkb::core::HPPDes
 			bindings_to_update = collect_bindings_to_update(descriptor_set_layout, buffer_infos, image_infos);
 		}
 
+		std::size_t hash{0U};
+		hash_param(hash, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+
 		// Request a descriptor set from the render frame, and write the buffer infos and image infos of all the specified bindings
 		assert(thread_index < descriptor_sets.size());
-		auto &descriptor_set =
-		    vkb::common::request_resource(device, nullptr, *descriptor_sets[thread_index], descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
-		descriptor_set.update(bindings_to_update);
-		return descriptor_set.get_handle();
+		auto *descriptor_set = find_descriptor_set(hash, thread_index);
+
+		if (descriptor_set == nullptr)
+		{
+			descriptor_set = &add_descriptor_set(hash, vkb::core::HPPDescriptorSet{device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos}, thread_index);
+		}
+
+		descriptor_set->update(bindings_to_update);
+		return descriptor_set->get_handle();
 	}
 	else
 	{
@@ -253,9 +333,65 @@ vk::Semaphore HPPRenderFrame::request_semaphore_with_ownership()
 	return semaphore_pool.request_semaphore_with_ownership();
 }
 
-void HPPRenderFrame::reset()
+void HPPRenderFrame::add_timeline_signal(vk::Semaphore semaphore, uint64_t value)
+{
+	uint64_t &timeline_value = timeline_values[semaphore];
+	timeline_value           = std::max(timeline_value, value);
+}
+
+bool HPPRenderFrame::is_complete() const
+{
+	for (auto &timeline_value : timeline_values)
+	{
+		if (device.get_handle().getSemaphoreCounterValueKHR(timeline_value.first) < timeline_value.second)
+		{
+			return false;
+		}
+	}
+
+	// Submissions which didn't go through the HPPRenderContext may still use the fences of the frame
+	return fence_pool.wait(0) == VK_SUCCESS;
+}
+
+void HPPRenderFrame::wait() const
 {
+	if (!timeline_values.empty())
+	{
+		std::vector<vk::Semaphore> semaphores;
+		std::vector<uint64_t>      values;
+		semaphores.reserve(timeline_values.size());
+		values.reserve(timeline_values.size());
+
+		for (auto &timeline_value : timeline_values)
+		{
+			semaphores.push_back(timeline_value.first);
+			values.push_back(timeline_value.second);
+		}
+
+		vk::SemaphoreWaitInfoKHR wait_info{{}, semaphores, values};
+
+		vk::Result result = device.get_handle().waitSemaphoresKHR(wait_info, std::numeric_limits<uint64_t>::max());
+		if (result != vk::Result::eSuccess)
+		{
+			LOGE("Detected Vulkan error: {}", vk::to_string(result));
+			abort();
+		}
+	}
+
 	VK_CHECK(fence_pool.wait());
+}
+
+void HPPRenderFrame::reset()
+{
+	// Reclaiming a frame the GPU is done with doesn't block
+	if (!is_complete())
+	{
+		wait();
+	}
+
+	timeline_values.clear();
+
+	gpu_profiler.resolve();
 
 	fence_pool.reset();
 
@@ -276,12 +412,30 @@ void HPPRenderFrame::reset()
 		}
 	}
 
+	for (auto &descriptor_buffer_pool : descriptor_buffer_pools)
+	{
+		descriptor_buffer_pool.first.reset();
+		descriptor_buffer_pool.second = nullptr;
+	}
+
 	semaphore_pool.reset();
 
+	++frame_index;
+
 	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly)
 	{
 		clear_descriptors();
 	}
+	else
+	{
+		evict_descriptor_sets();
+	}
+
+	descriptor_set_statistics.hits   = descriptor_set_hit_count.exchange(0);
+	descriptor_set_statistics.misses = descriptor_set_miss_count.exchange(0);
+
+	draw_statistics.visible_draws = visible_draw_count.exchange(0);
+	draw_statistics.culled_draws  = culled_draw_count.exchange(0);
 }
 
 void HPPRenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
@@ -294,19 +448,87 @@ void HPPRenderFrame::set_descriptor_management_strategy(DescriptorManagementStra
 	descriptor_management_strategy = new_strategy;
 }
 
+void HPPRenderFrame::set_descriptor_set_max_age(uint32_t max_age)
+{
+	descriptor_set_max_age = max_age;
+}
+
 void HPPRenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
 	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
 	for (auto &descriptor_set_it : thread_descriptor_sets)
 	{
-		descriptor_set_it.second.update();
+		descriptor_set_it.second.descriptor_set.update();
 	}
 }
 
 void HPPRenderFrame::update_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target)
 {
 	swapchain_render_target = std::move(render_target);
+	this->render_target     = swapchain_render_target.get();
+}
+
+void HPPRenderFrame::set_render_target(vkb::rendering::HPPRenderTarget &render_target)
+{
+	this->render_target = &render_target;
+}
+
+vkb::core::HPPDescriptorSet *HPPRenderFrame::find_descriptor_set(std::size_t hash, size_t thread_index)
+{
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(hash);
+
+	if (descriptor_set_it == thread_descriptor_sets.end())
+	{
+		++descriptor_set_miss_count;
+		return nullptr;
+	}
+
+	++descriptor_set_hit_count;
+
+	descriptor_set_it->second.last_used_frame = frame_index;
+
+	return &descriptor_set_it->second.descriptor_set;
+}
+
+vkb::core::HPPDescriptorSet &HPPRenderFrame::add_descriptor_set(std::size_t hash, vkb::core::HPPDescriptorSet &&descriptor_set, size_t thread_index)
+{
+	auto [descriptor_set_it, inserted] = descriptor_sets[thread_index]->emplace(hash, CachedDescriptorSet{std::move(descriptor_set), frame_index});
+
+	if (!inserted)
+	{
+		throw std::runtime_error("Failed to insert descriptor set");
+	}
+
+	return descriptor_set_it->second.descriptor_set;
+}
+
+void HPPRenderFrame::evict_descriptor_sets()
+{
+	uint32_t resident_count = 0;
+
+	for (auto &thread_descriptor_sets : descriptor_sets)
+	{
+		for (auto descriptor_set_it = thread_descriptor_sets->begin(); descriptor_set_it != thread_descriptor_sets->end();)
+		{
+			if (frame_index - descriptor_set_it->second.last_used_frame > descriptor_set_max_age)
+			{
+				auto &descriptor_set = descriptor_set_it->second.descriptor_set;
+				descriptor_set.get_descriptor_pool().free(descriptor_set.get_handle());
+
+				descriptor_set_it = thread_descriptor_sets->erase(descriptor_set_it);
+			}
+			else
+			{
+				++resident_count;
+				++descriptor_set_it;
+			}
+		}
+	}
+
+	descriptor_set_statistics.resident = resident_count;
 }
 
 }        // namespace rendering
@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "buffer_pool.h"
 #include <core/hpp_device.h>
 #include <hpp_semaphore_pool.h>
+#include <stats/gpu_profiler.h>
 #include <vulkan/vulkan_hash.hpp>
 
 namespace vkb
@@ -83,6 +86,24 @@ class HPPRenderFrame
 	vk::Semaphore                          request_semaphore_with_ownership();
 	void                                   reset();
 
+	/**
+	 * @brief Records a value a submission of the frame signals on the timeline semaphore of a queue
+	 *        The frame is complete once every timeline semaphore reached the last value recorded for it.
+	 * @param semaphore The timeline semaphore of the queue
+	 * @param value The value signaled by the submission
+	 */
+	void add_timeline_signal(vk::Semaphore semaphore, uint64_t value);
+
+	/**
+	 * @brief Checks without blocking whether the GPU completed the submissions of the frame
+	 */
+	bool is_complete() const;
+
+	/**
+	 * @brief Waits for the GPU to complete the submissions of the frame, without resetting it
+	 */
+	void wait() const;
+
 	/**
 	 * @param usage Usage of the buffer
 	 * @param size Amount of memory required
@@ -118,17 +139,78 @@ class HPPRenderFrame
 	 */
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
+	/**
+	 * @brief Sets how many times the frame can be reset before a cached descriptor set that it didn't use is freed
+	 *        Only applies to the StoreInCache strategy.
+	 * @param max_age The number of resets a descriptor set can stay unused for
+	 */
+	void set_descriptor_set_max_age(uint32_t max_age);
+
 	/**
 	 * @brief Called when the swapchain changes
 	 * @param render_target A new render target with updated images
 	 */
 	void update_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target);
 
+	/**
+	 * @brief Renders the frame to a render target it doesn't own
+	 * @param render_target A render target which outlives its use by the frame
+	 */
+	void set_render_target(vkb::rendering::HPPRenderTarget &render_target);
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @brief Draw counters reported by the scene subpasses while recording the frame
+	 */
+	struct DrawStatistics
+	{
+		uint32_t visible_draws{0};
+
+		uint32_t culled_draws{0};
+	};
+
+	/**
+	 * @brief Accumulates the draw counters of a subpass, may be called from any recording thread
+	 *        Only draws culled on the CPU are counted, the visibility of indirect draws culled on the GPU is not known
+	 * @param visible_draws Number of draws that passed culling
+	 * @param culled_draws Number of draws that were rejected by culling
+	 */
+	void add_draw_statistics(uint32_t visible_draws, uint32_t culled_draws);
+
+	/**
+	 * @return The draw counters collected the last time this frame was recorded
+	 */
+	DrawStatistics const &get_draw_statistics() const;
+
+	/**
+	 * @brief Descriptor set cache counters of the frame
+	 */
+	struct DescriptorSetStatistics
+	{
+		/// Requests served by a cached descriptor set the last time this frame was recorded
+		uint32_t hits{0};
+
+		/// Requests which allocated a descriptor set the last time this frame was recorded
+		uint32_t misses{0};
+
+		/// Descriptor sets kept in the cache after the last eviction
+		uint32_t resident{0};
+	};
+
+	DescriptorSetStatistics const &get_descriptor_set_statistics() const;
+
+	/**
+	 * @brief Gets the profiler measuring the GPU time of the scopes recorded in the frame
+	 *        The timings are resolved when the frame is reset, once the GPU completed it.
+	 */
+	vkb::GpuProfiler &get_gpu_profiler();
+
+	vkb::GpuProfiler const &get_gpu_profiler() const;
+
   private:
 	/**
 	 * @brief Retrieve the frame's command pool(s)
@@ -140,6 +222,12 @@ class HPPRenderFrame
 	std::vector<std::unique_ptr<vkb::core::HPPCommandPool>> &get_command_pools(const vkb::core::HPPQueue             &queue,
 	                                                                           vkb::core::HPPCommandBuffer::ResetMode reset_mode);
 
+	vkb::core::HPPDescriptorSet *find_descriptor_set(std::size_t hash, size_t thread_index);
+
+	vkb::core::HPPDescriptorSet &add_descriptor_set(std::size_t hash, vkb::core::HPPDescriptorSet &&descriptor_set, size_t thread_index);
+
+	void evict_descriptor_sets();
+
 	static std::vector<uint32_t> collect_bindings_to_update(const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
 	                                                        const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
 	                                                        const BindingMap<vk::DescriptorImageInfo>  &image_infos);
@@ -160,8 +248,19 @@ class HPPRenderFrame
 	/// Descriptor pools for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, vkb::core::HPPDescriptorPool>>> descriptor_pools;
 
+	struct CachedDescriptorSet
+	{
+		vkb::core::HPPDescriptorSet descriptor_set;
+
+		uint32_t last_used_frame;
+	};
+
 	/// Descriptor sets for the frame
-	std::vector<std::unique_ptr<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>> descriptor_sets;
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, CachedDescriptorSet>>> descriptor_sets;
+
+	uint32_t frame_index{0};
+
+	uint32_t descriptor_set_max_age{8};
 
 	vkb::HPPFencePool fence_pool;
 
@@ -171,11 +270,32 @@ class HPPRenderFrame
 
 	std::unique_ptr<vkb::rendering::HPPRenderTarget> swapchain_render_target;
 
+	vkb::rendering::HPPRenderTarget *render_target{nullptr};
+
 	BufferAllocationStrategy buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<vk::BufferUsageFlags, std::vector<std::pair<vkb::BufferPoolCpp, vkb::BufferBlockCpp *>>> buffer_pools;
+
+	/// Descriptor buffers of vkb::RenderFrame, only created for devices which use descriptor buffers
+	std::vector<std::pair<vkb::BufferPoolCpp, vkb::BufferBlockCpp *>> descriptor_buffer_pools;
+
+	/// Draw counters of the frame being recorded, collected into draw_statistics on reset
+	std::atomic<uint32_t> visible_draw_count{0};
+	std::atomic<uint32_t> culled_draw_count{0};
+
+	DrawStatistics draw_statistics{};
+
+	std::atomic<uint32_t> descriptor_set_hit_count{0};
+	std::atomic<uint32_t> descriptor_set_miss_count{0};
+
+	DescriptorSetStatistics descriptor_set_statistics{};
+
+	/// Last value signaled by the frame on the timeline semaphore of each queue it was submitted to
+	std::unordered_map<vk::Semaphore, uint64_t> timeline_values;
+
+	vkb::GpuProfiler gpu_profiler;
 };
 }        // namespace rendering
 }        // namespace vkb
@@ -0,0 +1,455 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/indirect_scene.h"
+
+#include <map>
+#include <tuple>
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/physical_device.h"
+#include "geometry/frustum.h"
+#include "rendering/render_frame.h"
+#include "scene_graph/components/material.h"
+#include "scene_graph/components/mesh.h"
+#include "scene_graph/components/sub_mesh.h"
+#include "scene_graph/node.h"
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Push constants of the culling shader
+ */
+struct CullingUniform
+{
+	std::array<glm::vec4, 6> frustum_planes;
+
+	uint32_t object_count;
+
+	uint32_t compact;
+};
+
+/**
+ * @brief Where the geometry of a submesh is in the packed buffers
+ */
+struct PackedRange
+{
+	uint32_t vertex_offset;
+
+	uint32_t first_index;
+};
+
+inline uint32_t get_index_size(VkIndexType index_type)
+{
+	return index_type == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+}
+
+/**
+ * @brief Checks that a submesh can be drawn from the packed buffers, and adds its attributes to the packed layout
+ */
+bool pack_attributes(const sg::SubMesh &sub_mesh, std::unordered_map<std::string, sg::VertexAttribute> &packed_attributes)
+{
+	if (sub_mesh.get_material()->alpha_mode == sg::AlphaMode::Blend)
+	{
+		// Transparent objects need to be sorted on the CPU
+		return false;
+	}
+
+	if (!sub_mesh.get_index_buffer() || sub_mesh.vertex_indices == 0 || sub_mesh.get_attributes().empty() ||
+	    (sub_mesh.index_type != VK_INDEX_TYPE_UINT16 && sub_mesh.index_type != VK_INDEX_TYPE_UINT32))
+	{
+		return false;
+	}
+
+	for (auto &attribute : sub_mesh.get_attributes())
+	{
+		auto *vertex_buffer = sub_mesh.get_vertex_buffer(attribute.first);
+		if (!vertex_buffer || attribute.second.offset != 0 ||
+		    vertex_buffer->get_size() < attribute.second.buffer_offset + static_cast<VkDeviceSize>(attribute.second.stride) * sub_mesh.vertices_count)
+		{
+			return false;
+		}
+
+		// All the vertices of an attribute share the same buffer, so they need the same layout
+		auto packed_it = packed_attributes.find(attribute.first);
+		if (packed_it != packed_attributes.end() && (packed_it->second.format != attribute.second.format || packed_it->second.stride != attribute.second.stride))
+		{
+			return false;
+		}
+	}
+
+	for (auto &attribute : sub_mesh.get_attributes())
+	{
+		sg::VertexAttribute packed_attribute = attribute.second;
+		packed_attribute.buffer_offset       = 0;
+		packed_attributes.emplace(attribute.first, packed_attribute);
+	}
+
+	return true;
+}
+}        // namespace
+
+void IndirectScene::request_gpu_features(PhysicalDevice &gpu)
+{
+	if (gpu.get_features().multiDrawIndirect)
+	{
+		gpu.get_mutable_requested_features().multiDrawIndirect = VK_TRUE;
+	}
+
+	if (gpu.get_features().drawIndirectFirstInstance)
+	{
+		gpu.get_mutable_requested_features().drawIndirectFirstInstance = VK_TRUE;
+	}
+}
+
+bool IndirectScene::is_supported(Device &device)
+{
+	// The objects are drawn as several draws per indirect call, each one selecting its transform with its first instance
+	auto features = device.get_gpu().get_requested_features();
+	return features.multiDrawIndirect && features.drawIndirectFirstInstance;
+}
+
+IndirectScene::IndirectScene(Device &device, const std::vector<sg::Mesh *> &meshes) :
+    device{device},
+    cull_shader{"indirect_scene/cull.comp"},
+    draw_count_enabled{device.is_enabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)}
+{
+	// Decide the layout of the packed buffers
+	std::unordered_map<std::string, sg::VertexAttribute> packed_attributes;
+	std::unordered_map<const sg::SubMesh *, PackedRange> packed_ranges;
+	std::vector<const sg::SubMesh *>                     packed_order;
+
+	uint32_t vertex_count   = 0;
+	uint32_t index_count_16 = 0;
+	uint32_t index_count_32 = 0;
+
+	for (auto *mesh : meshes)
+	{
+		for (auto *sub_mesh : mesh->get_submeshes())
+		{
+			if (packed_ranges.count(sub_mesh) > 0 || !pack_attributes(*sub_mesh, packed_attributes))
+			{
+				continue;
+			}
+
+			auto &index_count = sub_mesh->index_type == VK_INDEX_TYPE_UINT16 ? index_count_16 : index_count_32;
+
+			packed_ranges[sub_mesh] = {vertex_count, index_count};
+			packed_order.push_back(sub_mesh);
+
+			vertex_count += sub_mesh->vertices_count;
+			index_count += sub_mesh->vertex_indices;
+		}
+	}
+
+	if (packed_order.empty())
+	{
+		LOGW("No submesh of the scene can be drawn indirectly");
+		return;
+	}
+
+	// Assign the objects to their draw groups
+	using GroupKey = std::tuple<const sg::Material *, size_t, VkIndexType, bool>;
+
+	std::map<GroupKey, uint32_t> group_indices;
+	std::vector<DrawObject>      objects;
+
+	for (auto *mesh : meshes)
+	{
+		const auto &bounds = mesh->get_bounds();
+
+		for (auto *node : mesh->get_nodes())
+		{
+			const auto &scale   = node->get_transform().get_scale();
+			bool        flipped = scale.x * scale.y * scale.z < 0;
+
+			for (auto *sub_mesh : mesh->get_submeshes())
+			{
+				auto range_it = packed_ranges.find(sub_mesh);
+				if (range_it == packed_ranges.end())
+				{
+					continue;
+				}
+
+				GroupKey key{sub_mesh->get_material(), sub_mesh->get_shader_variant().get_id(), sub_mesh->index_type, flipped};
+
+				auto group_it = group_indices.find(key);
+				if (group_it == group_indices.end())
+				{
+					group_it = group_indices.emplace(key, to_u32(draw_groups.size())).first;
+					draw_groups.push_back({sub_mesh, flipped, sub_mesh->index_type, 0, 0});
+				}
+
+				DrawObject object{};
+				object.bounds_min    = glm::vec4(bounds.get_min(), bounds.is_empty() ? 0.0f : 1.0f);
+				object.bounds_max    = glm::vec4(bounds.get_max(), bounds.is_empty() ? 0.0f : 1.0f);
+				object.index_count   = sub_mesh->vertex_indices;
+				object.first_index   = range_it->second.first_index;
+				object.vertex_offset = static_cast<int32_t>(range_it->second.vertex_offset);
+				object.group         = group_it->second;
+				object.command       = draw_groups[group_it->second].command_count++;
+
+				objects.push_back(object);
+				object_nodes.push_back(node);
+			}
+		}
+
+		for (auto *sub_mesh : mesh->get_submeshes())
+		{
+			if (packed_ranges.count(sub_mesh) > 0)
+			{
+				packed_sub_meshes.insert(sub_mesh);
+			}
+		}
+	}
+
+	uint32_t command_count = 0;
+	for (auto &group : draw_groups)
+	{
+		group.first_command = command_count;
+		command_count += group.command_count;
+	}
+
+	for (auto &object : objects)
+	{
+		object.first_command = draw_groups[object.group].first_command;
+		object.command += object.first_command;
+	}
+
+	// Create the packed buffers and copy the geometry of each submesh into them
+	for (auto &attribute : packed_attributes)
+	{
+		core::BufferC buffer{device,
+		                     static_cast<VkDeviceSize>(attribute.second.stride) * vertex_count,
+		                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                     VMA_MEMORY_USAGE_GPU_ONLY};
+		buffer.set_debug_name(fmt::format("Indirect scene: '{}' vertex buffer", attribute.first));
+
+		vertex_buffers.emplace(attribute.first, std::move(buffer));
+	}
+
+	if (index_count_16 > 0)
+	{
+		index_buffer_u16 = std::make_unique<core::BufferC>(device,
+		                                                   static_cast<VkDeviceSize>(index_count_16) * 2,
+		                                                   VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                   VMA_MEMORY_USAGE_GPU_ONLY);
+	}
+
+	if (index_count_32 > 0)
+	{
+		index_buffer_u32 = std::make_unique<core::BufferC>(device,
+		                                                   static_cast<VkDeviceSize>(index_count_32) * 4,
+		                                                   VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		                                                   VMA_MEMORY_USAGE_GPU_ONLY);
+	}
+
+	object_buffer = std::make_unique<core::BufferC>(device,
+	                                                objects.size() * sizeof(DrawObject),
+	                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                VMA_MEMORY_USAGE_GPU_ONLY);
+
+	draw_command_buffer = std::make_unique<core::BufferC>(device,
+	                                                      command_count * sizeof(VkDrawIndexedIndirectCommand),
+	                                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+	                                                      VMA_MEMORY_USAGE_GPU_ONLY);
+
+	draw_count_buffer = std::make_unique<core::BufferC>(device,
+	                                                    draw_groups.size() * sizeof(uint32_t),
+	                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                    VMA_MEMORY_USAGE_GPU_ONLY);
+
+	auto &command_buffer = device.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	for (auto *sub_mesh : packed_order)
+	{
+		auto &range = packed_ranges[sub_mesh];
+
+		for (auto &attribute : sub_mesh->get_attributes())
+		{
+			auto stride = attribute.second.stride;
+
+			VkBufferCopy copy_region{};
+			copy_region.srcOffset = attribute.second.buffer_offset;
+			copy_region.dstOffset = static_cast<VkDeviceSize>(range.vertex_offset) * stride;
+			copy_region.size      = static_cast<VkDeviceSize>(sub_mesh->vertices_count) * stride;
+
+			command_buffer.copy_buffer(*sub_mesh->get_vertex_buffer(attribute.first), vertex_buffers.at(attribute.first), {copy_region});
+		}
+
+		auto index_size = get_index_size(sub_mesh->index_type);
+
+		VkBufferCopy copy_region{};
+		copy_region.srcOffset = sub_mesh->index_offset;
+		copy_region.dstOffset = static_cast<VkDeviceSize>(range.first_index) * index_size;
+		copy_region.size      = static_cast<VkDeviceSize>(sub_mesh->vertex_indices) * index_size;
+
+		command_buffer.copy_buffer(*sub_mesh->get_index_buffer(), sub_mesh->index_type == VK_INDEX_TYPE_UINT16 ? *index_buffer_u16 : *index_buffer_u32, {copy_region});
+	}
+
+	auto stage_buffer = core::BufferC::create_staging_buffer(device, objects);
+	command_buffer.copy_buffer(stage_buffer, *object_buffer, stage_buffer.get_size());
+
+	command_buffer.end();
+
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	queue.submit(command_buffer, device.request_fence());
+
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
+
+	LOGI("Indirect scene: {} objects in {} draw groups, {} vertices", objects.size(), draw_groups.size(), vertex_count);
+}
+
+bool IndirectScene::contains(const sg::SubMesh &sub_mesh) const
+{
+	return packed_sub_meshes.count(&sub_mesh) > 0;
+}
+
+void IndirectScene::cull(CommandBuffer &command_buffer, RenderFrame &render_frame, const glm::mat4 &view_projection, size_t thread_index)
+{
+	transforms = {};
+
+	if (object_nodes.empty())
+	{
+		return;
+	}
+
+	// The transforms are read by the culling shader and by the vertex shader
+	transforms = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, object_nodes.size() * sizeof(glm::mat4), thread_index);
+
+	auto *models = reinterpret_cast<glm::mat4 *>(transforms.map());
+	for (size_t i = 0; i < object_nodes.size(); ++i)
+	{
+		models[i] = object_nodes[i]->get_transform().get_world_matrix();
+	}
+	transforms.flush();
+
+	// Wait for the draws of the previous frame to have read the commands before overwriting them
+	BufferMemoryBarrier reuse_barrier{};
+	reuse_barrier.src_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	reuse_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	reuse_barrier.src_access_mask = 0;
+	reuse_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+	command_buffer.buffer_memory_barrier(*draw_command_buffer, 0, VK_WHOLE_SIZE, reuse_barrier);
+	command_buffer.buffer_memory_barrier(*draw_count_buffer, 0, VK_WHOLE_SIZE, reuse_barrier);
+
+	if (draw_count_enabled)
+	{
+		command_buffer.fill_buffer(*draw_count_buffer, 0, VK_WHOLE_SIZE, 0);
+
+		BufferMemoryBarrier clear_barrier{};
+		clear_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		clear_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		clear_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		clear_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		command_buffer.buffer_memory_barrier(*draw_count_buffer, 0, VK_WHOLE_SIZE, clear_barrier);
+	}
+
+	auto &resource_cache  = device.get_resource_cache();
+	auto &cull_module     = resource_cache.request_shader_module(VK_SHADER_STAGE_COMPUTE_BIT, cull_shader);
+	auto &pipeline_layout = resource_cache.request_pipeline_layout({&cull_module});
+
+	command_buffer.bind_pipeline_layout(pipeline_layout);
+
+	command_buffer.bind_buffer(*object_buffer, 0, object_buffer->get_size(), 0, 0, 0);
+	command_buffer.bind_buffer(transforms.get_buffer(), transforms.get_offset(), transforms.get_size(), 0, 1, 0);
+	command_buffer.bind_buffer(*draw_command_buffer, 0, draw_command_buffer->get_size(), 0, 2, 0);
+	command_buffer.bind_buffer(*draw_count_buffer, 0, draw_count_buffer->get_size(), 0, 3, 0);
+
+	Frustum frustum;
+	frustum.update(view_projection);
+
+	CullingUniform culling{};
+	culling.frustum_planes = frustum.get_planes();
+	culling.object_count   = to_u32(object_nodes.size());
+	culling.compact        = draw_count_enabled ? 1 : 0;
+
+	command_buffer.push_constants(culling);
+
+	command_buffer.dispatch((culling.object_count + 63) / 64, 1, 1);
+
+	BufferMemoryBarrier draw_barrier{};
+	draw_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	draw_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	draw_barrier.src_access_mask = VK_ACCESS_SHADER_WRITE_BIT;
+	draw_barrier.dst_access_mask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+	command_buffer.buffer_memory_barrier(*draw_command_buffer, 0, VK_WHOLE_SIZE, draw_barrier);
+	command_buffer.buffer_memory_barrier(*draw_count_buffer, 0, VK_WHOLE_SIZE, draw_barrier);
+}
+
+void IndirectScene::bind_vertex_buffers(CommandBuffer &command_buffer, const std::vector<ShaderResource> &vertex_inputs)
+{
+	for (auto &input_resource : vertex_inputs)
+	{
+		auto buffer_it = vertex_buffers.find(input_resource.name);
+		if (buffer_it != vertex_buffers.end())
+		{
+			std::vector<std::reference_wrapper<const core::BufferC>> buffers;
+			buffers.emplace_back(std::ref(buffer_it->second));
+
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+		}
+	}
+}
+
+void IndirectScene::draw(CommandBuffer &command_buffer, size_t group_index)
+{
+	auto &group = draw_groups[group_index];
+
+	auto &index_buffer = group.index_type == VK_INDEX_TYPE_UINT16 ? *index_buffer_u16 : *index_buffer_u32;
+	command_buffer.bind_index_buffer(index_buffer, 0, group.index_type);
+
+	VkDeviceSize command_offset = group.first_command * sizeof(VkDrawIndexedIndirectCommand);
+
+	if (draw_count_enabled)
+	{
+		command_buffer.draw_indexed_indirect_count(*draw_command_buffer, command_offset,
+		                                           *draw_count_buffer, group_index * sizeof(uint32_t),
+		                                           group.command_count, sizeof(VkDrawIndexedIndirectCommand));
+	}
+	else
+	{
+		command_buffer.draw_indexed_indirect(*draw_command_buffer, command_offset, group.command_count, sizeof(VkDrawIndexedIndirectCommand));
+	}
+}
+
+const std::vector<IndirectScene::DrawGroup> &IndirectScene::get_draw_groups() const
+{
+	return draw_groups;
+}
+
+BufferAllocationC &IndirectScene::get_transforms()
+{
+	return transforms;
+}
+
+uint32_t IndirectScene::get_object_count() const
+{
+	return to_u32(object_nodes.size());
+}
+}        // namespace vkb
@@ -0,0 +1,192 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer_pool.h"
+#include "common/glm_common.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class PhysicalDevice;
+class RenderFrame;
+
+namespace sg
+{
+class Mesh;
+class Node;
+class SubMesh;
+}        // namespace sg
+
+/**
+ * @brief The opaque geometry of a scene packed into shared buffers, for GPU-driven rendering
+ *
+ * Every node and submesh pair becomes an object. Each frame a compute shader culls the objects
+ * against the camera frustum and writes one VkDrawIndexedIndirectCommand per visible object.
+ * Objects sharing a material, a shader variant, an index type and a winding form a draw group,
+ * which is submitted with a single indirect draw.
+ *
+ * If VK_KHR_draw_indirect_count is enabled, the visible draws of a group are compacted and
+ * counted on the GPU, otherwise culled draws are written with no instances.
+ */
+class IndirectScene
+{
+  public:
+	/**
+	 * @brief A range of the indirect commands sharing the same pipeline state and material
+	 */
+	struct DrawGroup
+	{
+		/// First submesh of the group, which provides the material and the shader variant
+		sg::SubMesh *sub_mesh;
+
+		bool flipped;
+
+		VkIndexType index_type;
+
+		uint32_t first_command;
+
+		uint32_t command_count;
+	};
+
+	/**
+	 * @brief Requests the features needed to render a scene indirectly, if the GPU supports them
+	 *        Samples can also enable VK_KHR_draw_indirect_count to count the draws on the GPU
+	 */
+	static void request_gpu_features(PhysicalDevice &gpu);
+
+	/**
+	 * @return Whether the device has the features needed to render a scene indirectly enabled
+	 */
+	static bool is_supported(Device &device);
+
+	/**
+	 * @brief Packs the geometry of the opaque submeshes of the meshes provided
+	 *        Submeshes with attributes which can't be packed with the others are left out
+	 */
+	IndirectScene(Device &device, const std::vector<sg::Mesh *> &meshes);
+
+	IndirectScene(const IndirectScene &) = delete;
+
+	IndirectScene(IndirectScene &&) = delete;
+
+	IndirectScene &operator=(const IndirectScene &) = delete;
+
+	IndirectScene &operator=(IndirectScene &&) = delete;
+
+	/**
+	 * @return Whether a submesh is drawn by the indirect scene
+	 */
+	bool contains(const sg::SubMesh &sub_mesh) const;
+
+	/**
+	 * @brief Uploads the transforms of the objects and records the culling of the objects
+	 *        It must be recorded outside of a render pass
+	 * @param command_buffer Command buffer to record the culling
+	 * @param render_frame Frame to allocate the transforms from
+	 * @param view_projection The camera matrix to build the culling frustum
+	 * @param thread_index Thread index to use for allocating resources
+	 */
+	void cull(CommandBuffer &command_buffer, RenderFrame &render_frame, const glm::mat4 &view_projection, size_t thread_index);
+
+	/**
+	 * @brief Binds the packed vertex buffers matching the vertex inputs of a pipeline
+	 */
+	void bind_vertex_buffers(CommandBuffer &command_buffer, const std::vector<ShaderResource> &vertex_inputs);
+
+	/**
+	 * @brief Binds the packed index buffer of a group and records its indirect draw
+	 */
+	void draw(CommandBuffer &command_buffer, size_t group_index);
+
+	const std::vector<DrawGroup> &get_draw_groups() const;
+
+	/**
+	 * @return The world matrices of the objects of the current frame, indexed by instance index
+	 */
+	BufferAllocationC &get_transforms();
+
+	uint32_t get_object_count() const;
+
+  private:
+	/**
+	 * @brief An object as read by the culling shader
+	 */
+	struct alignas(16) DrawObject
+	{
+		/// Bounds of the mesh in model space, w is 0 if the mesh has no bounds
+		glm::vec4 bounds_min;
+
+		glm::vec4 bounds_max;
+
+		uint32_t index_count;
+
+		uint32_t first_index;
+
+		int32_t vertex_offset;
+
+		uint32_t group;
+
+		/// First command of the group of the object
+		uint32_t first_command;
+
+		/// Command of the object when the draws are not compacted
+		uint32_t command;
+
+		uint32_t padding[2];
+	};
+
+	Device &device;
+
+	ShaderSource cull_shader;
+
+	bool draw_count_enabled{false};
+
+	std::unordered_set<const sg::SubMesh *> packed_sub_meshes;
+
+	/// Packed vertex buffers, by attribute name
+	std::unordered_map<std::string, core::BufferC> vertex_buffers;
+
+	std::unique_ptr<core::BufferC> index_buffer_u16;
+
+	std::unique_ptr<core::BufferC> index_buffer_u32;
+
+	/// Node of each object, in object order
+	std::vector<sg::Node *> object_nodes;
+
+	std::vector<DrawGroup> draw_groups;
+
+	std::unique_ptr<core::BufferC> object_buffer;
+
+	std::unique_ptr<core::BufferC> draw_command_buffer;
+
+	std::unique_ptr<core::BufferC> draw_count_buffer;
+
+	BufferAllocationC transforms;
+};
+}        // namespace vkb
@@ -37,6 +37,7 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 			pass.debug_name = fmt::format("PPP pass #{}", current_pass_index);
 		}
 		ScopedDebugLabel marker{command_buffer, pass.debug_name.c_str()};
+		ScopedGpuTimer   gpu_timer{command_buffer, pass.debug_name.c_str()};
 
 		if (!pass.prepared)
 		{
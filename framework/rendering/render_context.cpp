@@ -47,47 +47,79 @@ RenderContext::RenderContext(Device                                &device,
 			swapchain = std::make_unique<Swapchain>(device, surface, present_mode, present_mode_priority_list, surface_format_priority_list);
 		}
 	}
+
+	timeline_semaphore_enabled = device.is_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+}
+
+RenderContext::~RenderContext()
+{
+	for (auto &queue_timeline : queue_timelines)
+	{
+		vkDestroySemaphore(device.get_handle(), queue_timeline.second.semaphore, nullptr);
+	}
 }
 
 void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create_render_target_func)
 {
 	device.wait_idle();
 
+	this->create_render_target_func = create_render_target_func;
+	this->thread_count              = thread_count;
+
 	if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
 
-		VkExtent3D extent{surface_extent.width, surface_extent.height, 1};
+		update_render_targets();
+	}
+	else
+	{
+		// Otherwise, create a ring of RenderTargets, so that frames in flight don't wait for each other's image
+		swapchain = nullptr;
 
-		for (auto &image_handle : swapchain->get_images())
+		render_targets.clear();
+		for (uint32_t i = 0; i < offscreen_image_count; ++i)
 		{
-			auto swapchain_image = core::Image{
-			    device, image_handle,
-			    extent,
-			    swapchain->get_format(),
-			    swapchain->get_usage()};
-			auto render_target = create_render_target_func(std::move(swapchain_image));
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			auto color_image = core::Image{device,
+			                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
+			                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
+			                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,        // Samples may copy their output to the frame image
+			                               VMA_MEMORY_USAGE_GPU_ONLY};
+
+			render_targets.push_back(create_render_target_func(std::move(color_image)));
 		}
+		image_frame_indices.assign(render_targets.size(), no_frame);
 	}
-	else
+
+	create_frames();
+
+	// The first frame to begin is the first one of the ring
+	active_frame_index = to_u32(frames.size()) - 1;
+
+	this->prepared = true;
+}
+
+void RenderContext::set_frames_in_flight(uint32_t count)
+{
+	frames_in_flight = count;
+
+	if (prepared)
 	{
-		// Otherwise, create a single RenderFrame
-		swapchain = nullptr;
+		assert(!frame_active && "Frame is still active, please call end_frame");
+
+		device.wait_idle();
 
-		auto color_image = core::Image{device,
-		                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
-		                               DEFAULT_VK_FORMAT,        // We can use any format here that we like
-		                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-		                               VMA_MEMORY_USAGE_GPU_ONLY};
+		frames.clear();
+		create_frames();
 
-		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+		image_frame_indices.assign(render_targets.size(), no_frame);
+		active_frame_index = to_u32(frames.size()) - 1;
 	}
+}
 
-	this->create_render_target_func = create_render_target_func;
-	this->thread_count              = thread_count;
-	this->prepared                  = true;
+uint32_t RenderContext::get_frames_in_flight() const
+{
+	return to_u32(frames.size());
 }
 
 VkFormat RenderContext::get_format() const
@@ -194,32 +226,10 @@ void RenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
-
-	for (auto &image_handle : swapchain->get_images())
-	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
-
-		auto render_target = create_render_target_func(std::move(swapchain_image));
-
-		if (frame_it != frames.end())
-		{
-			(*frame_it)->update_render_target(std::move(render_target));
-		}
-		else
-		{
-			// Create a new frame if the new swapchain has more images than current frames
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
-		}
+	update_render_targets();
 
-		++frame_it;
-	}
+	// Create new frames if the new swapchain has more images than current frames
+	create_frames();
 
 	device.get_resource_cache().clear_framebuffers();
 }
@@ -314,16 +324,25 @@ void RenderContext::begin_frame()
 
 	assert(!frame_active && "Frame is still active, please call end_frame");
 
-	assert(active_frame_index < frames.size());
-	auto &prev_frame = *frames[active_frame_index];
+	// Frames are used in turn, whichever swapchain image they render to
+	active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
 
-	// We will use the acquired semaphore in a different frame context,
-	// so we need to hold ownership.
-	acquired_semaphore = prev_frame.request_semaphore_with_ownership();
+	// Now the frame is active again
+	frame_active = true;
+
+	// Wait on all resource to be freed from the previous render to this frame
+	wait_frame();
+
+	auto &frame = get_active_frame();
+
+	// The acquired semaphore may be consumed by the sample, so the frame only gets it back in end_frame
+	acquired_semaphore = frame.request_semaphore_with_ownership();
+
+	active_image_index = 0;
 
 	if (swapchain)
 	{
-		auto result = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+		auto result = swapchain->acquire_next_image(active_image_index, acquired_semaphore, VK_NULL_HANDLE);
 
 		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
@@ -339,23 +358,35 @@ void RenderContext::begin_frame()
 			{
 				// Need to destroy and reallocate acquired_semaphore since it may have already been signaled
 				vkDestroySemaphore(device.get_handle(), acquired_semaphore, nullptr);
-				acquired_semaphore = prev_frame.request_semaphore_with_ownership();
-				result             = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+				acquired_semaphore = frame.request_semaphore_with_ownership();
+				result             = swapchain->acquire_next_image(active_image_index, acquired_semaphore, VK_NULL_HANDLE);
 			}
 		}
 
 		if (result != VK_SUCCESS)
 		{
-			prev_frame.reset();
+			// No image was acquired, so the semaphore wasn't signaled and can be reused
+			frame.release_owned_semaphore(acquired_semaphore);
+			acquired_semaphore = VK_NULL_HANDLE;
+			frame_active       = false;
 			return;
 		}
 	}
+	else
+	{
+		// Without a presentation engine, the frames render to the images in turn
+		active_image_index = active_frame_index % to_u32(render_targets.size());
+	}
 
-	// Now the frame is active again
-	frame_active = true;
+	// The attachments of the image other than the swapchain image may still be used by the frame which rendered to it last
+	uint32_t &image_frame_index = image_frame_indices[active_image_index];
+	if (image_frame_index != active_frame_index && image_frame_index < frames.size())
+	{
+		frames[image_frame_index]->wait();
+	}
+	image_frame_index = active_frame_index;
 
-	// Wait on all resource to be freed from the previous render to this frame
-	wait_frame();
+	frame.set_render_target(*render_targets[active_image_index]);
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
@@ -363,45 +394,124 @@ VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandB
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
-	RenderFrame &frame = get_active_frame();
+	// The binary semaphore is still needed by the presentation engine, which can't wait on timeline semaphores
+	VkSemaphore signal_semaphore = get_active_frame().request_semaphore();
 
-	VkSemaphore signal_semaphore = frame.request_semaphore();
+	submit_to_queue(queue, command_buffers, wait_semaphore, wait_pipeline_stage, signal_semaphore);
 
-	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	return signal_semaphore;
+}
 
-	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
-	submit_info.pCommandBuffers    = cmd_buf_handles.data();
+void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers)
+{
+	submit_to_queue(queue, command_buffers, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
 
-	if (wait_semaphore != VK_NULL_HANDLE)
+void RenderContext::wait_for_queue(const Queue &queue, VkPipelineStageFlags wait_stage)
+{
+	assert(timeline_semaphore_enabled && "Waiting for a queue requires timeline semaphores");
+
+	QueueTimeline &timeline = get_queue_timeline(queue);
+	if (timeline.value > 0)
 	{
-		submit_info.waitSemaphoreCount = 1;
-		submit_info.pWaitSemaphores    = &wait_semaphore;
-		submit_info.pWaitDstStageMask  = &wait_pipeline_stage;
+		timeline_waits.push_back({timeline.semaphore, timeline.value, wait_stage});
 	}
+}
 
-	submit_info.signalSemaphoreCount = 1;
-	submit_info.pSignalSemaphores    = &signal_semaphore;
+bool RenderContext::is_timeline_semaphore_enabled() const
+{
+	return timeline_semaphore_enabled;
+}
 
-	VkFence fence = frame.request_fence();
+RenderContext::QueueTimeline &RenderContext::get_queue_timeline(const Queue &queue)
+{
+	auto it = queue_timelines.find(queue.get_handle());
+	if (it == queue_timelines.end())
+	{
+		VkSemaphoreTypeCreateInfoKHR semaphore_type_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+		semaphore_type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		semaphore_type_info.initialValue  = 0;
 
-	VK_CHECK(queue.submit({submit_info}, fence));
+		VkSemaphoreCreateInfo create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+		create_info.pNext = &semaphore_type_info;
 
-	return signal_semaphore;
+		QueueTimeline timeline{};
+		VK_CHECK(vkCreateSemaphore(device.get_handle(), &create_info, nullptr, &timeline.semaphore));
+
+		it = queue_timelines.emplace(queue.get_handle(), timeline).first;
+	}
+
+	return it->second;
 }
 
-void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers)
+void RenderContext::submit_to_queue(const Queue                        &queue,
+                                    const std::vector<CommandBuffer *> &command_buffers,
+                                    VkSemaphore                         wait_semaphore,
+                                    VkPipelineStageFlags                wait_pipeline_stage,
+                                    VkSemaphore                         signal_semaphore)
 {
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
 	RenderFrame &frame = get_active_frame();
 
-	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	// Values of binary semaphores are ignored, but the value arrays must match the semaphore arrays
+	std::vector<VkSemaphore>          wait_semaphores;
+	std::vector<VkPipelineStageFlags> wait_stages;
+	std::vector<uint64_t>             wait_values;
+	if (wait_semaphore != VK_NULL_HANDLE)
+	{
+		wait_semaphores.push_back(wait_semaphore);
+		wait_stages.push_back(wait_pipeline_stage);
+		wait_values.push_back(0);
+	}
+	for (auto &timeline_wait : timeline_waits)
+	{
+		wait_semaphores.push_back(timeline_wait.semaphore);
+		wait_stages.push_back(timeline_wait.stage);
+		wait_values.push_back(timeline_wait.value);
+	}
+	timeline_waits.clear();
+
+	std::vector<VkSemaphore> signal_semaphores;
+	std::vector<uint64_t>    signal_values;
+	if (signal_semaphore != VK_NULL_HANDLE)
+	{
+		signal_semaphores.push_back(signal_semaphore);
+		signal_values.push_back(0);
+	}
+
+	VkSubmitInfo                     submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	VkTimelineSemaphoreSubmitInfoKHR timeline_submit_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	VkFence                          fence{VK_NULL_HANDLE};
 
-	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
-	submit_info.pCommandBuffers    = cmd_buf_handles.data();
+	if (timeline_semaphore_enabled)
+	{
+		// The frame is retired once the timeline semaphore of the queue reaches the value of this submission
+		QueueTimeline &timeline = get_queue_timeline(queue);
+		signal_semaphores.push_back(timeline.semaphore);
+		signal_values.push_back(++timeline.value);
+		frame.add_timeline_signal(timeline.semaphore, timeline.value);
+
+		timeline_submit_info.waitSemaphoreValueCount   = to_u32(wait_values.size());
+		timeline_submit_info.pWaitSemaphoreValues      = wait_values.data();
+		timeline_submit_info.signalSemaphoreValueCount = to_u32(signal_values.size());
+		timeline_submit_info.pSignalSemaphoreValues    = signal_values.data();
+
+		submit_info.pNext = &timeline_submit_info;
+	}
+	else
+	{
+		fence = frame.request_fence();
+	}
 
-	VkFence fence = frame.request_fence();
+	submit_info.commandBufferCount   = to_u32(cmd_buf_handles.size());
+	submit_info.pCommandBuffers      = cmd_buf_handles.data();
+	submit_info.waitSemaphoreCount   = to_u32(wait_semaphores.size());
+	submit_info.pWaitSemaphores      = wait_semaphores.data();
+	submit_info.pWaitDstStageMask    = wait_stages.data();
+	submit_info.signalSemaphoreCount = to_u32(signal_semaphores.size());
+	submit_info.pSignalSemaphores    = signal_semaphores.data();
 
 	VK_CHECK(queue.submit({submit_info}, fence));
 }
@@ -426,7 +536,7 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 		present_info.pWaitSemaphores    = &semaphore;
 		present_info.swapchainCount     = 1;
 		present_info.pSwapchains        = &vk_swapchain;
-		present_info.pImageIndices      = &active_frame_index;
+		present_info.pImageIndices      = &active_image_index;
 
 		VkDisplayPresentInfoKHR disp_present_info{};
 		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
@@ -443,6 +553,18 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 			handle_surface_changes();
 		}
 	}
+	else if (semaphore != VK_NULL_HANDLE)
+	{
+		// Stands in for the present, which would have waited for the semaphore, so that it can be signaled again
+		VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		submit_info.waitSemaphoreCount = 1;
+		submit_info.pWaitSemaphores    = &semaphore;
+		submit_info.pWaitDstStageMask  = &wait_stage;
+
+		VK_CHECK(queue.submit({submit_info}, VK_NULL_HANDLE));
+	}
 
 	// Frame is not active anymore
 	if (acquired_semaphore)
@@ -456,6 +578,17 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 VkSemaphore RenderContext::consume_acquired_semaphore()
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
+
+	if (!swapchain && acquired_semaphore != VK_NULL_HANDLE)
+	{
+		// Stands in for the acquire, which would have signaled the semaphore
+		VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		submit_info.signalSemaphoreCount = 1;
+		submit_info.pSignalSemaphores    = &acquired_semaphore;
+
+		VK_CHECK(queue.submit({submit_info}, VK_NULL_HANDLE));
+	}
+
 	auto sem           = acquired_semaphore;
 	acquired_semaphore = VK_NULL_HANDLE;
 	return sem;
@@ -474,6 +607,12 @@ uint32_t RenderContext::get_active_frame_index()
 	return active_frame_index;
 }
 
+uint32_t RenderContext::get_active_image_index() const
+{
+	assert(frame_active && "Frame is not active, please call begin_frame");
+	return active_image_index;
+}
+
 RenderFrame &RenderContext::get_last_rendered_frame()
 {
 	assert(!frame_active && "Frame is still active, please call end_frame");
@@ -509,23 +648,8 @@ void RenderContext::recreate_swapchain()
 	device.wait_idle();
 	device.get_resource_cache().clear_framebuffers();
 
-	VkExtent2D swapchain_extent = swapchain->get_extent();
-	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
-
-	auto frame_it = frames.begin();
-
-	for (auto &image_handle : swapchain->get_images())
-	{
-		core::Image swapchain_image{device, image_handle,
-		                            extent,
-		                            swapchain->get_format(),
-		                            swapchain->get_usage()};
-
-		auto render_target = create_render_target_func(std::move(swapchain_image));
-		(*frame_it)->update_render_target(std::move(render_target));
-
-		++frame_it;
-	}
+	update_render_targets();
+	create_frames();
 }
 
 bool RenderContext::has_swapchain()
@@ -554,4 +678,41 @@ std::vector<std::unique_ptr<RenderFrame>> &RenderContext::get_render_frames()
 	return frames;
 }
 
+void RenderContext::update_render_targets()
+{
+	VkExtent2D swapchain_extent = swapchain->get_extent();
+	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
+
+	render_targets.clear();
+
+	for (auto &image_handle : swapchain->get_images())
+	{
+		core::Image swapchain_image{device, image_handle,
+		                            extent,
+		                            swapchain->get_format(),
+		                            swapchain->get_usage()};
+
+		render_targets.push_back(create_render_target_func(std::move(swapchain_image)));
+	}
+
+	image_frame_indices.assign(render_targets.size(), no_frame);
+}
+
+void RenderContext::create_frames()
+{
+	// Without a frame count, there is a frame per image, as samples may keep per-image resources sized by the frame count
+	size_t frame_count = frames_in_flight > 0 ? frames_in_flight : render_targets.size();
+
+	while (frames.size() < frame_count)
+	{
+		frames.emplace_back(std::make_unique<RenderFrame>(device, nullptr, thread_count));
+	}
+
+	// Until they acquire an image, frames render to the image of the same index, as expected by samples which don't call begin_frame
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		frames[i]->set_render_target(*render_targets[i % render_targets.size()]);
+	}
+}
+
 }        // namespace vkb
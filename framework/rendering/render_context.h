@@ -49,10 +49,16 @@ class Window;
  * It requires a Device to be valid on creation, and will take control of a given Swapchain.
  *
  * For normal rendering (using a swapchain), the RenderContext can be created by passing in a
- * swapchain. A RenderFrame will then be created for each Swapchain image.
+ * swapchain. A RenderTarget will then be created for each Swapchain image.
  *
  * For offscreen rendering (no swapchain), the RenderContext can be given a valid Device, and
- * a width and height. A single RenderFrame will then be created.
+ * a width and height. A ring of RenderTargets will then be created, which stand in for the
+ * swapchain images: they are used in turn without acquiring or presenting them, and frames are
+ * only paced by the fences or timeline semaphores of the RenderFrames.
+ *
+ * The RenderFrames are used in turn, and each one renders to the RenderTarget of the image it
+ * acquired. There is one RenderFrame per RenderTarget unless another number of frames in flight
+ * is set, which decouples how far the CPU can get ahead of the GPU from the swapchain image count.
  */
 class RenderContext
 {
@@ -82,7 +88,7 @@ class RenderContext
 
 	RenderContext(RenderContext &&) = delete;
 
-	virtual ~RenderContext() = default;
+	virtual ~RenderContext();
 
 	RenderContext &operator=(const RenderContext &) = delete;
 
@@ -95,6 +101,20 @@ class RenderContext
 	 */
 	void prepare(size_t thread_count = 1, RenderTarget::CreateFunc create_render_target_func = RenderTarget::DEFAULT_CREATE_FUNC);
 
+	/**
+	 * @brief Sets how many frames can be recorded before waiting for the GPU to complete the oldest one
+	 *        Each frame has its own command pools, buffer pools, descriptor sets and fences, while render targets stay per image.
+	 *        If the frames were prepared already, the device is waited for and they are created again, so per-frame resources
+	 *        sized with the number of render frames have to be resized.
+	 * @param count The number of frames in flight, 0 for one frame per swapchain image
+	 */
+	void set_frames_in_flight(uint32_t count);
+
+	/**
+	 * @return The number of frames which can be in flight
+	 */
+	uint32_t get_frames_in_flight() const;
+
 	/**
 	 * @brief Updates the swapchains extent, if a swapchain exists
 	 * @param extent The width and height of the new swapchain images
@@ -174,6 +194,20 @@ class RenderContext
 	 */
 	void submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers);
 
+	/**
+	 * @brief Makes the next submission wait for the work submitted to a queue so far
+	 *        Uses the timeline semaphore of the queue, so that work of async compute or transfer queues
+	 *        can be consumed without binary semaphores. Only available if timeline semaphores are enabled.
+	 * @param queue A queue work was submitted to through the RenderContext
+	 * @param wait_stage The pipeline stages of the next submission which wait for the work
+	 */
+	void wait_for_queue(const Queue &queue, VkPipelineStageFlags wait_stage);
+
+	/**
+	 * @return Whether the frames track the progress of the queues with timeline semaphores rather than with fences
+	 */
+	bool is_timeline_semaphore_enabled() const;
+
 	/**
 	 * @brief Waits a frame to finish its rendering
 	 */
@@ -195,6 +229,13 @@ class RenderContext
 	 */
 	uint32_t get_active_frame_index();
 
+	/**
+	 * @brief An error should be raised if the frame is not active.
+	 *        A frame is active after @ref begin_frame has been called.
+	 * @return The index of the swapchain image the active frame renders to, which is not related to the active frame index
+	 */
+	uint32_t get_active_image_index() const;
+
 	/**
 	 * @brief An error should be raised if a frame is active.
 	 *        A frame is active after @ref begin_frame has been called.
@@ -228,6 +269,7 @@ class RenderContext
 
 	/**
 	 * @brief Returns the WSI acquire semaphore. Only to be used in very special circumstances.
+	 *        Without a swapchain, the semaphore is signaled by an empty submission so that waiting for it doesn't block.
 	 * @return The WSI acquire semaphore.
 	 */
 	VkSemaphore consume_acquired_semaphore();
@@ -236,6 +278,26 @@ class RenderContext
 	VkExtent2D surface_extent;
 
   private:
+	static constexpr uint32_t no_frame = std::numeric_limits<uint32_t>::max();
+
+	/// Number of render targets created for offscreen rendering, as many images as a swapchain usually has
+	static constexpr uint32_t offscreen_image_count = 3;
+
+	/// Timeline semaphore of a queue and the last value signaled on it
+	struct QueueTimeline
+	{
+		VkSemaphore semaphore{VK_NULL_HANDLE};
+		uint64_t    value{0};
+	};
+
+	/// Timeline value of a queue the next submission waits for
+	struct TimelineWait
+	{
+		VkSemaphore          semaphore{VK_NULL_HANDLE};
+		uint64_t             value{0};
+		VkPipelineStageFlags stage{0};
+	};
+
 	Device &device;
 
 	const Window &window;
@@ -253,7 +315,7 @@ class RenderContext
 
 	bool prepared{false};
 
-	/// Current active frame index
+	/// Index of the active frame in the ring of frames
 	uint32_t active_frame_index{0};
 
 	/// Whether a frame is active or not
@@ -264,6 +326,51 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	/// Render targets of the swapchain images, or the offscreen render targets
+	std::vector<std::unique_ptr<RenderTarget>> render_targets;
+
+	/// Index of the frame which rendered to each image last
+	std::vector<uint32_t> image_frame_indices;
+
+	/// Number of frames requested with set_frames_in_flight, 0 for one per image
+	uint32_t frames_in_flight{0};
+
+	/// Index of the image the active frame renders to
+	uint32_t active_image_index{0};
+
+	/// Whether submissions signal the timeline semaphore of their queue instead of a fence
+	bool timeline_semaphore_enabled{false};
+
+	/// Timeline semaphores of the queues the frames were submitted to
+	std::unordered_map<VkQueue, QueueTimeline> queue_timelines;
+
+	/// Timeline values requested with wait_for_queue, waited for by the next submission
+	std::vector<TimelineWait> timeline_waits;
+
+	/**
+	 * @brief Creates a render target for each swapchain image
+	 */
+	void update_render_targets();
+
+	/**
+	 * @brief Creates the missing frames and points them at the render targets
+	 */
+	void create_frames();
+
+	/**
+	 * @brief Gets the timeline semaphore of a queue, creating it on first use
+	 */
+	QueueTimeline &get_queue_timeline(const Queue &queue);
+
+	/**
+	 * @brief Submits command buffers of the active frame, and retires them with the timeline semaphore of the queue or a fence of the frame
+	 */
+	void submit_to_queue(const Queue                        &queue,
+	                     const std::vector<CommandBuffer *> &command_buffers,
+	                     VkSemaphore                         wait_semaphore,
+	                     VkPipelineStageFlags                wait_pipeline_stage,
+	                     VkSemaphore                         signal_semaphore);
 };
 
 }        // namespace vkb
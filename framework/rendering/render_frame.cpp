@@ -26,15 +26,24 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
     device{device},
     fence_pool{device},
     semaphore_pool{device},
+    thread_count{thread_count},
     swapchain_render_target{std::move(render_target)},
-    thread_count{thread_count}
+    render_target{swapchain_render_target.get()},
+    gpu_profiler{device.get_gpu().get_handle(),
+                 device.get_handle(),
+                 device.get_suitable_graphics_queue().get_handle(),
+                 device.get_suitable_graphics_queue().get_family_index(),
+                 device.is_enabled(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) && device.get_gpu().get_properties().limits.timestampComputeAndGraphics}
 {
+	// Descriptors in descriptor buffers refer to buffers by their device address
+	VkBufferUsageFlags device_address_usage = device.is_descriptor_buffer_enabled() ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
+
 	for (auto &usage_it : supported_usage_map)
 	{
 		std::vector<std::pair<BufferPoolC, BufferBlockC *>> usage_buffer_pools;
 		for (size_t i = 0; i < thread_count; ++i)
 		{
-			usage_buffer_pools.push_back(std::make_pair(BufferPoolC{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first}, nullptr));
+			usage_buffer_pools.push_back(std::make_pair(BufferPoolC{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first | device_address_usage}, nullptr));
 		}
 
 		auto res_ins_it = buffer_pools.emplace(usage_it.first, std::move(usage_buffer_pools));
@@ -45,10 +54,25 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 		}
 	}
 
+	if (device.is_descriptor_buffer_enabled())
+	{
+		// A single buffer has to hold both resource and sampler descriptors, as only one is bound at a time
+		VkDeviceSize block_size = std::min<VkDeviceSize>(BUFFER_POOL_BLOCK_SIZE * 1024,
+		                                                 device.get_descriptor_buffer_properties().maxSamplerDescriptorBufferRange);
+
+		for (size_t i = 0; i < thread_count; ++i)
+		{
+			descriptor_buffer_pools.push_back(std::make_pair(BufferPoolC{device,
+			                                                             block_size,
+			                                                             VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT},
+			                                                 nullptr));
+		}
+	}
+
 	for (size_t i = 0; i < thread_count; ++i)
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
-		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorSet>>());
+		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, CachedDescriptorSet>>());
 	}
 }
 
@@ -60,11 +84,74 @@ Device &RenderFrame::get_device()
 void RenderFrame::update_render_target(std::unique_ptr<RenderTarget> &&render_target)
 {
 	swapchain_render_target = std::move(render_target);
+	this->render_target     = swapchain_render_target.get();
 }
 
-void RenderFrame::reset()
+void RenderFrame::set_render_target(RenderTarget &render_target)
 {
+	this->render_target = &render_target;
+}
+
+void RenderFrame::add_timeline_signal(VkSemaphore semaphore, uint64_t value)
+{
+	uint64_t &timeline_value = timeline_values[semaphore];
+	timeline_value           = std::max(timeline_value, value);
+}
+
+bool RenderFrame::is_complete() const
+{
+	for (auto &timeline_value : timeline_values)
+	{
+		uint64_t completed_value{0};
+		VK_CHECK(vkGetSemaphoreCounterValueKHR(device.get_handle(), timeline_value.first, &completed_value));
+
+		if (completed_value < timeline_value.second)
+		{
+			return false;
+		}
+	}
+
+	// Submissions which didn't go through the RenderContext may still use the fences of the frame
+	return fence_pool.wait(0) == VK_SUCCESS;
+}
+
+void RenderFrame::wait() const
+{
+	if (!timeline_values.empty())
+	{
+		std::vector<VkSemaphore> semaphores;
+		std::vector<uint64_t>    values;
+		semaphores.reserve(timeline_values.size());
+		values.reserve(timeline_values.size());
+
+		for (auto &timeline_value : timeline_values)
+		{
+			semaphores.push_back(timeline_value.first);
+			values.push_back(timeline_value.second);
+		}
+
+		VkSemaphoreWaitInfoKHR wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+		wait_info.semaphoreCount = to_u32(semaphores.size());
+		wait_info.pSemaphores    = semaphores.data();
+		wait_info.pValues        = values.data();
+
+		VK_CHECK(vkWaitSemaphoresKHR(device.get_handle(), &wait_info, std::numeric_limits<uint64_t>::max()));
+	}
+
 	VK_CHECK(fence_pool.wait());
+}
+
+void RenderFrame::reset()
+{
+	// Reclaiming a frame the GPU is done with doesn't block
+	if (!is_complete())
+	{
+		wait();
+	}
+
+	timeline_values.clear();
+
+	gpu_profiler.resolve();
 
 	fence_pool.reset();
 
@@ -85,12 +172,30 @@ void RenderFrame::reset()
 		}
 	}
 
+	for (auto &descriptor_buffer_pool : descriptor_buffer_pools)
+	{
+		descriptor_buffer_pool.first.reset();
+		descriptor_buffer_pool.second = nullptr;
+	}
+
 	semaphore_pool.reset();
 
+	++frame_index;
+
 	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
 	{
 		clear_descriptors();
 	}
+	else
+	{
+		evict_descriptor_sets();
+	}
+
+	descriptor_set_statistics.hits   = descriptor_set_hit_count.exchange(0);
+	descriptor_set_statistics.misses = descriptor_set_miss_count.exchange(0);
+
+	draw_statistics.visible_draws = visible_draw_count.exchange(0);
+	draw_statistics.culled_draws  = culled_draw_count.exchange(0);
 }
 
 std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
@@ -185,12 +290,14 @@ void RenderFrame::release_owned_semaphore(VkSemaphore semaphore)
 
 RenderTarget &RenderFrame::get_render_target()
 {
-	return *swapchain_render_target;
+	assert(render_target && "The frame has no render target");
+	return *render_target;
 }
 
 const RenderTarget &RenderFrame::get_render_target_const() const
 {
-	return *swapchain_render_target;
+	assert(render_target && "The frame has no render target");
+	return *render_target;
 }
 
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode, VkCommandBufferLevel level, size_t thread_index)
@@ -220,11 +327,19 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 			bindings_to_update = collect_bindings_to_update(descriptor_set_layout, buffer_infos, image_infos);
 		}
 
+		std::size_t hash{0U};
+		hash_param(hash, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+
 		// Request a descriptor set from the render frame, and write the buffer infos and image infos of all the specified bindings
-		assert(thread_index < descriptor_sets.size());
-		auto &descriptor_set = request_resource(device, nullptr, *descriptor_sets[thread_index], descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
-		descriptor_set.update(bindings_to_update);
-		return descriptor_set.get_handle();
+		auto *descriptor_set = find_descriptor_set(hash, thread_index);
+
+		if (descriptor_set == nullptr)
+		{
+			descriptor_set = &add_descriptor_set(hash, DescriptorSet{device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos}, thread_index);
+		}
+
+		descriptor_set->update(bindings_to_update);
+		return descriptor_set->get_handle();
 	}
 	else
 	{
@@ -235,13 +350,54 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	}
 }
 
+VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &descriptor_set_layout, const std::vector<DescriptorInfo> &descriptor_infos, size_t hash, bool update_after_bind, size_t thread_index)
+{
+	assert(thread_index < descriptor_sets.size() && "Thread index is out of bounds");
+
+	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache && !update_after_bind)
+	{
+		if (auto *descriptor_set = find_descriptor_set(hash, thread_index))
+		{
+			// All the bindings were written when the descriptor set was created
+			return descriptor_set->get_handle();
+		}
+	}
+
+	BindingMap<VkDescriptorBufferInfo> buffer_infos;
+	BindingMap<VkDescriptorImageInfo>  image_infos;
+
+	for (auto &descriptor_info : descriptor_infos)
+	{
+		if (descriptor_info.is_buffer)
+		{
+			buffer_infos[descriptor_info.binding][descriptor_info.array_element] = descriptor_info.buffer_info;
+		}
+		else
+		{
+			image_infos[descriptor_info.binding][descriptor_info.array_element] = descriptor_info.image_info;
+		}
+	}
+
+	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache && !update_after_bind)
+	{
+		auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+
+		auto &descriptor_set = add_descriptor_set(hash, DescriptorSet{device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos}, thread_index);
+		descriptor_set.update();
+
+		return descriptor_set.get_handle();
+	}
+
+	return request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, update_after_bind, thread_index);
+}
+
 void RenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
 	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
 	for (auto &descriptor_set_it : thread_descriptor_sets)
 	{
-		descriptor_set_it.second.update();
+		descriptor_set_it.second.descriptor_set.update();
 	}
 }
 
@@ -259,6 +415,86 @@ void RenderFrame::clear_descriptors()
 			desc_pool.second.reset();
 		}
 	}
+
+	descriptor_set_statistics.resident = 0;
+}
+
+void RenderFrame::set_descriptor_set_max_age(uint32_t max_age)
+{
+	descriptor_set_max_age = max_age;
+}
+
+const RenderFrame::DescriptorSetStatistics &RenderFrame::get_descriptor_set_statistics() const
+{
+	return descriptor_set_statistics;
+}
+
+GpuProfiler &RenderFrame::get_gpu_profiler()
+{
+	return gpu_profiler;
+}
+
+const GpuProfiler &RenderFrame::get_gpu_profiler() const
+{
+	return gpu_profiler;
+}
+
+DescriptorSet *RenderFrame::find_descriptor_set(std::size_t hash, size_t thread_index)
+{
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(hash);
+
+	if (descriptor_set_it == thread_descriptor_sets.end())
+	{
+		++descriptor_set_miss_count;
+		return nullptr;
+	}
+
+	++descriptor_set_hit_count;
+
+	descriptor_set_it->second.last_used_frame = frame_index;
+
+	return &descriptor_set_it->second.descriptor_set;
+}
+
+DescriptorSet &RenderFrame::add_descriptor_set(std::size_t hash, DescriptorSet &&descriptor_set, size_t thread_index)
+{
+	auto res_ins_it = descriptor_sets[thread_index]->emplace(hash, CachedDescriptorSet{std::move(descriptor_set), frame_index});
+
+	if (!res_ins_it.second)
+	{
+		throw std::runtime_error("Failed to insert descriptor set");
+	}
+
+	return res_ins_it.first->second.descriptor_set;
+}
+
+void RenderFrame::evict_descriptor_sets()
+{
+	uint32_t resident_count = 0;
+
+	for (auto &thread_descriptor_sets : descriptor_sets)
+	{
+		for (auto descriptor_set_it = thread_descriptor_sets->begin(); descriptor_set_it != thread_descriptor_sets->end();)
+		{
+			if (frame_index - descriptor_set_it->second.last_used_frame > descriptor_set_max_age)
+			{
+				// The fences of the frame were waited for, so the last command buffers using the descriptor set have completed
+				auto &descriptor_set = descriptor_set_it->second.descriptor_set;
+				descriptor_set.get_descriptor_pool().free(descriptor_set.get_handle());
+
+				descriptor_set_it = thread_descriptor_sets->erase(descriptor_set_it);
+			}
+			else
+			{
+				++resident_count;
+				++descriptor_set_it;
+			}
+		}
+	}
+
+	descriptor_set_statistics.resident = resident_count;
 }
 
 void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
@@ -298,4 +534,31 @@ BufferAllocationC RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, c
 
 	return buffer_block->allocate(to_u32(size));
 }
+
+BufferAllocationC RenderFrame::allocate_descriptor_buffer(VkDeviceSize size, size_t thread_index)
+{
+	assert(thread_index < descriptor_buffer_pools.size() && "Descriptor buffers are not enabled or the thread index is out of bounds");
+
+	auto &buffer_pool  = descriptor_buffer_pools[thread_index].first;
+	auto &buffer_block = descriptor_buffer_pools[thread_index].second;
+
+	// Unlike other buffers, descriptors always share blocks, as switching blocks means binding another descriptor buffer
+	if (!buffer_block || !buffer_block->can_allocate(size))
+	{
+		buffer_block = &buffer_pool.request_buffer_block(size);
+	}
+
+	return buffer_block->allocate(size);
+}
+
+void RenderFrame::add_draw_statistics(uint32_t visible_draws, uint32_t culled_draws)
+{
+	visible_draw_count += visible_draws;
+	culled_draw_count += culled_draws;
+}
+
+const RenderFrame::DrawStatistics &RenderFrame::get_draw_statistics() const
+{
+	return draw_statistics;
+}
 }        // namespace vkb
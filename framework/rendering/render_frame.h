@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "buffer_pool.h"
 #include "common/helpers.h"
 #include "common/resource_caching.h"
@@ -31,6 +33,7 @@
 #include "fence_pool.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
+#include "stats/gpu_profiler.h"
 
 namespace vkb
 {
@@ -98,12 +101,37 @@ class RenderFrame
 	VkSemaphore request_semaphore_with_ownership();
 	void        release_owned_semaphore(VkSemaphore semaphore);
 
+	/**
+	 * @brief Records a value a submission of the frame signals on the timeline semaphore of a queue
+	 *        The frame is complete once every timeline semaphore reached the last value recorded for it.
+	 * @param semaphore The timeline semaphore of the queue
+	 * @param value The value signaled by the submission
+	 */
+	void add_timeline_signal(VkSemaphore semaphore, uint64_t value);
+
+	/**
+	 * @brief Checks without blocking whether the GPU completed the submissions of the frame
+	 */
+	bool is_complete() const;
+
+	/**
+	 * @brief Waits for the GPU to complete the submissions of the frame, without resetting it
+	 */
+	void wait() const;
+
 	/**
 	 * @brief Called when the swapchain changes
 	 * @param render_target A new render target with updated images
 	 */
 	void update_render_target(std::unique_ptr<RenderTarget> &&render_target);
 
+	/**
+	 * @brief Renders the frame to a render target it doesn't own
+	 *        Used by the RenderContext to point the frame at the render target of the swapchain image it acquired.
+	 * @param render_target A render target which outlives its use by the frame
+	 */
+	void set_render_target(RenderTarget &render_target);
+
 	RenderTarget &get_render_target();
 
 	const RenderTarget &get_render_target_const() const;
@@ -129,8 +157,31 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Requests a descriptor set from a flat list of descriptor infos
+	 *        Descriptor sets found in the cache are returned without allocating, as the infos
+	 *        are only converted to binding maps when a descriptor set is created.
+	 * @param descriptor_set_layout The layout of the descriptor set
+	 * @param descriptor_infos The infos of the descriptor set, sorted by binding and array element
+	 * @param hash Hash of the layout and the infos, which identifies the descriptor set in the cache
+	 * @param update_after_bind Whether the bindings are updated after bind
+	 * @param thread_index Selects the thread's descriptor pools and cache
+	 */
+	VkDescriptorSet request_descriptor_set(const DescriptorSetLayout        &descriptor_set_layout,
+	                                       const std::vector<DescriptorInfo> &descriptor_infos,
+	                                       size_t                             hash,
+	                                       bool                               update_after_bind,
+	                                       size_t                             thread_index);
+
 	void clear_descriptors();
 
+	/**
+	 * @brief Sets how many times the frame can be reset before a cached descriptor set that it didn't use is freed
+	 *        Only applies to the StoreInCache strategy.
+	 * @param max_age The number of resets a descriptor set can stay unused for
+	 */
+	void set_descriptor_set_max_age(uint32_t max_age);
+
 	/**
 	 * @brief Sets a new buffer allocation strategy
 	 * @param new_strategy The new buffer allocation strategy
@@ -151,11 +202,69 @@ class RenderFrame
 	 */
 	BufferAllocationC allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief Allocates memory for descriptors in the host-visible descriptor buffer of the frame
+	 *        Only available if the device uses descriptor buffers. Allocations are taken from the current
+	 *        buffer for as long as it has room, so that command buffers rarely need to bind another one.
+	 * @param size Amount of memory required, a multiple of the descriptor buffer offset alignment
+	 * @param thread_index Index of the descriptor buffer to be used by the current thread
+	 * @return The requested allocation
+	 */
+	BufferAllocationC allocate_descriptor_buffer(VkDeviceSize size, size_t thread_index = 0);
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @brief Draw counters reported by the scene subpasses while recording the frame
+	 */
+	struct DrawStatistics
+	{
+		uint32_t visible_draws{0};
+
+		uint32_t culled_draws{0};
+	};
+
+	/**
+	 * @brief Accumulates the draw counters of a subpass, may be called from any recording thread
+	 *        Only draws culled on the CPU are counted, the visibility of indirect draws culled on the GPU is not known
+	 * @param visible_draws Number of draws that passed culling
+	 * @param culled_draws Number of draws that were rejected by culling
+	 */
+	void add_draw_statistics(uint32_t visible_draws, uint32_t culled_draws);
+
+	/**
+	 * @return The draw counters collected the last time this frame was recorded
+	 */
+	const DrawStatistics &get_draw_statistics() const;
+
+	/**
+	 * @brief Descriptor set cache counters of the frame
+	 */
+	struct DescriptorSetStatistics
+	{
+		/// Requests served by a cached descriptor set the last time this frame was recorded
+		uint32_t hits{0};
+
+		/// Requests which allocated a descriptor set the last time this frame was recorded
+		uint32_t misses{0};
+
+		/// Descriptor sets kept in the cache after the last eviction
+		uint32_t resident{0};
+	};
+
+	const DescriptorSetStatistics &get_descriptor_set_statistics() const;
+
+	/**
+	 * @brief Gets the profiler measuring the GPU time of the scopes recorded in the frame
+	 *        The timings are resolved when the frame is reset, once the GPU completed it.
+	 */
+	GpuProfiler &get_gpu_profiler();
+
+	const GpuProfiler &get_gpu_profiler() const;
+
   private:
 	Device &device;
 
@@ -174,8 +283,23 @@ class RenderFrame
 	/// Descriptor pools for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorPool>>> descriptor_pools;
 
+	/**
+	 * @brief A descriptor set of the cache, with the index of the last frame it was used in
+	 */
+	struct CachedDescriptorSet
+	{
+		DescriptorSet descriptor_set;
+
+		uint32_t last_used_frame;
+	};
+
 	/// Descriptor sets for the frame
-	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
+	std::vector<std::unique_ptr<std::unordered_map<std::size_t, CachedDescriptorSet>>> descriptor_sets;
+
+	/// Number of times the frame was reset, used to age the cached descriptor sets
+	uint32_t frame_index{0};
+
+	uint32_t descriptor_set_max_age{8};
 
 	FencePool fence_pool;
 
@@ -185,11 +309,46 @@ class RenderFrame
 
 	std::unique_ptr<RenderTarget> swapchain_render_target;
 
+	/// The render target the frame renders to, either the one it owns or one set by the RenderContext
+	RenderTarget *render_target{nullptr};
+
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPoolC, BufferBlockC *>>> buffer_pools;
 
+	/// Descriptor buffers of the frame by thread, only created if the device uses descriptor buffers
+	std::vector<std::pair<BufferPoolC, BufferBlockC *>> descriptor_buffer_pools;
+
+	/// Draw counters of the frame being recorded, collected into draw_statistics on reset
+	std::atomic<uint32_t> visible_draw_count{0};
+	std::atomic<uint32_t> culled_draw_count{0};
+
+	DrawStatistics draw_statistics{};
+
+	std::atomic<uint32_t> descriptor_set_hit_count{0};
+	std::atomic<uint32_t> descriptor_set_miss_count{0};
+
+	DescriptorSetStatistics descriptor_set_statistics{};
+
+	/// Last value signaled by the frame on the timeline semaphore of each queue it was submitted to
+	std::unordered_map<VkSemaphore, uint64_t> timeline_values;
+
+	GpuProfiler gpu_profiler;
+
+	/**
+	 * @brief Finds a cached descriptor set of a thread, and marks it as used by the frame
+	 * @return The descriptor set, or nullptr if it isn't cached
+	 */
+	DescriptorSet *find_descriptor_set(std::size_t hash, size_t thread_index);
+
+	DescriptorSet &add_descriptor_set(std::size_t hash, DescriptorSet &&descriptor_set, size_t thread_index);
+
+	/**
+	 * @brief Frees the cached descriptor sets which were not used for more than the max age
+	 */
+	void evict_descriptor_sets();
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
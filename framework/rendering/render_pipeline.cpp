@@ -96,6 +96,12 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		clear_value.push_back({0.0f, 0.0f, 0.0f, 1.0f});
 	}
 
+	// Record the work which has to happen outside of the render pass
+	for (auto &subpass : subpasses)
+	{
+		subpass->pre_draw(command_buffer);
+	}
+
 	for (size_t i = 0; i < subpasses.size(); ++i)
 	{
 		active_subpass_index = i;
@@ -118,6 +124,7 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 			subpass->set_debug_name(fmt::format("RP subpass #{}", i));
 		}
 		ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
+		ScopedGpuTimer   subpass_gpu_timer{command_buffer, subpass->get_debug_name().c_str()};
 
 		subpass->draw(command_buffer);
 	}
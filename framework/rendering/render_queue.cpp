@@ -0,0 +1,164 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Returns the bits of a float in an order preserving way for non-negative values
+ */
+inline uint32_t depth_bits(float depth)
+{
+	depth = std::max(depth, 0.0f);
+
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof(bits));
+	return bits;
+}
+
+/**
+ * @brief Returns a coarse depth bucket, each bucket covering twice the distance of the previous one
+ */
+inline uint32_t depth_bucket(float depth)
+{
+	int exponent = 0;
+	std::frexp(std::max(depth, 0.0f) + 1.0f, &exponent);
+	return static_cast<uint32_t>(std::min(exponent - 1, 15));
+}
+}        // namespace
+
+uint64_t RenderQueue::opaque_sort_key(uint32_t pipeline_id, uint32_t material_id, uint32_t mesh_id, float depth)
+{
+	return (static_cast<uint64_t>(pipeline_id & 0x3FF) << 54) |
+	       (static_cast<uint64_t>(depth_bucket(depth)) << 50) |
+	       (static_cast<uint64_t>(material_id & 0x3FFF) << 36) |
+	       (static_cast<uint64_t>(mesh_id & 0xFFFF) << 20) |
+	       static_cast<uint64_t>(depth_bits(depth) >> 12);
+}
+
+uint64_t RenderQueue::transparent_sort_key(uint32_t mesh_id, float depth)
+{
+	// Invert the depth so that the furthest draws come first
+	return (static_cast<uint64_t>(~depth_bits(depth)) << 32) | mesh_id;
+}
+
+void RenderQueue::clear()
+{
+	entries.clear();
+}
+
+void RenderQueue::reserve(size_t size)
+{
+	entries.reserve(size);
+}
+
+void RenderQueue::push(uint64_t sort_key, sg::Node &node, sg::SubMesh &sub_mesh)
+{
+	entries.push_back({sort_key, &node, &sub_mesh});
+}
+
+void RenderQueue::sort()
+{
+	if (entries.size() < 2)
+	{
+		return;
+	}
+
+	// Find which bytes differ between the keys, passes over constant bytes can be skipped
+	uint64_t first_key    = entries[0].sort_key;
+	uint64_t varying_bits = 0;
+	for (auto &entry : entries)
+	{
+		varying_bits |= entry.sort_key ^ first_key;
+	}
+
+	scratch.resize(entries.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		if (((varying_bits >> shift) & 0xFF) == 0)
+		{
+			continue;
+		}
+
+		std::array<size_t, 256> offsets{};
+
+		for (auto &entry : entries)
+		{
+			offsets[(entry.sort_key >> shift) & 0xFF]++;
+		}
+
+		size_t total = 0;
+		for (auto &offset : offsets)
+		{
+			size_t count = offset;
+			offset       = total;
+			total += count;
+		}
+
+		for (auto &entry : entries)
+		{
+			scratch[offsets[(entry.sort_key >> shift) & 0xFF]++] = entry;
+		}
+
+		entries.swap(scratch);
+	}
+}
+
+const std::vector<RenderQueue::Entry> &RenderQueue::get_entries() const
+{
+	return entries;
+}
+
+const RenderQueue::Entry &RenderQueue::operator[](size_t index) const
+{
+	return entries[index];
+}
+
+RenderQueue::Entry &RenderQueue::operator[](size_t index)
+{
+	return entries[index];
+}
+
+size_t RenderQueue::size() const
+{
+	return entries.size();
+}
+
+bool RenderQueue::empty() const
+{
+	return entries.empty();
+}
+
+std::vector<RenderQueue::Entry>::const_iterator RenderQueue::begin() const
+{
+	return entries.begin();
+}
+
+std::vector<RenderQueue::Entry>::const_iterator RenderQueue::end() const
+{
+	return entries.end();
+}
+}        // namespace vkb
@@ -0,0 +1,110 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class SubMesh;
+}        // namespace sg
+
+/**
+ * @brief A flat list of draws ordered by a 64-bit sort key
+ *
+ * The queue is meant to be kept alive across frames and cleared, not reallocated,
+ * so that once it has grown to the size of the scene recording it does not allocate.
+ * Keys are sorted with an LSD radix sort which skips the bytes shared by all keys.
+ */
+class RenderQueue
+{
+  public:
+	struct Entry
+	{
+		/// Value of uniform_offset for draws which were not given a slot
+		static constexpr uint64_t no_uniform_offset = ~0ull;
+
+		uint64_t sort_key;
+
+		sg::Node *node;
+
+		sg::SubMesh *sub_mesh;
+
+		/// Offset of the uniforms of the draw, assigned by the owner of the queue once it is sorted
+		uint64_t uniform_offset{no_uniform_offset};
+	};
+
+	/**
+	 * @brief Builds a key which groups opaque draws by pipeline, then by coarse depth, material and mesh,
+	 *        and orders draws sharing the same state front-to-back
+	 *        The depth buckets double in size with the distance, so that near occluders are drawn
+	 *        before the far geometry of every material while keeping most state changes grouped
+	 *        Ids are truncated to the bits available in the key
+	 * @param pipeline_id Id of the pipeline state (10 bits)
+	 * @param material_id Id of the material (14 bits)
+	 * @param mesh_id Id of the submesh (16 bits)
+	 * @param depth Non-negative distance from the camera (4 bits of bucket, 20 bits within the state)
+	 */
+	static uint64_t opaque_sort_key(uint32_t pipeline_id, uint32_t material_id, uint32_t mesh_id, float depth);
+
+	/**
+	 * @brief Builds a key which orders transparent draws back-to-front
+	 * @param mesh_id Id of the submesh, used to order draws at the same depth
+	 * @param depth Non-negative distance from the camera
+	 */
+	static uint64_t transparent_sort_key(uint32_t mesh_id, float depth);
+
+	/**
+	 * @brief Removes all the entries, keeping the allocated memory
+	 */
+	void clear();
+
+	void reserve(size_t size);
+
+	void push(uint64_t sort_key, sg::Node &node, sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Sorts the entries by increasing key
+	 */
+	void sort();
+
+	const std::vector<Entry> &get_entries() const;
+
+	const Entry &operator[](size_t index) const;
+
+	Entry &operator[](size_t index);
+
+	size_t size() const;
+
+	bool empty() const;
+
+	std::vector<Entry>::const_iterator begin() const;
+
+	std::vector<Entry>::const_iterator end() const;
+
+  private:
+	std::vector<Entry> entries;
+
+	/// Destination of the radix sort passes, persistent to avoid reallocations
+	std::vector<Entry> scratch;
+};
+}        // namespace vkb
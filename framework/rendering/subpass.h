@@ -110,6 +110,13 @@ class Subpass
 	 */
 	virtual void prepare() = 0;
 
+	/**
+	 * @brief Records the work the draws depend on which can't be recorded inside a render pass, such as compute dispatches
+	 *        This function is called by the RenderPipeline before beginning the render pass.
+	 * @param command_buffer Command buffer to use to record the commands
+	 */
+	virtual void pre_draw(CommandBufferType &command_buffer);
+
 	/**
 	 * @brief Prepares the lighting state to have its lights
 	 *
@@ -416,6 +423,10 @@ inline const ShaderSource &Subpass<bindingType>::get_fragment_shader() const
 	return fragment_shader;
 }
 
+template <vkb::BindingType bindingType>
+inline void Subpass<bindingType>::pre_draw(CommandBufferType &command_buffer)
+{}
+
 template <vkb::BindingType bindingType>
 inline void Subpass<bindingType>::set_color_resolve_attachments(std::vector<uint32_t> const &color_resolve)
 {
@@ -34,12 +34,10 @@ namespace vkb
 {
 ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera}
-{
-}
+{}
 
 void ForwardSubpass::prepare()
 {
-	auto &device = get_render_context().get_device();
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
@@ -50,11 +48,10 @@ void ForwardSubpass::prepare()
 			variant.add_definitions({"MAX_LIGHT_COUNT " + std::to_string(MAX_FORWARD_LIGHT_COUNT)});
 
 			variant.add_definitions(vkb::rendering::light_type_definitions);
-
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 		}
 	}
+
+	GeometrySubpass::prepare();
 }
 
 void ForwardSubpass::draw(CommandBuffer &command_buffer)
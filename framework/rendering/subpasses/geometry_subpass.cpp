@@ -16,6 +16,11 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -30,35 +35,140 @@
 
 namespace vkb
 {
+namespace
+{
+/**
+ * @brief Returns the id of a key, assigning the next free id the first time the key is seen
+ */
+template <typename T>
+inline uint32_t get_sort_id(std::unordered_map<T, uint32_t> &ids, const T &key)
+{
+	return ids.emplace(key, to_u32(ids.size())).first->second;
+}
+
+/**
+ * @brief Returns whether the transform of a node mirrors its geometry
+ */
+inline bool is_flipped(sg::Node &node)
+{
+	const auto &scale = node.get_transform().get_scale();
+	return scale.x * scale.y * scale.z < 0;
+}
+
+/**
+ * @brief Binding of the per-instance transforms in the INSTANCED shader variants
+ */
+constexpr uint32_t instance_data_binding = 7;
+}        // namespace
+
 GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     Subpass{render_context, std::move(vertex_source), std::move(fragment_source)},
     meshes{scene_.get_components<sg::Mesh>()},
     camera{camera},
     scene{scene_}
 {
+	bindless_supported = get_fragment_shader().get_source().find("BINDLESS") != std::string::npos;
+
+	if (default_draw_submission_mode != DrawSubmissionMode::Direct)
+	{
+		set_draw_submission_mode(default_draw_submission_mode);
+	}
+
+	// Subpasses whose fragment shader doesn't handle bindless materials keep binding textures without a warning
+	if (default_bindless_materials && bindless_supported)
+	{
+		set_bindless_materials(true);
+	}
+
+	// Dynamic uniform buffers can't be written to descriptor buffers, their pipeline layouts would fall back to descriptor sets
+	if (render_context.get_device().is_descriptor_buffer_enabled())
+	{
+		set_dynamic_uniforms(false);
+	}
 }
 
 void GeometrySubpass::prepare()
 {
-	// Build all shader variance upfront
-	auto &device = get_render_context().get_device();
+	// Build all shader variance upfront, compiling the distinct variants in parallel
+	std::vector<PipelineInfo>  pipelines;
+	std::unordered_set<size_t> variant_ids;
+
+	auto add_pipeline = [&](const ShaderVariant &variant) {
+		if (variant_ids.insert(variant.get_id()).second)
+		{
+			PipelineInfo pipeline;
+			pipeline.shader_modules = {{VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant},
+			                           {VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant}};
+			pipelines.push_back(std::move(pipeline));
+		}
+	};
+
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			add_pipeline(get_shader_variant(*sub_mesh));
+
+			if (instancing && mesh->get_nodes().size() > 1 && is_instancing_supported())
+			{
+				add_pipeline(get_instanced_variant(*sub_mesh));
+			}
 		}
 	}
+
+	// The indirect draw groups are drawn with the instanced variants
+	if (draw_submission_mode == DrawSubmissionMode::Indirect && indirect_scene)
+	{
+		for (auto &group : indirect_scene->get_draw_groups())
+		{
+			add_pipeline(get_instanced_variant(*group.sub_mesh));
+		}
+	}
+
+	// Same resource modes as prepare_pipeline_layout, so that the pipeline layouts built here are the ones used to draw
+	auto resource_modes = get_resource_mode_map();
+
+	if (dynamic_uniforms)
+	{
+		resource_modes.emplace("GlobalUniform", ShaderResourceMode::Dynamic);
+	}
+
+	if (bindless)
+	{
+		resource_modes.emplace(BindlessMaterials::textures_name, ShaderResourceMode::UpdateAfterBind);
+	}
+
+	get_render_context().get_device().get_resource_cache().prepare_pipelines(pipelines, resource_modes).get();
 }
 
-void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+void GeometrySubpass::get_sorted_nodes(RenderQueue &opaque_nodes, RenderQueue &transparent_nodes)
 {
+	opaque_nodes.clear();
+	transparent_nodes.clear();
+
 	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
 
+	auto projection = camera.get_projection();
+
+	Frustum frustum;
+	frustum.update(projection * camera.get_view());
+
+	uint32_t visible_draws = 0;
+	uint32_t culled_draws  = 0;
+
+	bool indirect = draw_submission_mode == DrawSubmissionMode::Indirect && indirect_scene;
+
 	for (auto &mesh : meshes)
 	{
+		// Submeshes drawn by the indirect scene are culled on the GPU
+		auto is_direct         = [&](const sg::SubMesh *sub_mesh) { return !indirect || !indirect_scene->contains(*sub_mesh); };
+		auto direct_sub_meshes = to_u32(std::count_if(mesh->get_submeshes().begin(), mesh->get_submeshes().end(), is_direct));
+
+		if (direct_sub_meshes == 0)
+		{
+			continue;
+		}
+
 		for (auto &node : mesh->get_nodes())
 		{
 			auto node_transform = node->get_transform().get_world_matrix();
@@ -68,47 +178,137 @@ void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *
 			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
 			world_bounds.transform(node_transform);
 
-			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+			glm::vec3 center   = world_bounds.is_empty() ? glm::vec3(node_transform[3]) : world_bounds.get_center();
+			float     distance = glm::length(glm::vec3(camera_transform[3]) - center);
+
+			// Reject the node before it reaches the sorted arrays
+			if (!is_visible(frustum, world_bounds, distance, projection[1][1]))
+			{
+				culled_draws += direct_sub_meshes;
+				continue;
+			}
+
+			visible_draws += direct_sub_meshes;
+
+			// Invert the front face if the mesh was flipped
+			bool flipped = is_flipped(*node);
 
 			for (auto &sub_mesh : mesh->get_submeshes())
 			{
+				if (!is_direct(sub_mesh))
+				{
+					continue;
+				}
+
+				uint32_t sub_mesh_id = get_sort_id<const sg::SubMesh *>(sub_mesh_ids, sub_mesh);
+
 				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
 				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					transparent_nodes.push(RenderQueue::transparent_sort_key(sub_mesh_id, distance), *node, *sub_mesh);
 				}
 				else
 				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					uint64_t sort_key = RenderQueue::opaque_sort_key(get_pipeline_id(*sub_mesh, flipped),
+					                                                 get_sort_id(material_ids, sub_mesh->get_material()),
+					                                                 sub_mesh_id,
+					                                                 distance);
+					opaque_nodes.push(sort_key, *node, *sub_mesh);
 				}
 			}
 		}
 	}
+
+	opaque_nodes.sort();
+	transparent_nodes.sort();
+
+	get_render_context().get_active_frame().add_draw_statistics(visible_draws, culled_draws);
+}
+
+uint32_t GeometrySubpass::get_pipeline_id(const sg::SubMesh &sub_mesh, bool flipped)
+{
+	size_t state_hash = get_shader_variant(sub_mesh).get_id();
+	hash_combine(state_hash, flipped);
+	hash_combine(state_hash, sub_mesh.get_material()->double_sided);
+
+	return get_sort_id(pipeline_ids, state_hash);
+}
+
+bool GeometrySubpass::is_visible(const Frustum &frustum, const sg::AABB &world_bounds, float distance, float projection_scale) const
+{
+	// Nodes without bounds can't be culled
+	if (world_bounds.is_empty())
+	{
+		return true;
+	}
+
+	if (frustum_culling && !frustum.check_aabb(world_bounds.get_min(), world_bounds.get_max()))
+	{
+		return false;
+	}
+
+	float radius = 0.5f * glm::length(world_bounds.get_scale());
+
+	if (max_draw_distance > 0.0f && distance - radius > max_draw_distance)
+	{
+		return false;
+	}
+
+	// Approximate the bounds with a sphere and compare its projected diameter to the viewport height
+	if (min_projected_size > 0.0f && distance > radius)
+	{
+		float projected_size = radius * glm::abs(projection_scale) / distance;
+
+		if (projected_size < min_projected_size)
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
 
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	get_sorted_nodes(opaque_queue, transparent_queue);
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+	update_uniforms(thread_index);
 
-	// Draw opaque objects in front-to-back order
+	// Draw opaque objects grouped by pipeline, then coarsely front-to-back and grouped by material
 	{
 		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		auto batch_it = instance_batches.begin();
+
+		for (size_t i = 0; i < opaque_queue.size();)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			auto &entry = opaque_queue[i];
+
+			bind_uniform(command_buffer, entry, thread_index);
 
 			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
-			bool        flipped    = scale.x * scale.y * scale.z < 0;
-			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			VkFrontFace front_face = is_flipped(*entry.node) ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+			if (batch_it != instance_batches.end() && batch_it->first_entry == i)
+			{
+				draw_submesh_instanced(command_buffer, *entry.sub_mesh, front_face, batch_it->first_instance, batch_it->instance_count);
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+				i += batch_it->instance_count;
+				++batch_it;
+			}
+			else
+			{
+				draw_submesh(command_buffer, *entry.sub_mesh, front_face);
+
+				++i;
+			}
 		}
 	}
 
+	if (draw_submission_mode == DrawSubmissionMode::Indirect && indirect_scene)
+	{
+		draw_indirect(command_buffer);
+	}
+
 	// Enable alpha blending
 	ColorBlendAttachmentState color_blend_attachment{};
 	color_blend_attachment.blend_enable           = VK_TRUE;
@@ -130,15 +330,189 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 	{
 		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+		for (auto &entry : transparent_queue)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			bind_uniform(command_buffer, entry, thread_index);
 
-			draw_submesh(command_buffer, *node_it->second.second);
+			draw_submesh(command_buffer, *entry.sub_mesh);
 		}
 	}
 }
 
+void GeometrySubpass::pre_draw(CommandBuffer &command_buffer)
+{
+	if (draw_submission_mode == DrawSubmissionMode::Indirect && indirect_scene)
+	{
+		indirect_scene->cull(command_buffer, get_render_context().get_active_frame(), camera.get_projection() * camera.get_view(), thread_index);
+	}
+}
+
+void GeometrySubpass::draw_indirect(CommandBuffer &command_buffer)
+{
+	auto &transforms = indirect_scene->get_transforms();
+	if (transforms.empty())
+	{
+		return;
+	}
+
+	ScopedDebugLabel indirect_debug_label{command_buffer, "Indirect objects"};
+
+	// The objects read their transform from the instance buffer, only the camera data of the global uniform is used
+	bind_uniform(command_buffer, RenderQueue::Entry{0, camera.get_node(), nullptr, indirect_uniform_offset}, thread_index);
+
+	auto &draw_groups = indirect_scene->get_draw_groups();
+
+	for (size_t i = 0; i < draw_groups.size(); ++i)
+	{
+		auto &group = draw_groups[i];
+
+		ScopedDebugLabel group_debug_label{command_buffer, group.sub_mesh->get_name().c_str()};
+
+		VkFrontFace front_face = group.flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+		auto &pipeline_layout = bind_submesh(command_buffer, *group.sub_mesh, get_instanced_variant(*group.sub_mesh), front_face);
+
+		// Replace the buffers of the submesh with the packed ones
+		indirect_scene->bind_vertex_buffers(command_buffer, pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT));
+
+		command_buffer.bind_buffer(transforms.get_buffer(), transforms.get_offset(), transforms.get_size(), 0, instance_data_binding, 0);
+
+		indirect_scene->draw(command_buffer, i);
+	}
+}
+
+void GeometrySubpass::update_uniforms(size_t thread_index)
+{
+	node_uniforms = {};
+
+	indirect_uniform_offset = RenderQueue::Entry::no_uniform_offset;
+
+	instance_batches.clear();
+	instance_transforms = {};
+
+	auto &device    = get_render_context().get_device();
+	auto  alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+
+	node_uniform_stride = (sizeof(GlobalUniform) + alignment - 1) & ~(alignment - 1);
+
+	// Each draw gets the slot following the ones of the previous draws, the indirect draws get the last one
+	bool   has_indirect_slot = draw_submission_mode == DrawSubmissionMode::Indirect && indirect_scene && indirect_scene->get_object_count() > 0;
+	size_t slot_count        = opaque_queue.size() + transparent_queue.size() + (has_indirect_slot ? 1 : 0);
+
+	if (slot_count == 0)
+	{
+		return;
+	}
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	node_uniforms = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, node_uniform_stride * slot_count, thread_index);
+
+	if (node_uniforms.empty())
+	{
+		// The draws fall back to allocating their uniforms one by one
+		for (auto *queue : {&opaque_queue, &transparent_queue})
+		{
+			for (size_t i = 0; i < queue->size(); ++i)
+			{
+				(*queue)[i].uniform_offset = RenderQueue::Entry::no_uniform_offset;
+			}
+		}
+
+		return;
+	}
+
+	GlobalUniform global_uniform;
+
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::rendering::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+
+	global_uniform.camera_position = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+	// Write straight into the mapped memory of the allocation, assigning the slots while walking the queues
+	uint8_t     *data   = node_uniforms.map();
+	VkDeviceSize offset = 0;
+
+	auto write_slot = [&](sg::Node &node) {
+		global_uniform.model = node.get_transform().get_world_matrix();
+
+		std::memcpy(data + offset, &global_uniform, sizeof(GlobalUniform));
+
+		offset += node_uniform_stride;
+
+		return offset - node_uniform_stride;
+	};
+
+	for (auto *queue : {&opaque_queue, &transparent_queue})
+	{
+		for (size_t i = 0; i < queue->size(); ++i)
+		{
+			auto &entry          = (*queue)[i];
+			entry.uniform_offset = write_slot(*entry.node);
+		}
+	}
+
+	// The indirect draws only read the camera data, they get a slot with the transform of the camera node
+	if (has_indirect_slot)
+	{
+		indirect_uniform_offset = write_slot(*camera.get_node());
+	}
+
+	node_uniforms.flush();
+
+	if (!instancing || !is_instancing_supported())
+	{
+		return;
+	}
+
+	// Within a depth bucket the opaque queue is sorted by state, so the draws of a submesh which can be merged are next to each other
+	uint32_t instance_count = 0;
+
+	for (size_t i = 0; i < opaque_queue.size();)
+	{
+		auto  &entry   = opaque_queue[i];
+		bool   flipped = is_flipped(*entry.node);
+		size_t end     = i + 1;
+
+		while (end < opaque_queue.size() && opaque_queue[end].sub_mesh == entry.sub_mesh && is_flipped(*opaque_queue[end].node) == flipped)
+		{
+			++end;
+		}
+
+		if (end - i > 1)
+		{
+			instance_batches.push_back({i, to_u32(end - i), instance_count});
+			instance_count += to_u32(end - i);
+		}
+
+		i = end;
+	}
+
+	if (instance_batches.empty())
+	{
+		return;
+	}
+
+	instance_transforms = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(glm::mat4) * instance_count, thread_index);
+
+	if (instance_transforms.empty())
+	{
+		instance_batches.clear();
+		return;
+	}
+
+	auto *transforms = reinterpret_cast<glm::mat4 *>(instance_transforms.map());
+
+	for (auto &batch : instance_batches)
+	{
+		for (uint32_t i = 0; i < batch.instance_count; ++i)
+		{
+			transforms[batch.first_instance + i] = opaque_queue[batch.first_entry + i].node->get_transform().get_world_matrix();
+		}
+	}
+
+	instance_transforms.flush();
+}
+
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
 {
 	GlobalUniform global_uniform;
@@ -160,20 +534,68 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
 
+void GeometrySubpass::bind_uniform(CommandBuffer &command_buffer, const RenderQueue::Entry &entry, size_t thread_index)
+{
+	if (entry.uniform_offset == RenderQueue::Entry::no_uniform_offset)
+	{
+		command_buffer.set_dynamic_offset(0, 1, 0);
+		update_uniform(command_buffer, *entry.node, thread_index);
+		return;
+	}
+
+	if (dynamic_uniforms)
+	{
+		// The binding stays the same between draws, only the dynamic offset changes, so the descriptor set is reused
+		command_buffer.bind_buffer(node_uniforms.get_buffer(), node_uniforms.get_offset(), sizeof(GlobalUniform), 0, 1, 0);
+		command_buffer.set_dynamic_offset(0, 1, to_u32(entry.uniform_offset));
+	}
+	else
+	{
+		command_buffer.bind_buffer(node_uniforms.get_buffer(), node_uniforms.get_offset() + entry.uniform_offset, sizeof(GlobalUniform), 0, 1, 0);
+	}
+}
+
 void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
 {
-	auto &device = command_buffer.get_device();
+	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
+
+	bind_submesh(command_buffer, sub_mesh, get_shader_variant(sub_mesh), front_face);
 
+	draw_submesh_command(command_buffer, sub_mesh);
+}
+
+void GeometrySubpass::draw_submesh_instanced(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, uint32_t first_instance, uint32_t instance_count)
+{
 	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
 
+	bind_submesh(command_buffer, sub_mesh, get_instanced_variant(sub_mesh), front_face);
+
+	command_buffer.bind_buffer(instance_transforms.get_buffer(), instance_transforms.get_offset(), instance_transforms.get_size(), 0, instance_data_binding, 0);
+
+	if (sub_mesh.vertex_indices != 0)
+	{
+		command_buffer.bind_index_buffer(*sub_mesh.get_index_buffer(), sub_mesh.index_offset, sub_mesh.index_type);
+
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, instance_count, 0, 0, first_instance);
+	}
+	else
+	{
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, 0, first_instance);
+	}
+}
+
+PipelineLayout &GeometrySubpass::bind_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const ShaderVariant &variant, VkFrontFace front_face)
+{
+	auto &device = command_buffer.get_device();
+
 	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
 
 	MultisampleState multisample_state{};
 	multisample_state.rasterization_samples = get_sample_count();
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
 
 	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
 
@@ -181,20 +603,38 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	if (bindless && pipeline_layout.has_descriptor_set_layout(BindlessMaterials::set_index))
 	{
-		prepare_push_constants(command_buffer, sub_mesh);
-	}
+		if (!bindless_materials)
+		{
+			bindless_materials = std::make_unique<BindlessMaterials>(device, scene, pipeline_layout.get_descriptor_set_layout(BindlessMaterials::set_index));
+		}
 
-	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+		// The textures and the parameters of the material are in the bindless set, which stays bound across materials
+		if (pipeline_layout.get_push_constant_range_stage(sizeof(uint32_t)) != 0)
+		{
+			command_buffer.push_constants(bindless_materials->get_material_index(*sub_mesh.get_material()));
+		}
 
-	for (auto &texture : sub_mesh.get_material()->textures)
+		command_buffer.bind_descriptor_set(BindlessMaterials::set_index, bindless_materials->get_descriptor_set());
+	}
+	else
 	{
-		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+		if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			prepare_push_constants(command_buffer, sub_mesh);
+		}
+
+		DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+
+		for (auto &texture : sub_mesh.get_material()->textures)
+		{
+			if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+			{
+				command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+				                          texture.second->get_sampler()->vk_sampler,
+				                          0, layout_binding->binding, 0);
+			}
 		}
 	}
 
@@ -229,21 +669,98 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	command_buffer.set_vertex_input_state(vertex_input_state);
 
 	// Find submesh vertex buffers matching the shader input attribute names
+	// Submeshes suballocated from the same buffers only differ by the offsets of their vertices
 	for (auto &input_resource : vertex_input_resources)
 	{
-		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
+		sg::VertexAttribute attribute;
 
-		if (buffer_iter != sub_mesh.vertex_buffers.end())
+		auto *vertex_buffer = sub_mesh.get_vertex_buffer(input_resource.name);
+
+		if (vertex_buffer && sub_mesh.get_attribute(input_resource.name, attribute))
 		{
 			std::vector<std::reference_wrapper<const vkb::core::BufferC>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
+			buffers.emplace_back(std::ref(*vertex_buffer));
 
 			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {attribute.buffer_offset});
 		}
 	}
 
-	draw_submesh_command(command_buffer, sub_mesh);
+	return pipeline_layout;
+}
+
+const ShaderVariant &GeometrySubpass::get_shader_variant(const sg::SubMesh &sub_mesh)
+{
+	if (!bindless)
+	{
+		return sub_mesh.get_shader_variant();
+	}
+
+	auto &bindless_variant = bindless_variants[&sub_mesh];
+
+	if (bindless_variant.get_processes().empty())
+	{
+		for (auto &attribute : sub_mesh.get_attributes())
+		{
+			std::string attrib_name = attribute.first;
+			std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::toupper);
+			bindless_variant.add_define("HAS_" + attrib_name);
+		}
+
+		bindless_variant.add_define("BINDLESS");
+	}
+
+	return bindless_variant;
+}
+
+const ShaderVariant &GeometrySubpass::get_instanced_variant(const sg::SubMesh &sub_mesh)
+{
+	auto &instanced_variant = instanced_variants[&sub_mesh];
+
+	const auto &variant = get_shader_variant(sub_mesh);
+
+	// Rebuild the variant if the definitions of the submesh changed since it was derived
+	if (instanced_variant.first != variant.get_id() || instanced_variant.second.get_processes().empty())
+	{
+		instanced_variant.first  = variant.get_id();
+		instanced_variant.second = variant;
+		instanced_variant.second.add_define("INSTANCED");
+	}
+
+	return instanced_variant.second;
+}
+
+bool GeometrySubpass::is_instancing_supported()
+{
+	if (instancing_supported.has_value())
+	{
+		return *instancing_supported;
+	}
+
+	instancing_supported = false;
+
+	for (auto &mesh : meshes)
+	{
+		if (mesh->get_submeshes().empty())
+		{
+			continue;
+		}
+
+		// Shaders which ignore the define compile to the same resources as the regular variant
+		auto &shader_module = get_render_context().get_device().get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT,
+		                                                                                                      get_vertex_shader(),
+		                                                                                                      get_instanced_variant(*mesh->get_submeshes().front()));
+
+		const auto &resources = shader_module.get_resources();
+
+		instancing_supported = std::any_of(resources.begin(), resources.end(), [](const ShaderResource &resource) {
+			return resource.type == ShaderResourceType::BufferStorage && resource.set == 0 && resource.binding == instance_data_binding;
+		});
+
+		break;
+	}
+
+	return *instancing_supported;
 }
 
 void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
@@ -268,6 +785,24 @@ PipelineLayout &GeometrySubpass::prepare_pipeline_layout(CommandBuffer &command_
 	// Sets any specified resource modes
 	for (auto &shader_module : shader_modules)
 	{
+		const auto &resources = shader_module->get_resources();
+
+		auto has_resource = [&resources](const std::string &name) {
+			return std::any_of(resources.begin(), resources.end(), [&name](const ShaderResource &resource) { return resource.name == name; });
+		};
+
+		// The per-node uniforms are packed in one buffer and selected with a dynamic offset
+		if (dynamic_uniforms && has_resource("GlobalUniform"))
+		{
+			shader_module->set_resource_mode("GlobalUniform", ShaderResourceMode::Dynamic);
+		}
+
+		// Textures can be registered to the bindless set while frames using it are in flight
+		if (bindless && has_resource(BindlessMaterials::textures_name))
+		{
+			shader_module->set_resource_mode(BindlessMaterials::textures_name, ShaderResourceMode::UpdateAfterBind);
+		}
+
 		for (auto &resource_mode : get_resource_mode_map())
 		{
 			shader_module->set_resource_mode(resource_mode.first, resource_mode.second);
@@ -300,7 +835,7 @@ void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::Su
 	if (sub_mesh.vertex_indices != 0)
 	{
 		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		command_buffer.bind_index_buffer(*sub_mesh.get_index_buffer(), sub_mesh.index_offset, sub_mesh.index_type);
 
 		// Draw submesh using indexed data
 		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
@@ -316,4 +851,102 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_frustum_culling(bool enable)
+{
+	frustum_culling = enable;
+}
+
+void GeometrySubpass::set_max_draw_distance(float distance)
+{
+	max_draw_distance = distance;
+}
+
+void GeometrySubpass::set_min_projected_size(float size)
+{
+	min_projected_size = size;
+}
+
+void GeometrySubpass::set_instancing(bool enable)
+{
+	instancing = enable;
+}
+
+void GeometrySubpass::set_dynamic_uniforms(bool enable)
+{
+	dynamic_uniforms = enable;
+}
+
+void GeometrySubpass::set_draw_submission_mode(DrawSubmissionMode mode)
+{
+	auto &device = get_render_context().get_device();
+
+	if (mode == DrawSubmissionMode::Indirect)
+	{
+		if (!IndirectScene::is_supported(device))
+		{
+			LOGW("Indirect draws need the multiDrawIndirect and drawIndirectFirstInstance features, drawing directly");
+			return;
+		}
+
+		if (!is_instancing_supported())
+		{
+			LOGW("The vertex shader '{}' doesn't handle the INSTANCED define, drawing directly", get_vertex_shader().get_filename());
+			return;
+		}
+
+		if (!indirect_scene)
+		{
+			indirect_scene = std::make_unique<IndirectScene>(device, meshes);
+		}
+	}
+
+	draw_submission_mode = mode;
+}
+
+void GeometrySubpass::set_default_draw_submission_mode(DrawSubmissionMode mode)
+{
+	default_draw_submission_mode = mode;
+}
+
+DrawSubmissionMode GeometrySubpass::get_default_draw_submission_mode()
+{
+	return default_draw_submission_mode;
+}
+
+void GeometrySubpass::set_bindless_materials(bool enable)
+{
+	if (enable)
+	{
+		if (!BindlessMaterials::is_supported(get_render_context().get_device()))
+		{
+			LOGW("Bindless materials need VK_EXT_descriptor_indexing and the features requested by BindlessMaterials, binding textures per material");
+			return;
+		}
+
+		if (!bindless_supported)
+		{
+			LOGW("The fragment shader '{}' doesn't handle the BINDLESS define, binding textures per material", get_fragment_shader().get_filename());
+			return;
+		}
+
+		if (!scene.has_component<sg::Texture>())
+		{
+			LOGW("The scene has no textures, binding textures per material");
+			return;
+		}
+	}
+
+	bindless = enable;
+}
+
+void GeometrySubpass::set_default_bindless_materials(bool enable)
+{
+	default_bindless_materials = enable;
+}
+
+bool GeometrySubpass::get_default_bindless_materials()
+{
+	return default_bindless_materials;
+}
 }        // namespace vkb
@@ -17,10 +17,16 @@
 
 #pragma once
 
+#include <optional>
+
 #include "common/error.h"
 
 #include "common/glm_common.h"
 
+#include "geometry/frustum.h"
+#include "rendering/bindless_materials.h"
+#include "rendering/indirect_scene.h"
+#include "rendering/render_queue.h"
 #include "rendering/subpass.h"
 
 namespace vkb
@@ -32,6 +38,8 @@ class Node;
 class Mesh;
 class SubMesh;
 class Camera;
+class AABB;
+class Material;
 }        // namespace sg
 
 /**
@@ -58,6 +66,18 @@ struct PBRMaterialUniform
 	float roughness_factor;
 };
 
+/**
+ * @brief How the draws of the opaque objects of a scene are submitted
+ */
+enum class DrawSubmissionMode
+{
+	/// Culled, sorted and recorded one draw at a time on the CPU
+	Direct,
+
+	/// Culled by a compute shader which writes indirect draws, see IndirectScene
+	Indirect
+};
+
 /**
  * @brief This subpass is responsible for rendering a Scene
  */
@@ -83,16 +103,150 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
 
+	/**
+	 * @brief Records the culling of the objects drawn indirectly
+	 */
+	virtual void pre_draw(CommandBuffer &command_buffer) override;
+
 	/**
 	 * @brief Thread index to use for allocating resources
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Enables or disables culling of the nodes outside of the camera frustum
+	 */
+	void set_frustum_culling(bool enable);
+
+	/**
+	 * @brief Culls the nodes whose bounds are further away from the camera than a distance
+	 * @param distance Maximum draw distance in world units, 0 disables the cutoff
+	 */
+	void set_max_draw_distance(float distance);
+
+	/**
+	 * @brief Culls the nodes whose bounds project to less than a fraction of the viewport height
+	 * @param size Minimum projected size in the range [0, 1], 0 disables the cutoff
+	 */
+	void set_min_projected_size(float size);
+
+	/**
+	 * @brief Enables or disables merging the draws of nodes sharing a submesh into instanced draws
+	 *        Only takes effect if the vertex shader handles the INSTANCED define
+	 */
+	void set_instancing(bool enable);
+
+	/**
+	 * @brief Declares the GlobalUniform of the shaders as a dynamic uniform buffer, so that the draws bind the
+	 *        uniform buffer once and only change its dynamic offset, reusing the descriptor set
+	 *        On by default, unless descriptor buffers are enabled, as they can't hold dynamic uniform buffers.
+	 *        Subclasses overriding prepare_pipeline_layout have to declare their GlobalUniform dynamic
+	 *        or turn this off. When it is off, each draw binds its slot and looks up a descriptor set.
+	 */
+	void set_dynamic_uniforms(bool enable);
+
+	/**
+	 * @brief Selects how the opaque objects are submitted
+	 *        The indirect mode packs the geometry of the scene the first time it is selected. It needs the features
+	 *        requested by IndirectScene::request_gpu_features and a vertex shader handling the INSTANCED define,
+	 *        otherwise the subpass keeps drawing directly.
+	 */
+	void set_draw_submission_mode(DrawSubmissionMode mode);
+
+	/**
+	 * @brief Sets the submission mode which the subpasses constructed afterwards select, as selected with --draw-mode
+	 *        VulkanSample requests the features of the indirect mode when creating its device if it is the default
+	 */
+	static void set_default_draw_submission_mode(DrawSubmissionMode mode);
+
+	static DrawSubmissionMode get_default_draw_submission_mode();
+
+	/**
+	 * @brief Enables or disables reading the textures and the parameters of the materials from a bindless set,
+	 *        so that the draws only select their material with a push constant, see BindlessMaterials
+	 *        It needs the features requested by BindlessMaterials::request_gpu_features, a scene with textures
+	 *        and a fragment shader handling the BINDLESS define, otherwise the subpass keeps binding the textures
+	 *        of each material.
+	 */
+	void set_bindless_materials(bool enable);
+
+	/**
+	 * @brief Sets whether the subpasses constructed afterwards use bindless materials when their fragment shader
+	 *        handles them, as selected with --bindless-materials
+	 *        VulkanSample requests the features of BindlessMaterials when creating its device if it is set
+	 */
+	static void set_default_bindless_materials(bool enable);
+
+	static bool get_default_bindless_materials();
+
   protected:
+	/**
+	 * @brief A run of opaque draws of the same submesh, recorded as a single instanced draw
+	 */
+	struct InstanceBatch
+	{
+		/// Index of the first draw of the run in the opaque queue
+		size_t first_entry;
+
+		uint32_t instance_count;
+
+		/// Index of the transform of the first instance in the instance buffer
+		uint32_t first_instance;
+	};
+
+	/**
+	 * @brief Writes the uniforms of every node in the draw queues into a single frame allocation
+	 *        Each node gets an aligned slot, whose offset is stored on the queue entries drawing it
+	 *        The transforms of the instance batches are written to a storage buffer
+	 */
+	virtual void update_uniforms(size_t thread_index);
+
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Binds the slot of a queue entry in the uniforms written by update_uniforms
+	 *        Entries without a slot fall back to update_uniform with their node
+	 */
+	void bind_uniform(CommandBuffer &command_buffer, const RenderQueue::Entry &entry, size_t thread_index);
+
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
+	/**
+	 * @brief Draws several instances of a submesh with the INSTANCED shader variant
+	 * @param first_instance Index of the transform of the first instance in the instance buffer
+	 * @param instance_count Number of instances to draw
+	 */
+	void draw_submesh_instanced(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face, uint32_t first_instance, uint32_t instance_count);
+
+	/**
+	 * @brief Records the indirect draws of the objects culled on the GPU
+	 */
+	void draw_indirect(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Sets up the pipeline state, shaders and resources to draw a submesh with a shader variant
+	 * @return The pipeline layout the submesh is drawn with
+	 */
+	PipelineLayout &bind_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const ShaderVariant &variant, VkFrontFace front_face);
+
+	/**
+	 * @brief Returns the shader variant a submesh is drawn with
+	 *        With bindless materials the textures are not part of the variant, so submeshes with the same
+	 *        vertex attributes share their pipelines whatever their materials.
+	 */
+	const ShaderVariant &get_shader_variant(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Returns the shader variant of a submesh with the INSTANCED define added
+	 */
+	const ShaderVariant &get_instanced_variant(const sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Returns whether the vertex shader reads its transforms from the instance buffer when INSTANCED is defined
+	 *        The reflection of the instanced variant of the first submesh is checked for the buffer the first time
+	 */
+	bool is_instancing_supported();
+
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
 	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules);
@@ -102,11 +256,28 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
 	/**
-	 * @brief Sorts objects based on distance from camera and classifies them
-	 *        into opaque and transparent in the arrays provided
+	 * @brief Classifies visible objects into opaque and transparent in the queues provided, and sorts them
+	 *        Opaque objects are grouped by state and then ordered front-to-back,
+	 *        transparent objects are ordered back-to-front
+	 *        The number of culled and visible draws is reported to the active frame
+	 *        Objects drawn indirectly are culled on the GPU, their visibility is not read back so they are not counted
+	 */
+	void get_sorted_nodes(RenderQueue &opaque_nodes, RenderQueue &transparent_nodes);
+
+	/**
+	 * @brief Returns a small id identifying the pipeline state a submesh will be drawn with
 	 */
-	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
-	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
+	uint32_t get_pipeline_id(const sg::SubMesh &sub_mesh, bool flipped);
+
+	/**
+	 * @brief Tests the world space bounds of a node against the culling settings of the subpass
+	 * @param frustum The camera frustum
+	 * @param world_bounds The bounds of the node in world space
+	 * @param distance Distance from the camera to the center of the bounds
+	 * @param projection_scale Vertical scale factor of the camera projection
+	 * @return True if the node needs to be drawn
+	 */
+	bool is_visible(const Frustum &frustum, const sg::AABB &world_bounds, float distance, float projection_scale) const;
 
 	sg::Camera &camera;
 
@@ -117,6 +288,64 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	/// Draw queues, kept across frames to reuse their memory
+	RenderQueue opaque_queue;
+	RenderQueue transparent_queue;
+
+	/// Ids used to build the sort keys of the draws
+	std::unordered_map<const sg::SubMesh *, uint32_t> sub_mesh_ids;
+	std::unordered_map<const sg::Material *, uint32_t> material_ids;
+	std::unordered_map<size_t, uint32_t>               pipeline_ids;
+
+	/// Uniforms of the nodes drawn this frame, written once per draw by update_uniforms at the offsets of the queue entries
+	BufferAllocationC node_uniforms;
+	VkDeviceSize      node_uniform_stride{0};
+
+	bool dynamic_uniforms{true};
+
+	/// Instanced draws of the current frame and the transforms of their instances
+	std::vector<InstanceBatch> instance_batches;
+	BufferAllocationC          instance_transforms;
+
+	/// Instanced variants of the submeshes, with the id of the variant they were derived from
+	std::unordered_map<const sg::SubMesh *, std::pair<size_t, ShaderVariant>> instanced_variants;
+
+	bool instancing{true};
+
+	/// Whether the vertex shader reads its transforms from the instance buffer when INSTANCED is defined
+	std::optional<bool> instancing_supported;
+
+	DrawSubmissionMode draw_submission_mode{DrawSubmissionMode::Direct};
+
+	/// Packed geometry of the scene, created when the indirect mode is first selected
+	std::unique_ptr<IndirectScene> indirect_scene;
+
+	/// Slot of the camera data read by the indirect draws in the node uniforms
+	uint64_t indirect_uniform_offset{RenderQueue::Entry::no_uniform_offset};
+
+	bool bindless{false};
+
+	/// Whether the fragment shader reads the materials from the bindless set when BINDLESS is defined
+	bool bindless_supported{false};
+
+	/// Bindless variants of the submeshes, which only define the vertex attributes
+	std::unordered_map<const sg::SubMesh *, ShaderVariant> bindless_variants;
+
+	/// Textures and materials of the scene, created with the layout of the first pipeline drawn with them
+	std::unique_ptr<BindlessMaterials> bindless_materials;
+
+	bool frustum_culling{true};
+
+	float max_draw_distance{0.0f};
+
+	float min_projected_size{0.0f};
+
+	/** @brief Submission mode selected by new subpasses, static so it can be changed from a plugin */
+	inline static DrawSubmissionMode default_draw_submission_mode{DrawSubmissionMode::Direct};
+
+	/** @brief Whether new subpasses use bindless materials, static so it can be changed from a plugin */
+	inline static bool default_bindless_materials{false};
 };
 
 }        // namespace vkb
@@ -17,13 +17,18 @@
 
 #include "resource_binding_state.h"
 
+#include "common/helpers.h"
+
 namespace vkb
 {
 void ResourceBindingState::reset()
 {
 	clear_dirty();
 
-	resource_sets.clear();
+	for (auto &resource_set : resource_sets)
+	{
+		resource_set.reset();
+	}
 }
 
 bool ResourceBindingState::is_dirty()
@@ -38,42 +43,56 @@ void ResourceBindingState::clear_dirty()
 
 void ResourceBindingState::clear_dirty(uint32_t set)
 {
-	resource_sets[set].clear_dirty();
+	get_resource_set(set).clear_dirty();
 }
 
 void ResourceBindingState::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
+	auto &resource_set = get_resource_set(set);
+	resource_set.bind_buffer(buffer, offset, range, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, sampler, binding, array_element);
+	auto &resource_set = get_resource_set(set);
+	resource_set.bind_image(image_view, sampler, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, binding, array_element);
+	auto &resource_set = get_resource_set(set);
+	resource_set.bind_image(image_view, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_input(image_view, binding, array_element);
+	auto &resource_set = get_resource_set(set);
+	resource_set.bind_input(image_view, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
-const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resource_sets()
+const std::vector<ResourceSet> &ResourceBindingState::get_resource_sets()
 {
 	return resource_sets;
 }
 
+ResourceSet &ResourceBindingState::get_resource_set(uint32_t set)
+{
+	if (set >= resource_sets.size())
+	{
+		resource_sets.resize(set + 1);
+	}
+
+	return resource_sets[set];
+}
+
 void ResourceSet::reset()
 {
 	clear_dirty();
@@ -86,6 +105,11 @@ bool ResourceSet::is_dirty() const
 	return dirty;
 }
 
+bool ResourceSet::is_empty() const
+{
+	return resource_bindings.empty();
+}
+
 void ResourceSet::clear_dirty()
 {
 	dirty = false;
@@ -93,48 +117,119 @@ void ResourceSet::clear_dirty()
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	get_resource_binding(binding, array_element).info.dirty = false;
 }
 
 void ResourceSet::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+	auto &resource_info    = resource_binding.info;
+
+	// Binding the same range again leaves the descriptor set as it is
+	if (resource_info.buffer == &buffer && resource_info.offset == offset && resource_info.range == range)
+	{
+		return;
+	}
+
+	resource_info.dirty  = true;
+	resource_info.buffer = &buffer;
+	resource_info.offset = offset;
+	resource_info.range  = range;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+	auto &resource_info    = resource_binding.info;
+
+	if (resource_info.image_view == &image_view && resource_info.sampler == &sampler)
+	{
+		return;
+	}
+
+	resource_info.dirty      = true;
+	resource_info.image_view = &image_view;
+	resource_info.sampler    = &sampler;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+	auto &resource_info    = resource_binding.info;
+
+	if (resource_info.image_view == &image_view && resource_info.sampler == nullptr)
+	{
+		return;
+	}
+
+	resource_info.dirty      = true;
+	resource_info.image_view = &image_view;
+	resource_info.sampler    = nullptr;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource_binding = get_resource_binding(binding, array_element);
+	auto &resource_info    = resource_binding.info;
+
+	if (resource_info.image_view == &image_view)
+	{
+		return;
+	}
+
+	resource_info.dirty      = true;
+	resource_info.image_view = &image_view;
+
+	update_hash(resource_binding);
 
 	dirty = true;
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+const std::vector<ResourceBinding> &ResourceSet::get_resource_bindings() const
+{
+	return resource_bindings.get_elements();
+}
+
+size_t ResourceSet::get_hash() const
+{
+	return resource_bindings.get_hash();
+}
+
+ResourceBinding &ResourceSet::get_resource_binding(uint32_t binding, uint32_t array_element)
+{
+	return resource_bindings.get(binding, array_element);
+}
+
+void ResourceSet::update_hash(ResourceBinding &resource_binding)
 {
-	return resource_bindings;
+	auto &resource_info = resource_binding.info;
+
+	// The handles are hashed rather than the objects, as the descriptors refer to them
+	size_t hash{0U};
+	hash_combine(hash, resource_binding.binding);
+	hash_combine(hash, resource_binding.array_element);
+	hash_combine(hash, resource_info.buffer ? resource_info.buffer->get_handle() : VK_NULL_HANDLE);
+	hash_combine(hash, resource_info.range);
+	hash_combine(hash, resource_info.image_view ? resource_info.image_view->get_handle() : VK_NULL_HANDLE);
+	hash_combine(hash, resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE);
+
+	resource_binding.dynamic_hash = hash;
+
+	hash_combine(hash, resource_info.offset);
+
+	resource_bindings.set_hash(resource_binding, hash);
 }
 
 }        // namespace vkb
@@ -21,6 +21,7 @@
 #include "core/buffer.h"
 #include "core/image_view.h"
 #include "core/sampler.h"
+#include "core/util/flat_binding_map.hpp"
 
 namespace vkb
 {
@@ -44,11 +45,32 @@ struct ResourceInfo
 	const core::Sampler *sampler{nullptr};
 };
 
+/**
+ * @brief A resource bound to an array element of a binding
+ */
+struct ResourceBinding
+{
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
+
+	ResourceInfo info;
+
+	/// Hash of the bound resource, kept up to date by the resource set
+	size_t hash{0};
+
+	/// Hash of the bound resource without its offset, which a dynamic descriptor leaves to the dynamic offset
+	size_t dynamic_hash{0};
+};
+
 /**
  * @brief A resource set is a set of bindings containing resources that were bound
  *        by a command buffer.
  *
  * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * The bindings are stored flat and keep their storage when the set is reset,
+ * so that binding resources doesn't allocate once a command buffer has been recorded.
+ * The hash of the bound resources is updated as they are bound, rather than rebuilt when the set is flushed.
  */
 class ResourceSet
 {
@@ -57,6 +79,8 @@ class ResourceSet
 
 	bool is_dirty() const;
 
+	bool is_empty() const;
+
 	void clear_dirty();
 
 	void clear_dirty(uint32_t binding, uint32_t array_element);
@@ -69,12 +93,24 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	/**
+	 * @return The bound resources, sorted by binding and array element
+	 */
+	const std::vector<ResourceBinding> &get_resource_bindings() const;
+
+	/**
+	 * @return The hash of the bound resources, which doesn't depend on the order in which they were bound
+	 */
+	size_t get_hash() const;
 
   private:
 	bool dirty{false};
 
-	BindingMap<ResourceInfo> resource_bindings;
+	FlatBindingMap<ResourceBinding> resource_bindings;
+
+	ResourceBinding &get_resource_binding(uint32_t binding, uint32_t array_element);
+
+	void update_hash(ResourceBinding &resource_binding);
 };
 
 /**
@@ -102,11 +138,17 @@ class ResourceBindingState
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
-	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
+	/**
+	 * @return The resource sets, indexed by set index
+	 */
+	const std::vector<ResourceSet> &get_resource_sets();
 
   private:
 	bool dirty{false};
 
-	std::unordered_map<uint32_t, ResourceSet> resource_sets;
+	/// Resource sets by set index, which are reset rather than destroyed to keep their storage
+	std::vector<ResourceSet> resource_sets;
+
+	ResourceSet &get_resource_set(uint32_t set);
 };
 }        // namespace vkb
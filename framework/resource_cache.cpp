@@ -17,6 +17,11 @@
 
 #include "resource_cache.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include <ctpl_stl.h>
+
 #include "common/resource_caching.h"
 #include "core/device.h"
 
@@ -24,37 +29,99 @@ namespace vkb
 {
 namespace
 {
+/**
+ * @brief Requests a resource from the cache, building it if it is missing, see find_or_build
+ */
 template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
+T &request_resource(Device &device, ResourceRecord &recorder, ResourceMutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	std::size_t hash{0U};
+	hash_param(hash, args...);
 
-	auto &res = request_resource(device, &recorder, resources, args...);
+	const char *res_type = typeid(T).name();
 
-	return res;
+	try
+	{
+		return find_or_build(
+		    resource_mutex, resources, hash,
+		    [&]() {
+			    LOGD("Building cache object ({})", res_type);
+
+			    return T(device, args...);
+		    },
+		    [&](T &res) {
+			    RecordHelper<T, A...> record_helper;
+
+			    size_t index = record_helper.record(recorder, hash, args...);
+			    record_helper.index(recorder, index, res);
+		    });
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Creation error for cache object ({})", res_type);
+		throw;
+	}
 }
 }        // namespace
 
 ResourceCache::ResourceCache(Device &device) :
     device{device}
 {
+	// Descriptor sets are allocated from a shared descriptor pool, which can't be used from several threads
+	descriptor_set_mutex.serialize_builds = true;
 }
 
-void ResourceCache::warmup(const std::vector<uint8_t> &data)
+ResourceCache::~ResourceCache()
 {
-	recorder.set_data(data);
+	// Wait for the pending prepare tasks before destroying the cache they write to
+	thread_pool.reset();
+}
 
-	replayer.play(*this, recorder);
+void ResourceCache::warmup(const std::vector<uint8_t> &data)
+{
+	replayer.play(*this, data, device.get_gpu().get_properties());
 }
 
 std::vector<uint8_t> ResourceCache::serialize()
 {
-	return recorder.get_data();
+	return recorder.get_data(device.get_gpu().get_properties());
 }
 
 void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
 {
-	pipeline_cache = new_pipeline_cache;
+	pipeline_cache         = new_pipeline_cache;
+	thread_pipeline_caches = nullptr;
+}
+
+void ResourceCache::set_pipeline_cache(PipelineCache &new_pipeline_cache)
+{
+	pipeline_cache         = new_pipeline_cache.get_handle();
+	thread_pipeline_caches = &new_pipeline_cache;
+}
+
+PipelineCacheStats ResourceCache::get_pipeline_cache_stats()
+{
+	PipelineCacheStats stats;
+
+	{
+		std::shared_lock<std::shared_mutex> guard(graphics_pipeline_mutex.resources_mutex);
+
+		for (auto &it : state.graphics_pipelines)
+		{
+			PipelineCache::count(stats, it.second.get_creation_feedback());
+		}
+	}
+
+	{
+		std::shared_lock<std::shared_mutex> guard(compute_pipeline_mutex.resources_mutex);
+
+		for (auto &it : state.compute_pipelines)
+		{
+			PipelineCache::count(stats, it.second.get_creation_feedback());
+		}
+	}
+
+	return stats;
 }
 
 ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant)
@@ -63,6 +130,27 @@ ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage,
 	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
+ShaderModule &ResourceCache::add_shader_module(std::size_t hash, VkShaderStageFlagBits stage, std::vector<uint32_t> &&spirv, std::vector<ShaderResource> &&resources, const std::string &entry_point, const std::string &debug_name)
+{
+	ShaderModule shader_module{device, stage, std::move(spirv), std::move(resources), entry_point, debug_name};
+
+	std::unique_lock<std::shared_mutex> guard(shader_module_mutex.resources_mutex);
+
+	auto res_it = state.shader_modules.find(hash);
+
+	if (res_it == state.shader_modules.end())
+	{
+		res_it = state.shader_modules.emplace(hash, std::move(shader_module)).first;
+
+		RecordHelper<ShaderModule> record_helper;
+
+		size_t index = record_helper.record(recorder, hash);
+		record_helper.index(recorder, index, res_it->second);
+	}
+
+	return res_it->second;
+}
+
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
 	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
@@ -70,24 +158,29 @@ PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderM
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
-                                                                  const std::vector<ShaderResource> &set_resources)
+                                                                  const std::vector<ShaderResource> &set_resources,
+                                                                  bool                               descriptor_buffer)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources, descriptor_buffer);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	VkPipelineCache cache = thread_pipeline_caches ? thread_pipeline_caches->get_thread_handle() : pipeline_cache;
+
+	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, cache, pipeline_state);
 }
 
 ComputePipeline &ResourceCache::request_compute_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	VkPipelineCache cache = thread_pipeline_caches ? thread_pipeline_caches->get_thread_handle() : pipeline_cache;
+
+	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, cache, pipeline_state);
 }
 
 DescriptorSet &ResourceCache::request_descriptor_set(DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
+	auto &descriptor_pool = request_resource(device, recorder, descriptor_pool_mutex, state.descriptor_pools, descriptor_set_layout);
 	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
 }
 
@@ -101,14 +194,205 @@ Framebuffer &ResourceCache::request_framebuffer(const RenderTarget &render_targe
 	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
 }
 
+std::future<void> ResourceCache::prepare_pipelines(const std::vector<PipelineInfo>                           &pipelines,
+                                                  const std::unordered_map<std::string, ShaderResourceMode> &resource_modes)
+{
+	std::call_once(thread_pool_flag, [this]() {
+		auto thread_count = std::thread::hardware_concurrency();
+		thread_count      = thread_count == 0 ? 1 : thread_count;
+		thread_pool       = std::make_unique<ctpl::thread_pool>(thread_count);
+	});
+
+	// The tasks outlive the call, so they share the state of the preparation
+	// No task waits for another: the shader modules are queued first, and the last shader module
+	// of a pipeline to be built queues the pipeline, so the workers never block on each other
+	struct Preparation
+	{
+		std::vector<PipelineInfo> pipelines;
+
+		std::unordered_map<std::string, ShaderResourceMode> resource_modes;
+
+		/// Distinct shader modules, the modules which failed to build stay null
+		std::vector<const ShaderModuleInfo *> module_infos;
+		std::vector<ShaderModule *>           modules;
+
+		/// Indices of the modules of each pipeline, and of the pipelines using each module
+		std::vector<std::vector<size_t>> pipeline_modules;
+		std::vector<std::vector<size_t>> module_pipelines;
+
+		/// Modules each pipeline still waits for
+		std::unique_ptr<std::atomic<size_t>[]> pending_modules;
+
+		std::atomic<size_t> pending_pipelines{0};
+
+		std::mutex         error_mutex;
+		std::exception_ptr error;
+
+		std::promise<void> done;
+	};
+
+	auto preparation = std::make_shared<Preparation>();
+
+	preparation->pipelines      = pipelines;
+	preparation->resource_modes = resource_modes;
+
+	// Compile each distinct shader module once, even if several pipelines share it
+	std::unordered_map<size_t, size_t> module_indices;
+
+	preparation->pipeline_modules.resize(preparation->pipelines.size());
+
+	for (size_t pipeline_index = 0; pipeline_index < preparation->pipelines.size(); ++pipeline_index)
+	{
+		for (auto &shader_module : preparation->pipelines[pipeline_index].shader_modules)
+		{
+			size_t key{0U};
+			hash_combine(key, static_cast<uint32_t>(shader_module.stage));
+			hash_param(key, shader_module.source, shader_module.variant);
+
+			auto module_it = module_indices.emplace(key, preparation->module_infos.size()).first;
+
+			if (module_it->second == preparation->module_infos.size())
+			{
+				preparation->module_infos.push_back(&shader_module);
+				preparation->module_pipelines.emplace_back();
+			}
+
+			preparation->pipeline_modules[pipeline_index].push_back(module_it->second);
+			preparation->module_pipelines[module_it->second].push_back(pipeline_index);
+		}
+	}
+
+	preparation->modules.resize(preparation->module_infos.size(), nullptr);
+	preparation->pending_modules = std::make_unique<std::atomic<size_t>[]>(preparation->pipelines.size());
+	preparation->pending_pipelines = preparation->pipelines.size();
+
+	auto future = preparation->done.get_future();
+
+	if (preparation->pipelines.empty())
+	{
+		preparation->done.set_value();
+		return future;
+	}
+
+	auto store_error = [](Preparation &preparation) {
+		std::lock_guard<std::mutex> guard(preparation.error_mutex);
+
+		if (!preparation.error)
+		{
+			preparation.error = std::current_exception();
+		}
+	};
+
+	auto build_pipeline = [this, store_error](Preparation &preparation, size_t pipeline_index) {
+		auto &pipeline = preparation.pipelines[pipeline_index];
+
+		std::vector<ShaderModule *> shader_modules;
+
+		for (auto module_index : preparation.pipeline_modules[pipeline_index])
+		{
+			shader_modules.push_back(preparation.modules[module_index]);
+		}
+
+		// The error of a shader module which failed to build was already stored
+		if (std::find(shader_modules.begin(), shader_modules.end(), nullptr) == shader_modules.end())
+		{
+			try
+			{
+				auto &pipeline_layout = request_pipeline_layout(shader_modules);
+
+				if (pipeline.create_graphics_pipeline)
+				{
+					PipelineState pipeline_state = pipeline.pipeline_state;
+					pipeline_state.set_pipeline_layout(pipeline_layout);
+
+					request_graphics_pipeline(pipeline_state);
+				}
+			}
+			catch (...)
+			{
+				store_error(preparation);
+			}
+		}
+
+		if (--preparation.pending_pipelines == 0)
+		{
+			if (preparation.error)
+			{
+				preparation.done.set_exception(preparation.error);
+			}
+			else
+			{
+				preparation.done.set_value();
+			}
+		}
+	};
+
+	for (size_t pipeline_index = 0; pipeline_index < preparation->pipelines.size(); ++pipeline_index)
+	{
+		preparation->pending_modules[pipeline_index] = preparation->pipeline_modules[pipeline_index].size();
+	}
+
+	for (size_t module_index = 0; module_index < preparation->module_infos.size(); ++module_index)
+	{
+		thread_pool->push([this, preparation, module_index, store_error, build_pipeline](size_t) {
+			auto &shader_module = *preparation->module_infos[module_index];
+
+			try
+			{
+				auto &module    = request_shader_module(shader_module.stage, shader_module.source, shader_module.variant);
+				auto &resources = module.get_resources();
+
+				for (auto &resource_mode : preparation->resource_modes)
+				{
+					if (std::any_of(resources.begin(), resources.end(), [&resource_mode](const ShaderResource &resource) { return resource.name == resource_mode.first; }))
+					{
+						module.set_resource_mode(resource_mode.first, resource_mode.second);
+					}
+				}
+
+				preparation->modules[module_index] = &module;
+			}
+			catch (...)
+			{
+				store_error(*preparation);
+			}
+
+			// Queue the pipelines which were only waiting for this module
+			for (auto pipeline_index : preparation->module_pipelines[module_index])
+			{
+				if (--preparation->pending_modules[pipeline_index] == 0)
+				{
+					thread_pool->push([preparation, pipeline_index, build_pipeline](size_t) { build_pipeline(*preparation, pipeline_index); });
+				}
+			}
+		});
+	}
+
+	// Pipelines without shader modules don't wait for anything
+	for (size_t pipeline_index = 0; pipeline_index < preparation->pipelines.size(); ++pipeline_index)
+	{
+		if (preparation->pipeline_modules[pipeline_index].empty())
+		{
+			thread_pool->push([preparation, pipeline_index, build_pipeline](size_t) { build_pipeline(*preparation, pipeline_index); });
+		}
+	}
+
+	return future;
+}
+
 void ResourceCache::clear_pipelines()
 {
+	std::unique_lock<std::shared_mutex> graphics_guard(graphics_pipeline_mutex.resources_mutex);
+	std::unique_lock<std::shared_mutex> compute_guard(compute_pipeline_mutex.resources_mutex);
+
 	state.graphics_pipelines.clear();
 	state.compute_pipelines.clear();
 }
 
 void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views)
 {
+	std::unique_lock<std::shared_mutex> guard(descriptor_set_mutex.resources_mutex);
+
 	// Find descriptor sets referring to the old image view
 	std::vector<VkWriteDescriptorSet> set_updates;
 	std::set<size_t>                  matches;
@@ -194,16 +478,27 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 
 void ResourceCache::clear_framebuffers()
 {
+	std::unique_lock<std::shared_mutex> guard(framebuffer_mutex.resources_mutex);
+
 	state.framebuffers.clear();
 }
 
 void ResourceCache::clear()
 {
-	state.shader_modules.clear();
-	state.pipeline_layouts.clear();
-	state.descriptor_sets.clear();
-	state.descriptor_set_layouts.clear();
-	state.render_passes.clear();
+	{
+		std::unique_lock<std::shared_mutex> shader_module_guard(shader_module_mutex.resources_mutex);
+		std::unique_lock<std::shared_mutex> pipeline_layout_guard(pipeline_layout_mutex.resources_mutex);
+		std::unique_lock<std::shared_mutex> descriptor_set_guard(descriptor_set_mutex.resources_mutex);
+		std::unique_lock<std::shared_mutex> descriptor_set_layout_guard(descriptor_set_layout_mutex.resources_mutex);
+		std::unique_lock<std::shared_mutex> render_pass_guard(render_pass_mutex.resources_mutex);
+
+		state.shader_modules.clear();
+		state.pipeline_layouts.clear();
+		state.descriptor_sets.clear();
+		state.descriptor_set_layouts.clear();
+		state.render_passes.clear();
+	}
+
 	clear_pipelines();
 	clear_framebuffers();
 }
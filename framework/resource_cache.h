@@ -17,19 +17,30 @@
 
 #pragma once
 
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "common/helpers.h"
+#include "core/util/resource_mutex.hpp"
 #include "core/descriptor_pool.h"
 #include "core/descriptor_set.h"
 #include "core/descriptor_set_layout.h"
 #include "core/framebuffer.h"
 #include "core/pipeline.h"
+#include "core/pipeline_cache.h"
 #include "resource_record.h"
 #include "resource_replay.h"
 
+namespace ctpl
+{
+class thread_pool;
+}
+
 namespace vkb
 {
 class Device;
@@ -64,6 +75,33 @@ struct ResourceCacheState
 	std::unordered_map<std::size_t, Framebuffer> framebuffers;
 };
 
+/**
+ * @brief A shader stage of a pipeline to build ahead of its first use
+ */
+struct ShaderModuleInfo
+{
+	VkShaderStageFlagBits stage;
+
+	ShaderSource source;
+
+	ShaderVariant variant;
+};
+
+/**
+ * @brief A pipeline to build ahead of its first use, see ResourceCache::prepare_pipelines
+ */
+struct PipelineInfo
+{
+	/// Shader stages of the pipeline layout
+	std::vector<ShaderModuleInfo> shader_modules;
+
+	/// Whether to create a graphics pipeline from the pipeline state
+	bool create_graphics_pipeline{false};
+
+	/// State of the graphics pipeline, its pipeline layout is replaced with the one built from the shader stages
+	PipelineState pipeline_state;
+};
+
 /**
  * @brief Cache all sorts of Vulkan objects specific to a Vulkan device.
  * Supports serialization and deserialization of cached resources.
@@ -81,6 +119,8 @@ class ResourceCache
   public:
 	ResourceCache(Device &device);
 
+	~ResourceCache();
+
 	ResourceCache(const ResourceCache &) = delete;
 
 	ResourceCache(ResourceCache &&) = delete;
@@ -95,13 +135,36 @@ class ResourceCache
 
 	void set_pipeline_cache(VkPipelineCache pipeline_cache);
 
+	/**
+	 * @brief Creates the pipelines with a pipeline cache which gives each worker thread a cache of its own
+	 */
+	void set_pipeline_cache(PipelineCache &pipeline_cache);
+
+	/**
+	 * @return The pipeline cache hits and misses of the pipelines in the cache
+	 */
+	PipelineCacheStats get_pipeline_cache_stats();
+
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
+	/**
+	 * @brief Adds a shader module from SPIR-V code which was compiled and reflected beforehand, such as recorded SPIR-V
+	 *        If the cache already has a shader module for the key, it is kept and returned instead.
+	 * @param hash The key of the shader module, as computed by request_shader_module
+	 */
+	ShaderModule &add_shader_module(std::size_t                   hash,
+	                                VkShaderStageFlagBits         stage,
+	                                std::vector<uint32_t>       &&spirv,
+	                                std::vector<ShaderResource> &&resources,
+	                                const std::string            &entry_point,
+	                                const std::string            &debug_name);
+
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
 
 	DescriptorSetLayout &request_descriptor_set_layout(const uint32_t                     set_index,
 	                                                   const std::vector<ShaderModule *> &shader_modules,
-	                                                   const std::vector<ShaderResource> &set_resources);
+	                                                   const std::vector<ShaderResource> &set_resources,
+	                                                   bool                               descriptor_buffer = false);
 
 	GraphicsPipeline &request_graphics_pipeline(PipelineState &pipeline_state);
 
@@ -118,6 +181,20 @@ class ResourceCache
 	Framebuffer &request_framebuffer(const RenderTarget &render_target,
 	                                 const RenderPass &  render_pass);
 
+	/**
+	 * @brief Builds the shader modules, the pipeline layouts and optionally the graphics pipelines
+	 *        of a set of pipelines on a pool of worker threads
+	 *        Each distinct shader module is compiled once, and the pipeline layouts are queued as soon
+	 *        as their shader modules are ready, so that the workers never wait for each other.
+	 *        The cache must not be cleared until the future is ready.
+	 * @param pipelines The pipelines to build
+	 * @param resource_modes Resource modes to set on the shader modules before building the pipeline layouts,
+	 *        as the pipeline layouts of the shader modules depend on them
+	 * @return A future which is ready when all the resources are built, and rethrows the first build error
+	 */
+	std::future<void> prepare_pipelines(const std::vector<PipelineInfo>                           &pipelines,
+	                                    const std::unordered_map<std::string, ShaderResourceMode> &resource_modes = {});
+
 	void clear_pipelines();
 
 	/// @brief Update those descriptor sets referring to old views
@@ -140,22 +217,31 @@ class ResourceCache
 
 	VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
 
+	PipelineCache *thread_pipeline_caches{nullptr};
+
 	ResourceCacheState state;
 
-	std::mutex descriptor_set_mutex;
+	ResourceMutex descriptor_pool_mutex;
+
+	ResourceMutex descriptor_set_mutex;
+
+	ResourceMutex pipeline_layout_mutex;
+
+	ResourceMutex shader_module_mutex;
 
-	std::mutex pipeline_layout_mutex;
+	ResourceMutex descriptor_set_layout_mutex;
 
-	std::mutex shader_module_mutex;
+	ResourceMutex graphics_pipeline_mutex;
 
-	std::mutex descriptor_set_layout_mutex;
+	ResourceMutex render_pass_mutex;
 
-	std::mutex graphics_pipeline_mutex;
+	ResourceMutex compute_pipeline_mutex;
 
-	std::mutex render_pass_mutex;
+	ResourceMutex framebuffer_mutex;
 
-	std::mutex compute_pipeline_mutex;
+	/// Worker threads of prepare_pipelines, created on first use
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
 
-	std::mutex framebuffer_mutex;
+	std::once_flag thread_pool_flag;
 };
 }        // namespace vkb
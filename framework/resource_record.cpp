@@ -17,6 +17,9 @@
 
 #include "resource_record.h"
 
+#include <cstring>
+
+#include "core/descriptor_set_layout.h"
 #include "core/pipeline.h"
 #include "core/pipeline_layout.h"
 #include "core/render_pass.h"
@@ -34,135 +37,265 @@ inline void write_subpass_info(std::ostringstream &os, const std::vector<Subpass
 	{
 		write(os, item.input_attachments);
 		write(os, item.output_attachments);
+		write(os, item.color_resolve_attachments);
+		write(os, item.disable_depth_stencil_attachment);
+		write(os, item.depth_stencil_resolve_attachment);
+		write(os, item.depth_stencil_resolve_mode);
+		write(os, item.debug_name);
 	}
 }
 
-inline void write_processes(std::ostringstream &os, const std::vector<std::string> &value)
+inline void write_shader_resources(std::ostringstream &os, const std::vector<ShaderResource> &value)
 {
 	write(os, value.size());
-	for (const std::string &item : value)
+	for (const ShaderResource &item : value)
 	{
-		write(os, item);
+		write(os,
+		      item.stages,
+		      item.type,
+		      item.mode,
+		      item.set,
+		      item.binding,
+		      item.location,
+		      item.input_attachment_index,
+		      item.vec_size,
+		      item.columns,
+		      item.array_size,
+		      item.offset,
+		      item.size,
+		      item.constant_id,
+		      item.qualifiers,
+		      item.name);
 	}
 }
+
+inline void write_pipeline_state(std::ostringstream &os, const PipelineState &pipeline_state)
+{
+	auto &specialization_constant_state = pipeline_state.get_specialization_constant_state().get_specialization_constant_state();
+
+	write(os,
+	      specialization_constant_state);
+
+	auto &vertex_input_state = pipeline_state.get_vertex_input_state();
+
+	write(os,
+	      vertex_input_state.attributes,
+	      vertex_input_state.bindings);
+
+	write(os,
+	      pipeline_state.get_input_assembly_state(),
+	      pipeline_state.get_rasterization_state(),
+	      pipeline_state.get_viewport_state(),
+	      pipeline_state.get_multisample_state(),
+	      pipeline_state.get_depth_stencil_state());
+
+	auto &color_blend_state = pipeline_state.get_color_blend_state();
+
+	write(os,
+	      color_blend_state.logic_op,
+	      color_blend_state.logic_op_enable,
+	      color_blend_state.attachments);
+}
 }        // namespace
 
-void ResourceRecord::set_data(const std::vector<uint8_t> &data)
+ResourceRecordHeader ResourceRecordHeader::create(const VkPhysicalDeviceProperties &properties)
 {
-	stream.str(std::string{data.begin(), data.end()});
+	ResourceRecordHeader header{};
+
+	header.magic          = MAGIC;
+	header.version        = VERSION;
+	header.vendor_id      = properties.vendorID;
+	header.device_id      = properties.deviceID;
+	header.driver_version = properties.driverVersion;
+	std::memcpy(header.pipeline_cache_uuid.data(), properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	return header;
 }
 
-std::vector<uint8_t> ResourceRecord::get_data()
+std::vector<uint8_t> ResourceRecord::get_data(const VkPhysicalDeviceProperties &properties)
 {
+	std::lock_guard<std::mutex> guard(mutex);
+
+	std::ostringstream stream;
+
+	write(stream, ResourceRecordHeader::create(properties));
+
+	for (auto type : {ResourceType::ShaderModule,
+	                  ResourceType::DescriptorSetLayout,
+	                  ResourceType::PipelineLayout,
+	                  ResourceType::RenderPass,
+	                  ResourceType::GraphicsPipeline,
+	                  ResourceType::ComputePipeline})
+	{
+		auto &type_records = records[type];
+
+		write(stream, type, type_records.size());
+
+		for (auto &record : type_records)
+		{
+			write(stream, record);
+		}
+	}
+
 	std::string str = stream.str();
 
+	write(stream, std::hash<std::string>{}(str));
+
+	str = stream.str();
+
 	return std::vector<uint8_t>{str.begin(), str.end()};
 }
 
-const std::ostringstream &ResourceRecord::get_stream()
+size_t ResourceRecord::register_shader_module(std::size_t hash)
 {
-	return stream;
+	std::lock_guard<std::mutex> guard(mutex);
+
+	// The record is written by set_shader_module, once the SPIR-V code is available
+	auto &shader_module_records = records[ResourceType::ShaderModule];
+	shader_module_records.emplace_back();
+
+	shader_module_hashes.push_back(hash);
+
+	return shader_module_records.size() - 1;
 }
 
-size_t ResourceRecord::register_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant)
+size_t ResourceRecord::register_descriptor_set_layout(const uint32_t set_index, const std::vector<ShaderModule *> &shader_modules, const std::vector<ShaderResource> &set_resources, bool descriptor_buffer)
 {
-	shader_module_indices.push_back(shader_module_indices.size());
+	std::lock_guard<std::mutex> guard(mutex);
+
+	std::vector<size_t> shader_indices(shader_modules.size());
+	std::transform(shader_modules.begin(), shader_modules.end(), shader_indices.begin(),
+	               [this](ShaderModule *shader_module) { return shader_module_to_index.at(shader_module); });
+
+	std::ostringstream stream;
 
-	write(stream, ResourceType::ShaderModule, stage, glsl_source.get_source(), entry_point, shader_variant.get_preamble());
+	write(stream,
+	      set_index,
+	      shader_indices,
+	      descriptor_buffer);
 
-	write_processes(stream, shader_variant.get_processes());
+	write_shader_resources(stream, set_resources);
 
-	return shader_module_indices.back();
+	return add_record(ResourceType::DescriptorSetLayout, stream);
 }
 
 size_t ResourceRecord::register_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
-	pipeline_layout_indices.push_back(pipeline_layout_indices.size());
+	std::lock_guard<std::mutex> guard(mutex);
 
 	std::vector<size_t> shader_indices(shader_modules.size());
 	std::transform(shader_modules.begin(), shader_modules.end(), shader_indices.begin(),
 	               [this](ShaderModule *shader_module) { return shader_module_to_index.at(shader_module); });
 
+	std::ostringstream stream;
+
 	write(stream,
-	      ResourceType::PipelineLayout,
 	      shader_indices);
 
-	return pipeline_layout_indices.back();
+	// The layout depends on the resource modes the shader modules had when it was built
+	for (auto shader_module : shader_modules)
+	{
+		std::vector<ShaderResourceMode> resource_modes;
+
+		for (auto &resource : shader_module->get_resources())
+		{
+			resource_modes.push_back(resource.mode);
+		}
+
+		write(stream, resource_modes);
+	}
+
+	return add_record(ResourceType::PipelineLayout, stream);
 }
 
 size_t ResourceRecord::register_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
-	render_pass_indices.push_back(render_pass_indices.size());
+	std::lock_guard<std::mutex> guard(mutex);
+
+	std::ostringstream stream;
 
 	write(stream,
-	      ResourceType::RenderPass,
 	      attachments,
 	      load_store_infos);
 
 	write_subpass_info(stream, subpasses);
 
-	return render_pass_indices.back();
+	return add_record(ResourceType::RenderPass, stream);
 }
 
 size_t ResourceRecord::register_graphics_pipeline(VkPipelineCache /*pipeline_cache*/, PipelineState &pipeline_state)
 {
-	graphics_pipeline_indices.push_back(graphics_pipeline_indices.size());
+	std::lock_guard<std::mutex> guard(mutex);
 
 	auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 	auto  render_pass     = pipeline_state.get_render_pass();
 
+	std::ostringstream stream;
+
 	write(stream,
-	      ResourceType::GraphicsPipeline,
 	      pipeline_layout_to_index.at(&pipeline_layout),
 	      render_pass_to_index.at(render_pass),
 	      pipeline_state.get_subpass_index());
 
-	auto &specialization_constant_state = pipeline_state.get_specialization_constant_state().get_specialization_constant_state();
+	write_pipeline_state(stream, pipeline_state);
 
-	write(stream,
-	      specialization_constant_state);
+	return add_record(ResourceType::GraphicsPipeline, stream);
+}
 
-	auto &vertex_input_state = pipeline_state.get_vertex_input_state();
+size_t ResourceRecord::register_compute_pipeline(VkPipelineCache /*pipeline_cache*/, PipelineState &pipeline_state)
+{
+	std::lock_guard<std::mutex> guard(mutex);
 
-	write(stream,
-	      vertex_input_state.attributes,
-	      vertex_input_state.bindings);
+	std::ostringstream stream;
 
 	write(stream,
-	      pipeline_state.get_input_assembly_state(),
-	      pipeline_state.get_rasterization_state(),
-	      pipeline_state.get_viewport_state(),
-	      pipeline_state.get_multisample_state(),
-	      pipeline_state.get_depth_stencil_state());
-
-	auto &color_blend_state = pipeline_state.get_color_blend_state();
+	      pipeline_layout_to_index.at(&pipeline_state.get_pipeline_layout()));
 
 	write(stream,
-	      color_blend_state.logic_op,
-	      color_blend_state.logic_op_enable,
-	      color_blend_state.attachments);
+	      pipeline_state.get_specialization_constant_state().get_specialization_constant_state());
 
-	return graphics_pipeline_indices.back();
+	return add_record(ResourceType::ComputePipeline, stream);
 }
 
 void ResourceRecord::set_shader_module(size_t index, const ShaderModule &shader_module)
 {
+	std::lock_guard<std::mutex> guard(mutex);
+
 	shader_module_to_index[&shader_module] = index;
+
+	std::ostringstream stream;
+
+	write(stream,
+	      shader_module_hashes[index],
+	      shader_module.get_stage(),
+	      shader_module.get_entry_point(),
+	      shader_module.get_debug_name(),
+	      shader_module.get_binary());
+
+	write_shader_resources(stream, shader_module.get_resources());
+
+	records[ResourceType::ShaderModule][index] = stream.str();
 }
 
 void ResourceRecord::set_pipeline_layout(size_t index, const PipelineLayout &pipeline_layout)
 {
+	std::lock_guard<std::mutex> guard(mutex);
+
 	pipeline_layout_to_index[&pipeline_layout] = index;
 }
 
 void ResourceRecord::set_render_pass(size_t index, const RenderPass &render_pass)
 {
+	std::lock_guard<std::mutex> guard(mutex);
+
 	render_pass_to_index[&render_pass] = index;
 }
 
-void ResourceRecord::set_graphics_pipeline(size_t index, const GraphicsPipeline &graphics_pipeline)
+size_t ResourceRecord::add_record(ResourceType type, const std::ostringstream &stream)
 {
-	graphics_pipeline_to_index[&graphics_pipeline] = index;
-}
+	auto &type_records = records[type];
+	type_records.push_back(stream.str());
 
+	return type_records.size() - 1;
+}
 }        // namespace vkb
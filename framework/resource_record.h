@@ -17,41 +17,95 @@
 
 #pragma once
 
+#include <array>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "rendering/pipeline_state.h"
 
 namespace vkb
 {
+class ComputePipeline;
+class DescriptorSetLayout;
 class GraphicsPipeline;
 class PipelineLayout;
 class RenderPass;
 class ShaderModule;
+struct ShaderResource;
 
 enum class ResourceType
 {
 	ShaderModule,
+	DescriptorSetLayout,
 	PipelineLayout,
 	RenderPass,
-	GraphicsPipeline
+	GraphicsPipeline,
+	ComputePipeline
 };
 
 /**
- * @brief Writes Vulkan objects in a memory stream.
+ * @brief Header of a resource recording, it identifies the device the resources were created on
  */
-class ResourceRecord
+struct ResourceRecordHeader
 {
-  public:
-	void set_data(const std::vector<uint8_t> &data);
+	/// Identifies a resource recording, "VKRR"
+	static constexpr uint32_t MAGIC = 0x52524B56;
+
+	/// Version of the recording layout, to be bumped whenever it changes
+	static constexpr uint32_t VERSION = 2;
+
+	uint32_t magic;
+
+	uint32_t version;
 
-	std::vector<uint8_t> get_data();
+	uint32_t vendor_id;
 
-	const std::ostringstream &get_stream();
+	uint32_t device_id;
 
-	size_t register_shader_module(VkShaderStageFlagBits stage,
-	                              const ShaderSource &  glsl_source,
-	                              const std::string &   entry_point,
-	                              const ShaderVariant & shader_variant);
+	uint32_t driver_version;
+
+	std::array<uint8_t, VK_UUID_SIZE> pipeline_cache_uuid;
+
+	/**
+	 * @brief Creates the header of a recording of resources created on a device
+	 */
+	static ResourceRecordHeader create(const VkPhysicalDeviceProperties &properties);
+};
+
+/**
+ * @brief Records the Vulkan objects created by the resource cache, to create them again in another run
+ *        Objects can be registered from several threads.
+ *
+ * The recording starts with a ResourceRecordHeader, followed by a section for each ResourceType
+ * in order, each holding the count and the size prefixed records of the objects of the type.
+ * Objects refer to the objects they depend on by their index in their section. Shader modules
+ * are stored as SPIR-V with their reflected resources, so that they are not compiled again.
+ * The recording ends with a checksum of all the data before it.
+ *
+ * Descriptor pools, descriptor sets and framebuffers are not recorded, as they refer to buffers
+ * and images which only exist in the run which created them.
+ */
+class ResourceRecord
+{
+  public:
+	/**
+	 * @brief Serializes the objects recorded so far
+	 * @param properties Properties of the device the objects were created on
+	 */
+	std::vector<uint8_t> get_data(const VkPhysicalDeviceProperties &properties);
+
+	/**
+	 * @param hash Key of the shader module in the resource cache
+	 */
+	size_t register_shader_module(std::size_t hash);
+
+	size_t register_descriptor_set_layout(const uint32_t                     set_index,
+	                                      const std::vector<ShaderModule *> &shader_modules,
+	                                      const std::vector<ShaderResource> &set_resources,
+	                                      bool                               descriptor_buffer);
 
 	size_t register_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
 
@@ -62,24 +116,23 @@ class ResourceRecord
 	size_t register_graphics_pipeline(VkPipelineCache pipeline_cache,
 	                                  PipelineState & pipeline_state);
 
+	size_t register_compute_pipeline(VkPipelineCache pipeline_cache,
+	                                 PipelineState & pipeline_state);
+
 	void set_shader_module(size_t index, const ShaderModule &shader_module);
 
 	void set_pipeline_layout(size_t index, const PipelineLayout &pipeline_layout);
 
 	void set_render_pass(size_t index, const RenderPass &render_pass);
 
-	void set_graphics_pipeline(size_t index, const GraphicsPipeline &graphics_pipeline);
-
   private:
-	std::ostringstream stream;
-
-	std::vector<size_t> shader_module_indices;
-
-	std::vector<size_t> pipeline_layout_indices;
+	std::mutex mutex;
 
-	std::vector<size_t> render_pass_indices;
+	/// Serialized objects, by type and index
+	std::unordered_map<ResourceType, std::vector<std::string>> records;
 
-	std::vector<size_t> graphics_pipeline_indices;
+	/// Keys of the shader modules registered, which are serialized once they are built
+	std::vector<std::size_t> shader_module_hashes;
 
 	std::unordered_map<const ShaderModule *, size_t> shader_module_to_index;
 
@@ -87,6 +140,6 @@ class ResourceRecord
 
 	std::unordered_map<const RenderPass *, size_t> render_pass_to_index;
 
-	std::unordered_map<const GraphicsPipeline *, size_t> graphics_pipeline_to_index;
+	size_t add_record(ResourceType type, const std::ostringstream &stream);
 };
 }        // namespace vkb
@@ -17,6 +17,11 @@
 
 #include "resource_replay.h"
 
+#include <cstring>
+#include <future>
+
+#include <ctpl_stl.h>
+
 #include "common/vk_common.h"
 #include "core/util/logging.hpp"
 #include "rendering/pipeline_state.h"
@@ -35,107 +40,367 @@ inline void read_subpass_info(std::istringstream &is, std::vector<SubpassInfo> &
 	{
 		read(is, subpass.input_attachments);
 		read(is, subpass.output_attachments);
+		read(is, subpass.color_resolve_attachments);
+		read(is, subpass.disable_depth_stencil_attachment);
+		read(is, subpass.depth_stencil_resolve_attachment);
+		read(is, subpass.depth_stencil_resolve_mode);
+		read(is, subpass.debug_name);
 	}
 }
 
-inline void read_processes(std::istringstream &is, std::vector<std::string> &value)
+inline void read_shader_resources(std::istringstream &is, std::vector<ShaderResource> &value)
 {
 	std::size_t size;
 	read(is, size);
 	value.resize(size);
-	for (std::string &item : value)
+	for (ShaderResource &item : value)
 	{
-		read(is, item);
+		read(is,
+		     item.stages,
+		     item.type,
+		     item.mode,
+		     item.set,
+		     item.binding,
+		     item.location,
+		     item.input_attachment_index,
+		     item.vec_size,
+		     item.columns,
+		     item.array_size,
+		     item.offset,
+		     item.size,
+		     item.constant_id,
+		     item.qualifiers,
+		     item.name);
 	}
 }
-}        // namespace
 
-ResourceReplay::ResourceReplay()
+inline void read_specialization_constant_state(std::istringstream &is, PipelineState &pipeline_state)
 {
-	stream_resources[ResourceType::ShaderModule]     = std::bind(&ResourceReplay::create_shader_module, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::PipelineLayout]   = std::bind(&ResourceReplay::create_pipeline_layout, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::RenderPass]       = std::bind(&ResourceReplay::create_render_pass, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::GraphicsPipeline] = std::bind(&ResourceReplay::create_graphics_pipeline, this, std::placeholders::_1, std::placeholders::_2);
+	std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state{};
+	read(is,
+	     specialization_constant_state);
+
+	for (auto &item : specialization_constant_state)
+	{
+		pipeline_state.set_specialization_constant(item.first, item.second);
+	}
 }
 
-void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorder)
+inline void read_pipeline_state(std::istringstream &is, PipelineState &pipeline_state)
 {
-	std::istringstream stream{recorder.get_stream().str()};
+	read_specialization_constant_state(is, pipeline_state);
+
+	VertexInputState vertex_input_state{};
+
+	read(is,
+	     vertex_input_state.attributes,
+	     vertex_input_state.bindings);
+
+	InputAssemblyState input_assembly_state{};
+	RasterizationState rasterization_state{};
+	ViewportState      viewport_state{};
+	MultisampleState   multisample_state{};
+	DepthStencilState  depth_stencil_state{};
+
+	read(is,
+	     input_assembly_state,
+	     rasterization_state,
+	     viewport_state,
+	     multisample_state,
+	     depth_stencil_state);
+
+	ColorBlendState color_blend_state{};
+
+	read(is,
+	     color_blend_state.logic_op,
+	     color_blend_state.logic_op_enable,
+	     color_blend_state.attachments);
 
-	while (true)
+	pipeline_state.set_vertex_input_state(vertex_input_state);
+	pipeline_state.set_input_assembly_state(input_assembly_state);
+	pipeline_state.set_rasterization_state(rasterization_state);
+	pipeline_state.set_viewport_state(viewport_state);
+	pipeline_state.set_multisample_state(multisample_state);
+	pipeline_state.set_depth_stencil_state(depth_stencil_state);
+	pipeline_state.set_color_blend_state(color_blend_state);
+}
+
+/**
+ * @brief Throws if a record was shorter than expected
+ */
+inline void check_record(const std::istringstream &is)
+{
+	if (!is)
 	{
-		// Read command id
-		ResourceType resource_type;
-		read(stream, resource_type);
+		throw std::runtime_error{"Truncated resource record"};
+	}
+}
+
+/**
+ * @brief Checks that a recording is not corrupted and was made with the same device and driver
+ */
+bool is_recording_valid(const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties)
+{
+	std::size_t checksum{0};
+
+	if (data.size() < sizeof(ResourceRecordHeader) + sizeof(checksum))
+	{
+		LOGW("Resource recording is too small, it will not be replayed");
+		return false;
+	}
+
+	auto payload_size = data.size() - sizeof(checksum);
+	std::memcpy(&checksum, data.data() + payload_size, sizeof(checksum));
+
+	if (checksum != std::hash<std::string>{}(std::string{data.begin(), data.begin() + payload_size}))
+	{
+		LOGW("Resource recording is corrupted, it will not be replayed");
+		return false;
+	}
+
+	ResourceRecordHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	auto expected_header = ResourceRecordHeader::create(properties);
+
+	if (header.magic != expected_header.magic || header.version != expected_header.version)
+	{
+		LOGW("Resource recording has an unsupported version, it will not be replayed");
+		return false;
+	}
 
-		if (stream.eof())
+	if (header.vendor_id != expected_header.vendor_id ||
+	    header.device_id != expected_header.device_id ||
+	    header.driver_version != expected_header.driver_version ||
+	    header.pipeline_cache_uuid != expected_header.pipeline_cache_uuid)
+	{
+		LOGW("Resource recording was made with another device or driver, it will not be replayed");
+		return false;
+	}
+
+	return true;
+}
+}        // namespace
+
+bool ResourceReplay::play(ResourceCache &resource_cache, const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties)
+{
+	if (data.empty() || !is_recording_valid(data, properties))
+	{
+		return false;
+	}
+
+	shader_modules.clear();
+	pipeline_layouts.clear();
+	render_passes.clear();
+
+	std::istringstream stream{std::string{data.begin() + sizeof(ResourceRecordHeader), data.end() - sizeof(std::size_t)}};
+
+	std::unordered_map<ResourceType, std::vector<std::string>> records;
+
+	for (auto expected_type : {ResourceType::ShaderModule,
+	                           ResourceType::DescriptorSetLayout,
+	                           ResourceType::PipelineLayout,
+	                           ResourceType::RenderPass,
+	                           ResourceType::GraphicsPipeline,
+	                           ResourceType::ComputePipeline})
+	{
+		ResourceType type;
+		std::size_t  count;
+
+		read(stream, type, count);
+
+		if (!stream || type != expected_type)
 		{
-			break;
+			LOGW("Resource recording is malformed, it will not be replayed");
+			return false;
 		}
 
-		// Find command function for the given command id
-		auto cmd_it = stream_resources.find(resource_type);
+		auto &type_records = records[type];
+		type_records.resize(count);
 
-		// Check if command replayer supports the given command
-		if (cmd_it != stream_resources.end())
+		for (auto &record : type_records)
 		{
-			// Run command function
-			cmd_it->second(resource_cache, stream);
+			read(stream, record);
 		}
-		else
+	}
+
+	auto thread_count = std::thread::hardware_concurrency();
+	thread_count      = thread_count == 0 ? 1 : thread_count;
+	ctpl::thread_pool thread_pool(thread_count);
+
+	try
+	{
+		// Shader modules are independent from each other, and the other objects depend on them
+		auto &shader_module_records = records[ResourceType::ShaderModule];
+		shader_modules.resize(shader_module_records.size());
+
+		std::vector<std::future<void>> futures;
+
+		for (size_t i = 0; i < shader_module_records.size(); ++i)
 		{
-			LOGE("Replay command not supported.");
+			futures.push_back(thread_pool.push([this, &resource_cache, &shader_module_records, i](size_t) {
+				std::istringstream record_stream{shader_module_records[i]};
+				shader_modules[i] = &create_shader_module(resource_cache, record_stream);
+			}));
+		}
+
+		for (auto &future : futures)
+		{
+			future.get();
+		}
+
+		futures.clear();
+
+		// Layouts and render passes are fast to create, and depend on each other
+		for (auto &record : records[ResourceType::DescriptorSetLayout])
+		{
+			std::istringstream record_stream{record};
+			create_descriptor_set_layout(resource_cache, record_stream);
+		}
+
+		for (auto &record : records[ResourceType::PipelineLayout])
+		{
+			std::istringstream record_stream{record};
+			pipeline_layouts.push_back(&create_pipeline_layout(resource_cache, record_stream));
+		}
+
+		for (auto &record : records[ResourceType::RenderPass])
+		{
+			std::istringstream record_stream{record};
+			render_passes.push_back(&create_render_pass(resource_cache, record_stream));
+		}
+
+		// Pipelines take the longest to create, and nothing depends on them
+		for (auto &record : records[ResourceType::GraphicsPipeline])
+		{
+			futures.push_back(thread_pool.push([this, &resource_cache, &record](size_t) {
+				std::istringstream record_stream{record};
+				create_graphics_pipeline(resource_cache, record_stream);
+			}));
+		}
+
+		for (auto &record : records[ResourceType::ComputePipeline])
+		{
+			futures.push_back(thread_pool.push([this, &resource_cache, &record](size_t) {
+				std::istringstream record_stream{record};
+				create_compute_pipeline(resource_cache, record_stream);
+			}));
+		}
+
+		for (auto &future : futures)
+		{
+			future.get();
 		}
 	}
+	catch (const std::exception &e)
+	{
+		// The thread pool waits for the pending tasks before the records they read are destroyed
+		LOGE("Failed to replay resource recording: {}", e.what());
+
+		return false;
+	}
+
+	LOGI("Replayed {} shader modules, {} pipeline layouts and {} pipelines",
+	     shader_modules.size(), pipeline_layouts.size(),
+	     records[ResourceType::GraphicsPipeline].size() + records[ResourceType::ComputePipeline].size());
+
+	return true;
 }
 
-void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::istringstream &stream)
+ShaderModule &ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::istringstream &stream)
 {
-	VkShaderStageFlagBits    stage{};
-	std::string              glsl_source;
-	std::string              entry_point;
-	std::string              preamble;
-	std::vector<std::string> processes;
+	std::size_t                 hash{};
+	VkShaderStageFlagBits       stage{};
+	std::string                 entry_point;
+	std::string                 debug_name;
+	std::vector<uint32_t>       spirv;
+	std::vector<ShaderResource> resources;
 
 	read(stream,
+	     hash,
 	     stage,
-	     glsl_source,
 	     entry_point,
-	     preamble);
+	     debug_name,
+	     spirv);
+
+	read_shader_resources(stream, resources);
+
+	check_record(stream);
 
-	read_processes(stream, processes);
+	return resource_cache.add_shader_module(hash, stage, std::move(spirv), std::move(resources), entry_point, debug_name);
+}
 
-	ShaderSource shader_source{};
-	shader_source.set_source(std::move(glsl_source));
-	ShaderVariant shader_variant(std::move(preamble), std::move(processes));
+void ResourceReplay::create_descriptor_set_layout(ResourceCache &resource_cache, std::istringstream &stream)
+{
+	uint32_t                    set_index{};
+	std::vector<size_t>         shader_indices;
+	bool                        descriptor_buffer{};
+	std::vector<ShaderResource> set_resources;
 
-	auto &shader_module = resource_cache.request_shader_module(stage, shader_source, shader_variant);
+	read(stream,
+	     set_index,
+	     shader_indices,
+	     descriptor_buffer);
 
-	shader_modules.push_back(&shader_module);
+	read_shader_resources(stream, set_resources);
+
+	check_record(stream);
+
+	std::vector<ShaderModule *> shader_stages;
+
+	for (auto shader_index : shader_indices)
+	{
+		shader_stages.push_back(shader_modules.at(shader_index));
+	}
+
+	resource_cache.request_descriptor_set_layout(set_index, shader_stages, set_resources, descriptor_buffer);
 }
 
-void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
+PipelineLayout &ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
 {
 	std::vector<size_t> shader_indices;
 
 	read(stream,
 	     shader_indices);
 
-	std::vector<ShaderModule *> shader_stages(shader_indices.size());
-	std::transform(shader_indices.begin(),
-	               shader_indices.end(),
-	               shader_stages.begin(),
-	               [&](size_t shader_index) {
-		               assert(shader_index < shader_modules.size());
-		               return shader_modules[shader_index];
-	               });
+	std::vector<ShaderModule *> shader_stages;
+
+	for (auto shader_index : shader_indices)
+	{
+		auto shader_module = shader_modules.at(shader_index);
+
+		// Restore the resource modes the shader module had when the layout was built
+		std::vector<ShaderResourceMode> resource_modes;
+
+		read(stream,
+		     resource_modes);
+
+		check_record(stream);
+
+		auto &resources = shader_module->get_resources();
+
+		if (resource_modes.size() != resources.size())
+		{
+			throw std::runtime_error{"Resource modes don't match the shader module"};
+		}
+
+		for (size_t i = 0; i < resources.size(); ++i)
+		{
+			if (resources[i].mode != resource_modes[i])
+			{
+				shader_module->set_resource_mode(resources[i].name, resource_modes[i]);
+			}
+		}
+
+		shader_stages.push_back(shader_module);
+	}
 
-	auto &pipeline_layout = resource_cache.request_pipeline_layout(shader_stages);
+	check_record(stream);
 
-	pipeline_layouts.push_back(&pipeline_layout);
+	return resource_cache.request_pipeline_layout(shader_stages);
 }
 
-void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
+const RenderPass &ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
 {
 	std::vector<Attachment>    attachments;
 	std::vector<LoadStoreInfo> load_store_infos;
@@ -147,9 +412,9 @@ void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istr
 
 	read_subpass_info(stream, subpasses);
 
-	auto &render_pass = resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+	check_record(stream);
 
-	render_passes.push_back(&render_pass);
+	return resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
 }
 
 void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
@@ -163,58 +428,34 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	     render_pass_index,
 	     subpass_index);
 
-	std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state{};
-	read(stream,
-	     specialization_constant_state);
+	PipelineState pipeline_state{};
 
-	VertexInputState vertex_input_state{};
+	read_pipeline_state(stream, pipeline_state);
 
-	read(stream,
-	     vertex_input_state.attributes,
-	     vertex_input_state.bindings);
+	check_record(stream);
 
-	InputAssemblyState input_assembly_state{};
-	RasterizationState rasterization_state{};
-	ViewportState      viewport_state{};
-	MultisampleState   multisample_state{};
-	DepthStencilState  depth_stencil_state{};
+	pipeline_state.set_pipeline_layout(*pipeline_layouts.at(pipeline_layout_index));
+	pipeline_state.set_render_pass(*render_passes.at(render_pass_index));
+	pipeline_state.set_subpass_index(subpass_index);
 
-	read(stream,
-	     input_assembly_state,
-	     rasterization_state,
-	     viewport_state,
-	     multisample_state,
-	     depth_stencil_state);
+	resource_cache.request_graphics_pipeline(pipeline_state);
+}
 
-	ColorBlendState color_blend_state{};
+void ResourceReplay::create_compute_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
+{
+	size_t pipeline_layout_index{};
 
 	read(stream,
-	     color_blend_state.logic_op,
-	     color_blend_state.logic_op_enable,
-	     color_blend_state.attachments);
+	     pipeline_layout_index);
 
 	PipelineState pipeline_state{};
-	assert(pipeline_layout_index < pipeline_layouts.size());
-	pipeline_state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
-	assert(render_pass_index < render_passes.size());
-	pipeline_state.set_render_pass(*render_passes[render_pass_index]);
 
-	for (auto &item : specialization_constant_state)
-	{
-		pipeline_state.set_specialization_constant(item.first, item.second);
-	}
+	read_specialization_constant_state(stream, pipeline_state);
 
-	pipeline_state.set_subpass_index(subpass_index);
-	pipeline_state.set_vertex_input_state(vertex_input_state);
-	pipeline_state.set_input_assembly_state(input_assembly_state);
-	pipeline_state.set_rasterization_state(rasterization_state);
-	pipeline_state.set_viewport_state(viewport_state);
-	pipeline_state.set_multisample_state(multisample_state);
-	pipeline_state.set_depth_stencil_state(depth_stencil_state);
-	pipeline_state.set_color_blend_state(color_blend_state);
+	check_record(stream);
 
-	auto &graphics_pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
+	pipeline_state.set_pipeline_layout(*pipeline_layouts.at(pipeline_layout_index));
 
-	graphics_pipelines.push_back(&graphics_pipeline);
+	resource_cache.request_compute_pipeline(pipeline_state);
 }
 }        // namespace vkb
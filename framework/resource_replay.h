@@ -24,35 +24,40 @@ namespace vkb
 class ResourceCache;
 
 /**
- * @brief Reads Vulkan objects from a memory stream and creates them in the resource cache.
+ * @brief Reads Vulkan objects recorded by ResourceRecord and creates them in the resource cache.
+ *        Shader modules and pipelines, which don't depend on each other, are created in parallel.
  */
 class ResourceReplay
 {
   public:
-	ResourceReplay();
-
-	void play(ResourceCache &resource_cache, ResourceRecord &recorder);
+	/**
+	 * @brief Creates the objects of a recording in the resource cache
+	 *        Recordings made with another device or driver, or which are corrupted, are ignored.
+	 * @param resource_cache The resource cache to create the objects in
+	 * @param data The recording, as returned by ResourceRecord::get_data
+	 * @param properties The properties of the device of the resource cache
+	 * @return Whether the recording was replayed
+	 */
+	bool play(ResourceCache &resource_cache, const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties);
 
   protected:
-	void create_shader_module(ResourceCache &resource_cache, std::istringstream &stream);
+	ShaderModule &create_shader_module(ResourceCache &resource_cache, std::istringstream &stream);
 
-	void create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream);
+	void create_descriptor_set_layout(ResourceCache &resource_cache, std::istringstream &stream);
 
-	void create_render_pass(ResourceCache &resource_cache, std::istringstream &stream);
+	PipelineLayout &create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream);
 
-	void create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
+	const RenderPass &create_render_pass(ResourceCache &resource_cache, std::istringstream &stream);
 
-  private:
-	using ResourceFunc = std::function<void(ResourceCache &, std::istringstream &)>;
+	void create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
 
-	std::unordered_map<ResourceType, ResourceFunc> stream_resources;
+	void create_compute_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
 
+  private:
 	std::vector<ShaderModule *> shader_modules;
 
 	std::vector<PipelineLayout *> pipeline_layouts;
 
 	std::vector<const RenderPass *> render_passes;
-
-	std::vector<const GraphicsPipeline *> graphics_pipelines;
 };
 }        // namespace vkb
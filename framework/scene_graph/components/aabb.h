@@ -90,6 +90,12 @@ class AABB : public Component
 	 */
 	glm::vec3 get_max() const;
 
+	/**
+	 * @brief Checks whether the bounding box has been updated with any point
+	 * @return True if the box contains no points, false otherwise
+	 */
+	bool is_empty() const;
+
 	/**
 	 * @brief Resets the min and max position coordinates
 	 */
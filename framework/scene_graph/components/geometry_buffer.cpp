@@ -0,0 +1,34 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry_buffer.h"
+
+namespace vkb
+{
+namespace sg
+{
+GeometryBuffer::GeometryBuffer(const std::string &name, core::BufferC &&buffer) :
+    Component{name},
+    buffer{std::move(buffer)}
+{}
+
+std::type_index GeometryBuffer::get_type()
+{
+	return typeid(GeometryBuffer);
+}
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,48 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <typeinfo>
+
+#include "core/buffer.h"
+#include "scene_graph/component.h"
+
+namespace vkb
+{
+namespace sg
+{
+/**
+ * @brief A large buffer holding the vertex or index data of several submeshes
+ *        The submeshes refer to it through their shared buffers, at the offsets of their data
+ */
+class GeometryBuffer : public Component
+{
+  public:
+	GeometryBuffer(const std::string &name, core::BufferC &&buffer);
+
+	GeometryBuffer(GeometryBuffer &&other) = default;
+
+	virtual ~GeometryBuffer() = default;
+
+	virtual std::type_index get_type() override;
+
+	core::BufferC buffer;
+};
+}        // namespace sg
+}        // namespace vkb
@@ -38,7 +38,7 @@ class HPPSubMesh : private vkb::sg::SubMesh
 
 	vkb::core::BufferCpp const &get_index_buffer() const
 	{
-		return reinterpret_cast<vkb::core::BufferCpp const &>(*vkb::sg::SubMesh::index_buffer);
+		return reinterpret_cast<vkb::core::BufferCpp const &>(*vkb::sg::SubMesh::get_index_buffer());
 	}
 
 	vk::IndexType get_index_type() const
@@ -53,7 +53,7 @@ class HPPSubMesh : private vkb::sg::SubMesh
 
 	vkb::core::BufferCpp const &get_vertex_buffer(std::string const &name) const
 	{
-		return reinterpret_cast<vkb::core::BufferCpp const &>(vkb::sg::SubMesh::vertex_buffers.at(name));
+		return reinterpret_cast<vkb::core::BufferCpp const &>(*vkb::sg::SubMesh::get_vertex_buffer(name));
 	}
 };
 }        // namespace components
@@ -33,6 +33,28 @@ std::type_index SubMesh::get_type()
 	return typeid(SubMesh);
 }
 
+const vkb::core::BufferC *SubMesh::get_vertex_buffer(const std::string &name) const
+{
+	auto buffer_it = vertex_buffers.find(name);
+	if (buffer_it != vertex_buffers.end())
+	{
+		return &buffer_it->second;
+	}
+
+	auto shared_buffer_it = shared_vertex_buffers.find(name);
+	if (shared_buffer_it != shared_vertex_buffers.end())
+	{
+		return shared_buffer_it->second;
+	}
+
+	return nullptr;
+}
+
+const vkb::core::BufferC *SubMesh::get_index_buffer() const
+{
+	return index_buffer ? index_buffer.get() : shared_index_buffer;
+}
+
 void SubMesh::set_attribute(const std::string &attribute_name, const VertexAttribute &attribute)
 {
 	vertex_attributes[attribute_name] = attribute;
@@ -54,6 +76,11 @@ bool SubMesh::get_attribute(const std::string &attribute_name, VertexAttribute &
 	return true;
 }
 
+const std::unordered_map<std::string, VertexAttribute> &SubMesh::get_attributes() const
+{
+	return vertex_attributes;
+}
+
 void SubMesh::set_material(const Material &new_material)
 {
 	material = &new_material;
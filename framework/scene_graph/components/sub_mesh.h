@@ -40,7 +40,11 @@ struct VertexAttribute
 
 	std::uint32_t stride = 0;
 
+	/// Offset of the attribute within a vertex
 	std::uint32_t offset = 0;
+
+	/// Offset of the first vertex of the submesh in the buffer holding the attribute
+	VkDeviceSize buffer_offset = 0;
 };
 
 class SubMesh : public Component
@@ -64,10 +68,30 @@ class SubMesh : public Component
 
 	std::unique_ptr<vkb::core::BufferC> index_buffer;
 
+	/// Vertex buffers shared with other submeshes, by attribute name, for the attributes not in vertex_buffers
+	std::unordered_map<std::string, const vkb::core::BufferC *> shared_vertex_buffers;
+
+	/// Index buffer shared with other submeshes, used if the submesh doesn't own an index buffer
+	const vkb::core::BufferC *shared_index_buffer{nullptr};
+
+	/**
+	 * @return The buffer holding an attribute, owned by the submesh or shared with others, or nullptr if there is none
+	 *         The data of the submesh starts at the buffer offset of the attribute
+	 */
+	const vkb::core::BufferC *get_vertex_buffer(const std::string &name) const;
+
+	/**
+	 * @return The index buffer, owned by the submesh or shared with others, or nullptr if there is none
+	 *         The indices of the submesh start at the index offset
+	 */
+	const vkb::core::BufferC *get_index_buffer() const;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
 
+	const std::unordered_map<std::string, VertexAttribute> &get_attributes() const;
+
 	void set_material(const Material &material);
 
 	const Material *get_material() const;
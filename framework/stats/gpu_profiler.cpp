@@ -0,0 +1,246 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "common/error.h"
+#include "common/helpers.h"
+
+namespace vkb
+{
+#ifdef TRACY_ENABLE
+namespace
+{
+// The profilers of all the frames share a Tracy context, so that their zones show on a single GPU timeline
+TracyVkCtx tracy_context{nullptr};
+uint32_t   tracy_context_users{0};
+
+TracyVkCtx acquire_tracy_context(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue, uint32_t queue_family_index)
+{
+	if (tracy_context_users++ == 0)
+	{
+		VkCommandPoolCreateInfo command_pool_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+		command_pool_info.queueFamilyIndex = queue_family_index;
+
+		VkCommandPool command_pool{VK_NULL_HANDLE};
+		VK_CHECK(vkCreateCommandPool(device, &command_pool_info, nullptr, &command_pool));
+
+		VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+		allocate_info.commandPool        = command_pool;
+		allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocate_info.commandBufferCount = 1;
+
+		VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+		VK_CHECK(vkAllocateCommandBuffers(device, &allocate_info, &command_buffer));
+
+		// Tracy submits a calibration command buffer and waits for it
+		tracy_context = TracyVkContext(physical_device, device, queue, command_buffer);
+
+		vkDestroyCommandPool(device, command_pool, nullptr);
+	}
+
+	return tracy_context;
+}
+
+void release_tracy_context()
+{
+	if (--tracy_context_users == 0)
+	{
+		TracyVkDestroy(tracy_context);
+		tracy_context = nullptr;
+	}
+}
+}        // namespace
+#endif
+
+GpuProfiler::GpuProfiler(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue, uint32_t queue_family_index, bool enabled) :
+    device{device}
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physical_device, &properties);
+	timestamp_period = properties.limits.timestampPeriod;
+
+	uint32_t queue_family_count{0};
+	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+	std::vector<VkQueueFamilyProperties> queue_family_properties(queue_family_count);
+	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_family_properties.data());
+
+	uint32_t valid_bits = queue_family_properties[queue_family_index].timestampValidBits;
+	if (valid_bits == 0)
+	{
+		return;
+	}
+	if (valid_bits < 64)
+	{
+		timestamp_mask = (uint64_t{1} << valid_bits) - 1;
+	}
+
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	query_pool_info.queryCount = max_scopes * 2;
+	VK_CHECK(vkCreateQueryPool(device, &query_pool_info, nullptr, &query_pool));
+
+	// Queries have to be reset before their first use
+	vkResetQueryPoolEXT(device, query_pool, 0, max_scopes * 2);
+
+#ifdef TRACY_ENABLE
+	acquire_tracy_context(physical_device, device, queue, queue_family_index);
+#endif
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	if (query_pool != VK_NULL_HANDLE)
+	{
+#ifdef TRACY_ENABLE
+		tracy_scopes.clear();
+		release_tracy_context();
+#endif
+
+		vkDestroyQueryPool(device, query_pool, nullptr);
+	}
+}
+
+bool GpuProfiler::is_enabled() const
+{
+	return query_pool != VK_NULL_HANDLE;
+}
+
+uint32_t GpuProfiler::begin_scope(VkCommandBuffer command_buffer, const char *name)
+{
+	if (!is_enabled())
+	{
+		return invalid_scope;
+	}
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	if (scopes.size() == max_scopes)
+	{
+		return invalid_scope;
+	}
+
+	uint32_t  scope = to_u32(scopes.size());
+	uint32_t &depth = depths[command_buffer];
+
+	scopes.push_back({name, depth++, false});
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, scope * 2);
+
+#ifdef TRACY_ENABLE
+	tracy_scopes.push_back(std::make_unique<tracy::VkCtxScope>(tracy_context, __LINE__, __FILE__, strlen(__FILE__), __func__, strlen(__func__),
+	                                                           name, strlen(name), command_buffer, true));
+#endif
+
+	return scope;
+}
+
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer, uint32_t scope)
+{
+	if (scope == invalid_scope)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	assert(scope < scopes.size() && !scopes[scope].closed && "Scope was not opened in this frame");
+
+	scopes[scope].closed = true;
+	--depths[command_buffer];
+
+	vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, scope * 2 + 1);
+
+#ifdef TRACY_ENABLE
+	// The Tracy zone writes its closing timestamp when destroyed
+	tracy_scopes[scope].reset();
+#endif
+}
+
+void GpuProfiler::collect(VkCommandBuffer command_buffer)
+{
+#ifdef TRACY_ENABLE
+	std::lock_guard<std::mutex> guard{mutex};
+
+	if (is_enabled() && !collected)
+	{
+		TracyVkCollect(tracy_context, command_buffer);
+		collected = true;
+	}
+#endif
+}
+
+void GpuProfiler::resolve()
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	timings.clear();
+	collected = false;
+
+	if (scopes.empty())
+	{
+		return;
+	}
+
+	uint32_t query_count = to_u32(scopes.size()) * 2;
+
+	// Each query returns its timestamp followed by its availability
+	std::vector<uint64_t> results(query_count * 2);
+
+	// Queries of command buffers which were not submitted are unavailable, which makes this return VK_NOT_READY
+	VkResult result = vkGetQueryPoolResults(device, query_pool, 0, query_count,
+	                                        results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+	                                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+	if (result == VK_SUCCESS || result == VK_NOT_READY)
+	{
+		for (size_t i = 0; i < scopes.size(); ++i)
+		{
+			const uint64_t *begin = &results[i * 4];
+			const uint64_t *end   = &results[i * 4 + 2];
+
+			if (scopes[i].closed && begin[1] != 0 && end[1] != 0)
+			{
+				uint64_t ticks = (end[0] - begin[0]) & timestamp_mask;
+				timings.push_back({scopes[i].name, scopes[i].depth, static_cast<float>(ticks) * timestamp_period / 1000000.0f});
+			}
+		}
+	}
+
+	vkResetQueryPoolEXT(device, query_pool, 0, query_count);
+
+	scopes.clear();
+	depths.clear();
+
+#ifdef TRACY_ENABLE
+	tracy_scopes.clear();
+#endif
+}
+
+const std::vector<GpuProfiler::ScopeTiming> &GpuProfiler::get_timings() const
+{
+	return timings;
+}
+}        // namespace vkb
@@ -0,0 +1,152 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+
+#ifdef TRACY_ENABLE
+#	include <tracy/TracyVulkan.hpp>
+#endif
+
+namespace vkb
+{
+/**
+ * @brief Measures the GPU time of nested scopes of a frame with timestamp queries
+ *
+ * Each RenderFrame owns a GpuProfiler. Scopes are opened and closed in the command buffers of the frame,
+ * usually with a ScopedGpuTimer. The timestamps are read back when the frame is reset, once the GPU
+ * completed it, so the timings are a few frames late but reading them never waits.
+ *
+ * When TRACY_ENABLE is defined the scopes are also sent to Tracy as GPU zones.
+ */
+class GpuProfiler
+{
+  public:
+	/// Returned by begin_scope when the scope isn't measured
+	static constexpr uint32_t invalid_scope = std::numeric_limits<uint32_t>::max();
+
+	/// Maximum number of scopes measured in a frame
+	static constexpr uint32_t max_scopes = 128;
+
+	/**
+	 * @brief GPU time of a scope of a frame
+	 */
+	struct ScopeTiming
+	{
+		std::string name;
+
+		/// Number of scopes the scope is nested in
+		uint32_t depth{0};
+
+		/// Time in milliseconds
+		float time{0.0f};
+	};
+
+	/**
+	 * @param physical_device The physical device, which gives the timestamp period
+	 * @param device The logical device
+	 * @param queue A graphics queue, used to calibrate the Tracy GPU context
+	 * @param queue_family_index The family of the queue
+	 * @param enabled Whether the device supports timestamps on all queues and host query resets
+	 */
+	GpuProfiler(VkPhysicalDevice physical_device, VkDevice device, VkQueue queue, uint32_t queue_family_index, bool enabled);
+
+	GpuProfiler(const GpuProfiler &) = delete;
+
+	GpuProfiler(GpuProfiler &&) = delete;
+
+	~GpuProfiler();
+
+	GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+	GpuProfiler &operator=(GpuProfiler &&) = delete;
+
+	bool is_enabled() const;
+
+	/**
+	 * @brief Writes a timestamp opening a scope, may be called from any recording thread
+	 * @param command_buffer The command buffer the scope is recorded in
+	 * @param name Name of the scope
+	 * @return The index of the scope, or invalid_scope if the profiler is disabled or the frame has no queries left
+	 */
+	uint32_t begin_scope(VkCommandBuffer command_buffer, const char *name);
+
+	/**
+	 * @brief Writes a timestamp closing a scope opened by begin_scope in the same command buffer
+	 */
+	void end_scope(VkCommandBuffer command_buffer, uint32_t scope);
+
+	/**
+	 * @brief Collects the GPU zones sent to Tracy, once per frame
+	 *        Must be called outside of a render pass. Does nothing if TRACY_ENABLE isn't defined.
+	 */
+	void collect(VkCommandBuffer command_buffer);
+
+	/**
+	 * @brief Reads the timestamps of the scopes of the frame without waiting, and resets the queries
+	 *        Must be called once the GPU completed the frame. Scopes which were not executed are dropped.
+	 */
+	void resolve();
+
+	/**
+	 * @return The timings of the scopes of the last resolved frame, in the order they were opened
+	 */
+	const std::vector<ScopeTiming> &get_timings() const;
+
+  private:
+	struct Scope
+	{
+		std::string name;
+		uint32_t    depth{0};
+		bool        closed{false};
+	};
+
+	VkDevice device{VK_NULL_HANDLE};
+
+	VkQueryPool query_pool{VK_NULL_HANDLE};
+
+	/// Nanoseconds per timestamp tick
+	float timestamp_period{1.0f};
+
+	/// Mask of the valid bits of the timestamps
+	uint64_t timestamp_mask{std::numeric_limits<uint64_t>::max()};
+
+	std::mutex mutex;
+
+	/// Scopes opened in the frame, the queries 2 * i and 2 * i + 1 hold the timestamps of scope i
+	std::vector<Scope> scopes;
+
+	/// Number of scopes open in each command buffer of the frame
+	std::unordered_map<VkCommandBuffer, uint32_t> depths;
+
+	std::vector<ScopeTiming> timings;
+
+	bool collected{false};
+
+#ifdef TRACY_ENABLE
+	std::vector<std::unique_ptr<tracy::VkCtxScope>> tracy_scopes;
+#endif
+};
+}        // namespace vkb
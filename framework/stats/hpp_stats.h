@@ -34,7 +34,9 @@ class HPPStats : private vkb::Stats
 {
   public:
 	using vkb::Stats::get_data;
+	using vkb::Stats::get_gpu_scope_timings;
 	using vkb::Stats::get_graph_data;
+	using vkb::Stats::get_last_value;
 	using vkb::Stats::get_requested_stats;
 	using vkb::Stats::is_available;
 	using vkb::Stats::request_stats;
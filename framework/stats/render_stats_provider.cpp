@@ -0,0 +1,81 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+RenderStatsProvider::RenderStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (StatIndex index : {StatIndex::visible_draws, StatIndex::culled_draws, StatIndex::descriptor_set_hit_rate, StatIndex::descriptor_sets_resident})
+	{
+		// Remove from requested set to stop other providers looking for it
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool RenderStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.count(index) > 0;
+}
+
+StatsProvider::Counters RenderStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (stat_indices.empty())
+	{
+		return res;
+	}
+
+	// The counters of the active frame are the ones collected the last time it was recorded
+	const auto &draw_statistics = render_context.get_active_frame().get_draw_statistics();
+
+	if (is_available(StatIndex::visible_draws))
+	{
+		res[StatIndex::visible_draws].result = draw_statistics.visible_draws;
+	}
+
+	if (is_available(StatIndex::culled_draws))
+	{
+		res[StatIndex::culled_draws].result = draw_statistics.culled_draws;
+	}
+
+	const auto &descriptor_set_statistics = render_context.get_active_frame().get_descriptor_set_statistics();
+
+	if (is_available(StatIndex::descriptor_set_hit_rate))
+	{
+		uint32_t requests = descriptor_set_statistics.hits + descriptor_set_statistics.misses;
+
+		res[StatIndex::descriptor_set_hit_rate].result = requests > 0 ? 100.0f * descriptor_set_statistics.hits / requests : 0.0f;
+	}
+
+	if (is_available(StatIndex::descriptor_sets_resident))
+	{
+		res[StatIndex::descriptor_sets_resident].result = descriptor_set_statistics.resident;
+	}
+
+	return res;
+}
+
+}        // namespace vkb
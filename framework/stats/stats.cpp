@@ -28,6 +28,7 @@
 #	include "hwcpipe_stats_provider.h"
 #endif
 #include "core/allocated.h"
+#include "render_stats_provider.h"
 #include "rendering/render_context.h"
 #include "vulkan_stats_provider.h"
 
@@ -71,14 +72,16 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<RenderStatsProvider>(stats, render_context));
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
 
-	// In continuous sampling mode we still need to update the frame times as if we are polling
-	// Store the frame time provider here so we can easily access it later.
-	frame_time_provider = providers[0].get();
+	// In continuous sampling mode we still need to update the frame times and render counters as if we are polling
+	// Store these providers here so we can easily access them later.
+	frame_time_provider   = providers[0].get();
+	render_stats_provider = providers[1].get();
 
 	for (const auto &stat : requested_stats)
 	{
@@ -148,6 +151,8 @@ static void add_smoothed_value(std::vector<float> &values, float value, float al
 
 void Stats::update(float delta_time)
 {
+	update_gpu_scope_timings();
+
 	switch (sampling_config.mode)
 	{
 		case CounterSamplingMode::Polling:
@@ -212,8 +217,10 @@ void Stats::update(float delta_time)
 			// Clamp the number of samples
 			sample_count = std::max<size_t>(1, std::min<size_t>(sample_count, pending_samples.size()));
 
-			// Get the frame time stats (not a continuous stat)
+			// Get the frame time and render stats (not continuous stats)
 			StatsProvider::Counters frame_time_sample = frame_time_provider->sample(delta_time);
+			StatsProvider::Counters render_sample     = render_stats_provider->sample(delta_time);
+			frame_time_sample.insert(render_sample.begin(), render_sample.end());
 
 			// Push the samples to circular buffers
 			std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, frame_time_sample](auto &s) {
@@ -271,8 +278,49 @@ void Stats::continuous_sampling_worker(std::future<void> should_terminate)
 	}
 }
 
+float Stats::get_last_value(StatIndex index) const
+{
+	auto it = last_sample.find(index);
+	return it != last_sample.end() ? static_cast<float>(it->second.result) : 0.0f;
+}
+
+const std::vector<GpuProfiler::ScopeTiming> &Stats::get_gpu_scope_timings() const
+{
+	return gpu_scope_timings;
+}
+
+void Stats::update_gpu_scope_timings()
+{
+	// Samples may update the stats before beginning a frame, in which case the index is the one of the last rendered frame
+	auto       &frame   = *render_context.get_render_frames()[render_context.get_active_frame_index()];
+	const auto &timings = frame.get_gpu_profiler().get_timings();
+
+	// Frames which recorded no scopes, or whose scopes didn't execute, keep the previous timings on screen
+	if (timings.empty())
+	{
+		return;
+	}
+
+	bool same_scopes = timings.size() == gpu_scope_timings.size() &&
+	                   std::equal(timings.begin(), timings.end(), gpu_scope_timings.begin(),
+	                              [](const auto &a, const auto &b) { return a.name == b.name && a.depth == b.depth; });
+
+	if (!same_scopes)
+	{
+		gpu_scope_timings = timings;
+		return;
+	}
+
+	for (size_t i = 0; i < timings.size(); ++i)
+	{
+		gpu_scope_timings[i].time = timings[i].time * alpha_smoothing + gpu_scope_timings[i].time * (1.0f - alpha_smoothing);
+	}
+}
+
 void Stats::push_sample(const StatsProvider::Counters &sample)
 {
+	last_sample = sample;
+
 	for (auto &c : counters)
 	{
 		StatIndex           idx    = c.first;
@@ -346,6 +394,8 @@ const char *to_string(StatIndex index)
 			return "Fragment Cycles (M/s)";
 		case StatIndex::gpu_tex_cycles:
 			return "Shader Texture Cycles (k/s)";
+		case StatIndex::gpu_time:
+			return "GPU Frame Time (ms)";
 		case StatIndex::gpu_ext_reads:
 			return "External Reads (M/s)";
 		case StatIndex::gpu_ext_writes:
@@ -358,6 +408,14 @@ const char *to_string(StatIndex index)
 			return "External Read Bytes (MiB/s)";
 		case StatIndex::gpu_ext_write_bytes:
 			return "External Write Bytes (MiB/s)";
+		case StatIndex::visible_draws:
+			return "Visible Draws (CPU Culling)";
+		case StatIndex::culled_draws:
+			return "Culled Draws (CPU Culling)";
+		case StatIndex::descriptor_set_hit_rate:
+			return "Descriptor Set Hit Rate (%)";
+		case StatIndex::descriptor_sets_resident:
+			return "Resident Descriptor Sets";
 		default:
 			return nullptr;
 	}
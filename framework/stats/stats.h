@@ -25,6 +25,7 @@
 #include <set>
 #include <vector>
 
+#include "gpu_profiler.h"
 #include "stats_common.h"
 #include "stats_provider.h"
 #include "timer.h"
@@ -91,6 +92,20 @@ class Stats
 		return counters.at(index);
 	};
 
+	/**
+	 * @brief Returns the value of a stat in the last sample, before smoothing
+	 * @param index The stat index of the data requested
+	 * @return The value of the stat, or 0 if the last sample didn't contain it
+	 */
+	float get_last_value(StatIndex index) const;
+
+	/**
+	 * @brief Returns the GPU time of the scopes recorded in a recent frame
+	 *        The times are smoothed for as long as the frames record the same scopes.
+	 * @return The timings of the scopes, in the order they were opened
+	 */
+	const std::vector<GpuProfiler::ScopeTiming> &get_gpu_scope_timings() const;
+
 	/**
 	 * @return The requested stats
 	 */
@@ -143,6 +158,9 @@ class Stats
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
+	/// Provider that tracks the counters collected while recording frames
+	StatsProvider *render_stats_provider;
+
 	/// A list of stats providers to use in priority order
 	std::vector<std::unique_ptr<StatsProvider>> providers;
 
@@ -185,6 +203,17 @@ class Stats
 	/// A value which helps keep a steady pace of continuous samples output.
 	float fractional_pending_samples{0.0f};
 
+	/// The last sample pushed to the circular buffers
+	StatsProvider::Counters last_sample;
+
+	/// The smoothed GPU time of the scopes recorded in the frames
+	std::vector<GpuProfiler::ScopeTiming> gpu_scope_timings;
+
+	/**
+	 * @brief Reads the GPU scope timings the active frame resolved when it was reset
+	 */
+	void update_gpu_scope_timings();
+
 	/// The worker thread function for continuous sampling;
 	/// it adds a new entry to continuous_samples at every interval
 	void continuous_sampling_worker(std::future<void> should_terminate);
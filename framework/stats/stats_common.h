@@ -63,6 +63,13 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+	gpu_time,
+
+	visible_draws,
+	culled_draws,
+
+	descriptor_set_hit_rate,
+	descriptor_sets_resident,
 };
 
 struct StatIndexHash
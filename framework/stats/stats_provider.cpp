@@ -48,12 +48,18 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_fragment_jobs,     {"Fragment Jobs",                               "{:4.0f}/s"}},
     {StatIndex::gpu_fragment_cycles,   {"Fragment Cycles",                             "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_tex_cycles,        {"Shader Texture Cycles",                       "{:4.0f} k/s",   static_cast<float>(1e-3)}},
+    {StatIndex::gpu_time,              {"GPU Frame Time",                              "{:3.1f} ms",    1000.0f}},
     {StatIndex::gpu_ext_reads,         {"External Reads",                              "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_writes,        {"External Writes",                             "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_stalls,   {"External Read Stalls",                        "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+
+    {StatIndex::visible_draws,         {"Visible Draws (CPU Culling)",                 "{:4.0f}"}},
+    {StatIndex::culled_draws,          {"Culled Draws (CPU Culling)",                  "{:4.0f}"}},
+    {StatIndex::descriptor_set_hit_rate, {"Descriptor Set Hit Rate",                   "{:3.1f} %"}},
+    {StatIndex::descriptor_sets_resident, {"Resident Descriptor Sets",                 "{:4.0f}"}},
     // clang-format on
 };
 
@@ -170,6 +170,12 @@ VulkanStatsProvider::VulkanStatsProvider(std::set<StatIndex>         &requested_
 	{
 		requested_stats.erase(s.first);
 	}
+
+	// The timestamps around the sampled command buffer also give the GPU time of the frame
+	if (timestamp_pool && requested_stats.erase(StatIndex::gpu_time) > 0)
+	{
+		gpu_time_enabled = true;
+	}
 }
 
 VulkanStatsProvider::~VulkanStatsProvider()
@@ -225,9 +231,12 @@ bool VulkanStatsProvider::fill_vendor_data()
 
 bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 {
-	Device               &device           = render_context.get_device();
-	const PhysicalDevice &gpu              = device.get_gpu();
-	uint32_t              num_framebuffers = static_cast<uint32_t>(render_context.get_render_frames().size());
+	Device               &device = render_context.get_device();
+	const PhysicalDevice &gpu    = device.get_gpu();
+
+	// The results of a frame are read once it completed, a few frames later. One slot per frame in flight,
+	// plus one for the frame being recorded, means a free slot is available without waiting for the GPU.
+	query_slot_count = static_cast<uint32_t>(render_context.get_render_frames().size()) + 1;
 
 	// Now we know the available counters, we can build a query pool that will collect them.
 	// We will check that the counters can be collected in a single pass. Multi-pass would
@@ -251,7 +260,7 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 	pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 	pool_create_info.pNext      = &perf_create_info;
 	pool_create_info.queryType  = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
-	pool_create_info.queryCount = num_framebuffers;
+	pool_create_info.queryCount = query_slot_count;
 
 	query_pool = std::make_unique<QueryPool>(device, pool_create_info);
 
@@ -264,7 +273,7 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 	// Reset the query pool before first use. We cannot do these in the command buffer
 	// as that is invalid usage for performance queries due to the potential for multiple
 	// passes being required.
-	query_pool->host_reset(0, num_framebuffers);
+	query_pool->host_reset(0, query_slot_count);
 
 	if (has_timestamps)
 	{
@@ -274,7 +283,7 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 		VkQueryPoolCreateInfo timestamp_pool_create_info{};
 		timestamp_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
 		timestamp_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
-		timestamp_pool_create_info.queryCount = num_framebuffers * 2;        // 2 timestamps per frame (start & end)
+		timestamp_pool_create_info.queryCount = query_slot_count * 2;        // 2 timestamps per slot (start & end)
 
 		timestamp_pool = std::make_unique<QueryPool>(device, timestamp_pool_create_info);
 	}
@@ -319,6 +328,11 @@ bool VulkanStatsProvider::is_supported(const CounterSamplingConfig &sampling_con
 
 bool VulkanStatsProvider::is_available(StatIndex index) const
 {
+	if (index == StatIndex::gpu_time)
+	{
+		return gpu_time_enabled;
+	}
+
 	return stat_data.find(index) != stat_data.end();
 }
 
@@ -326,6 +340,11 @@ const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 {
 	assert(is_available(index) && "VulkanStatsProvider::get_graph_data() called with invalid StatIndex");
 
+	if (index == StatIndex::gpu_time)
+	{
+		return default_graph_map[index];
+	}
+
 	const auto &data = vendor_data.find(index)->second;
 	if (data.has_vendor_graph_data)
 	{
@@ -337,48 +356,54 @@ const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 
 void VulkanStatsProvider::begin_sampling(CommandBuffer &cb)
 {
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
+	// If the results of every slot are still pending, this command buffer isn't sampled rather than waiting for them
+	if (!query_pool || pending_slots.size() == query_slot_count)
+	{
+		active_slot = query_slot_count;
+		return;
+	}
+
+	active_slot = next_slot;
+	next_slot   = (next_slot + 1) % query_slot_count;
+
 	if (timestamp_pool)
 	{
 		// We use TimestampQueries when available to provide a more accurate delta_time.
 		// This counters are from a single command buffer execution, but the passed
 		// delta time is a frame-to-frame s/w measure. A timestamp query in the the cmd
 		// buffer gives the actual elapsed time where the counters were measured.
-		cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2, 1);
+		cb.reset_query_pool(*timestamp_pool, active_slot * 2, 2);
 		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool,
-		                   active_frame_idx * 2);
+		                   active_slot * 2);
 	}
 
-	if (query_pool)
-	{
-		cb.begin_query(*query_pool, active_frame_idx, static_cast<VkQueryControlFlags>(0));
-	}
+	cb.begin_query(*query_pool, active_slot, static_cast<VkQueryControlFlags>(0));
 }
 
 void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 {
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
-	if (query_pool)
+	if (!query_pool || active_slot == query_slot_count)
 	{
-		// Perform a barrier to ensure all previous commands complete before ending the query
-		// This does not block later commands from executing as we use BOTTOM_OF_PIPE in the
-		// dst stage mask
-		vkCmdPipelineBarrier(cb.get_handle(),
-		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-		                     0, 0, nullptr, 0, nullptr, 0, nullptr);
-		cb.end_query(*query_pool, active_frame_idx);
-
-		++queries_ready;
+		return;
 	}
 
+	// Perform a barrier to ensure all previous commands complete before ending the query
+	// This does not block later commands from executing as we use BOTTOM_OF_PIPE in the
+	// dst stage mask
+	vkCmdPipelineBarrier(cb.get_handle(),
+	                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                     0, 0, nullptr, 0, nullptr, 0, nullptr);
+	cb.end_query(*query_pool, active_slot);
+
 	if (timestamp_pool)
 	{
-		cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2 + 1, 1);
 		cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool,
-		                   active_frame_idx * 2 + 1);
+		                   active_slot * 2 + 1);
 	}
+
+	pending_slots.push_back(active_slot);
+	active_slot = query_slot_count;
 }
 
 static double get_counter_value(const VkPerformanceCounterResultKHR &result,
@@ -404,7 +429,7 @@ static double get_counter_value(const VkPerformanceCounterResultKHR &result,
 	}
 }
 
-float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
+float VulkanStatsProvider::get_best_delta_time(float sw_delta_time, uint32_t slot) const
 {
 	if (!timestamp_pool)
 	{
@@ -413,18 +438,16 @@ float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
 
 	float delta_time = sw_delta_time;
 
-	// Query the timestamps to get an accurate delta time
-	std::array<uint64_t, 2> timestamps;
-
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
+	// Query the timestamps to get an accurate delta time, each followed by its availability
+	std::array<uint64_t, 4> timestamps;
 
-	VkResult r = timestamp_pool->get_results(active_frame_idx * 2, 2,
+	VkResult r = timestamp_pool->get_results(slot * 2, 2,
 	                                         timestamps.size() * sizeof(uint64_t),
-	                                         timestamps.data(), sizeof(uint64_t),
-	                                         VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT);
-	if (r == VK_SUCCESS)
+	                                         timestamps.data(), 2 * sizeof(uint64_t),
+	                                         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	if (r == VK_SUCCESS && timestamps[1] != 0 && timestamps[3] != 0)
 	{
-		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
+		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[2] - timestamps[0]);
 		delta_time       = elapsed_ns * 0.000000001f;
 	}
 
@@ -434,27 +457,55 @@ float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
 StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 {
 	Counters out;
-	if (!query_pool || queries_ready == 0)
+	if (!query_pool || pending_slots.empty())
 	{
 		return out;
 	}
 
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
 	VkDeviceSize stride = sizeof(VkPerformanceCounterResultKHR) * counter_indices.size();
 
-	std::vector<VkPerformanceCounterResultKHR> results(counter_indices.size());
+	std::vector<VkPerformanceCounterResultKHR> results;
+
+	// Read the slots the GPU has completed, without waiting for the others. Performance queries
+	// don't support VK_QUERY_RESULT_WITH_AVAILABILITY_BIT, they return VK_NOT_READY until they are.
+	// Only the most recent completed slot is reported, older ones are only reset.
+	bool     has_results = false;
+	uint32_t slot        = 0;
+	while (!pending_slots.empty())
+	{
+		std::vector<VkPerformanceCounterResultKHR> slot_results(counter_indices.size());
+
+		VkResult r = query_pool->get_results(pending_slots.front(), 1,
+		                                     slot_results.size() * sizeof(VkPerformanceCounterResultKHR),
+		                                     slot_results.data(), stride, 0);
+		if (r != VK_SUCCESS)
+		{
+			break;
+		}
+
+		if (has_results)
+		{
+			query_pool->host_reset(slot, 1);
+		}
+
+		slot        = pending_slots.front();
+		results     = std::move(slot_results);
+		has_results = true;
+		pending_slots.pop_front();
+	}
 
-	VkResult r = query_pool->get_results(active_frame_idx, 1,
-	                                     results.size() * sizeof(VkPerformanceCounterResultKHR),
-	                                     results.data(), stride, VK_QUERY_RESULT_WAIT_BIT);
-	if (r != VK_SUCCESS)
+	if (!has_results)
 	{
 		return out;
 	}
 
 	// Use timestamps to get a more accurate delta if available
-	delta_time = get_best_delta_time(delta_time);
+	delta_time = get_best_delta_time(delta_time, slot);
+
+	if (gpu_time_enabled)
+	{
+		out[StatIndex::gpu_time].result = delta_time;
+	}
 
 	// Parse the results - they are in the order we gave in counter_indices
 	for (const auto &s : stat_data)
@@ -495,9 +546,7 @@ StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 	}
 
 	// Now reset the query we just fetched the results from
-	query_pool->host_reset(active_frame_idx, 1);
-
-	--queries_ready;
+	query_pool->host_reset(slot, 1);
 
 	return out;
 }
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "core/query_pool.h"
 #include "stats_provider.h"
 
@@ -129,7 +131,12 @@ class VulkanStatsProvider : public StatsProvider
 
 	bool create_query_pools(uint32_t queue_family_index);
 
-	float get_best_delta_time(float sw_delta_time) const;
+	/**
+	 * @brief Gets the time the GPU took to execute the sampled command buffer of a slot, without waiting
+	 * @param sw_delta_time The frame-to-frame time, returned if the timestamps aren't available
+	 * @param slot The slot of the query pools
+	 */
+	float get_best_delta_time(float sw_delta_time, uint32_t slot) const;
 
   private:
 	// The render context
@@ -147,6 +154,9 @@ class VulkanStatsProvider : public StatsProvider
 	// Query pool for timestamps
 	std::unique_ptr<QueryPool> timestamp_pool;
 
+	// Was the GPU frame time requested, and can the timestamps measure it
+	bool gpu_time_enabled{false};
+
 	// Map of vendor specific stat data
 	VendorStatMap vendor_data;
 
@@ -156,8 +166,17 @@ class VulkanStatsProvider : public StatsProvider
 	// An ordered list of the Vulkan counter ids
 	std::vector<uint32_t> counter_indices;
 
-	// How many queries have been ended?
-	uint32_t queries_ready = 0;
+	// Number of slots of the query pools, which are recorded in turn and read a few frames later
+	uint32_t query_slot_count{0};
+
+	// Slot the next sampled command buffer writes to
+	uint32_t next_slot{0};
+
+	// Slot of the command buffer being sampled, query_slot_count if it isn't sampled
+	uint32_t active_slot{0};
+
+	// Slots whose queries have been ended, oldest first, waiting for their results
+	std::deque<uint32_t> pending_slots;
 };
 
 }        // namespace vkb
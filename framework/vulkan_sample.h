@@ -22,7 +22,9 @@
 #include "hpp_gltf_loader.h"
 #include "hpp_gui.h"
 #include "platform/application.h"
+#include "rendering/frame_capture.h"
 #include "rendering/hpp_render_pipeline.h"
+#include "rendering/subpasses/geometry_subpass.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/hpp_scene.h"
 #include "scene_graph/scripts/animation.h"
@@ -156,6 +158,24 @@ class VulkanSample : public vkb::Application
 	RenderContextType const &get_render_context() const;
 	bool                     has_render_context() const;
 
+	/**
+	 * @brief Returns the frame capture of the sample, created on first use once the render context exists
+	 *        The copies of the frames are recorded by update, samples overriding it capture nothing.
+	 */
+	vkb::FrameCapture *get_frame_capture() override;
+
+	/**
+	 * @brief Sets whether the samples use descriptor buffers unless they call set_descriptor_buffer_enable,
+	 *        which is selected with --descriptor-buffer. Needs to be called before the samples are created.
+	 */
+	static void set_default_descriptor_buffer_enable(bool enable);
+
+	/**
+	 * @brief Sets the number of frames in flight of the render contexts of the samples, which is selected with
+	 *        --frames-in-flight. It is applied before the render context is prepared, 0 keeps one frame per swapchain image.
+	 */
+	static void set_default_frames_in_flight(uint32_t count);
+
 	/// <summary>
 	/// PROTECTED VIRTUAL INTERFACE
 	/// </summary>
@@ -289,8 +309,9 @@ class VulkanSample : public vkb::Application
 	 * @brief Loads the scene
 	 *
 	 * @param path The path of the glTF file
+	 * @param host_visible_geometry Whether the vertex and index buffers are kept in host visible memory, to be read back
 	 */
-	void load_scene(const std::string &path);
+	void load_scene(const std::string &path, bool host_visible_geometry = false);
 
 	/**
 	 * @brief Additional sample initialization
@@ -311,6 +332,15 @@ class VulkanSample : public vkb::Application
 	 */
 	void set_high_priority_graphics_queue_enable(bool enable);
 
+	/**
+	 * @brief Sets whether the command buffers should write descriptors to descriptor buffers instead of descriptor sets.
+	 * The backend is only used if the GPU supports VK_EXT_descriptor_buffer, otherwise descriptor sets are kept.
+	 * Buffers bound to the command buffers need VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, which the render frames add to their buffers.
+	 * Needs to be called before prepare().
+	 * @param enable If true, VK_EXT_descriptor_buffer and its dependencies are enabled when supported.
+	 */
+	void set_descriptor_buffer_enable(bool enable);
+
 	void set_render_context(std::unique_ptr<RenderContextType> &&render_context);
 
 	void set_render_pipeline(std::unique_ptr<RenderPipelineType> &&render_pipeline);
@@ -407,6 +437,11 @@ class VulkanSample : public vkb::Application
 
 	std::unique_ptr<vkb::stats::HPPStats> stats;
 
+	/**
+	 * @brief Copies the rendered frames to image files without stalling, if a capture was requested
+	 */
+	std::unique_ptr<vkb::FrameCapture> frame_capture;
+
 	static constexpr float STATS_VIEW_RESET_TIME{10.0f};        // 10 seconds
 
 	/**
@@ -441,6 +476,15 @@ class VulkanSample : public vkb::Application
 	/** @brief Whether or not we want a high priority graphics queue. */
 	bool high_priority_graphics_queue{false};
 
+	/** @brief Whether or not the command buffers of the samples use descriptor buffers by default. */
+	inline static bool default_descriptor_buffer{false};
+
+	/** @brief Whether or not the command buffers should use descriptor buffers. */
+	bool descriptor_buffer{default_descriptor_buffer};
+
+	/** @brief The number of frames in flight of the render contexts of the samples, 0 for one per swapchain image. */
+	inline static uint32_t default_frames_in_flight{0};
+
 	std::unique_ptr<vkb::core::HPPDebugUtils> debug_utils;
 };
 
@@ -452,6 +496,7 @@ inline VulkanSample<bindingType>::~VulkanSample()
 		device->get_handle().waitIdle();
 	}
 
+	frame_capture.reset();
 	scene.reset();
 	stats.reset();
 	gui.reset();
@@ -672,6 +717,11 @@ inline void VulkanSample<bindingType>::finish()
 	{
 		device->get_handle().waitIdle();
 	}
+
+	if (frame_capture)
+	{
+		frame_capture->flush();
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -935,6 +985,16 @@ inline bool VulkanSample<bindingType>::has_render_context() const
 	return render_context != nullptr;
 }
 
+template <vkb::BindingType bindingType>
+inline vkb::FrameCapture *VulkanSample<bindingType>::get_frame_capture()
+{
+	if (!frame_capture && render_context)
+	{
+		frame_capture = std::make_unique<vkb::FrameCapture>(reinterpret_cast<vkb::RenderContext &>(*render_context));
+	}
+	return frame_capture.get();
+}
+
 template <vkb::BindingType bindingType>
 inline bool VulkanSample<bindingType>::has_render_pipeline() const
 {
@@ -984,9 +1044,10 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 }
 
 template <vkb::BindingType bindingType>
-inline void VulkanSample<bindingType>::load_scene(const std::string &path)
+inline void VulkanSample<bindingType>::load_scene(const std::string &path, bool host_visible_geometry)
 {
 	vkb::HPPGLTFLoader loader(*device);
+	loader.set_host_visible_geometry(host_visible_geometry);
 
 	scene = loader.read_scene_from_file(path);
 
@@ -1015,7 +1076,8 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 #endif
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(dl.getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr"));
 
-	bool headless = window->get_window_mode() == Window::Mode::Headless;
+	bool headless  = window->get_window_mode() == Window::Mode::Headless;
+	bool offscreen = window->get_window_mode() == Window::Mode::Offscreen;
 
 	// for a while we're running on mixed C- and C++-bindings, needing volk for the C-bindings!
 	VkResult result = volkInitialize();
@@ -1059,15 +1121,16 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 	// initialize C++-Bindings default dispatcher, second step
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(instance->get_handle());
 
-	// Getting a valid vulkan surface from the platform
+	// Getting a valid vulkan surface from the platform, offscreen rendering doesn't use one
 	surface = static_cast<vk::SurfaceKHR>(window->create_surface(reinterpret_cast<vkb::Instance &>(*instance)));
-	if (!surface)
+	if (!surface && !offscreen)
 	{
 		throw std::runtime_error("Failed to create window surface.");
 	}
 
 	auto &gpu = instance->get_suitable_gpu(surface, headless);
 	gpu.set_high_priority_graphics_queue_enable(high_priority_graphics_queue);
+	gpu.set_descriptor_buffer_enable(descriptor_buffer);
 
 	// Request to enable ASTC
 	if (gpu.get_features().textureCompressionASTC_LDR)
@@ -1087,6 +1150,7 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 
 	// Creating vulkan device, specifying the swapchain extension always
 	// If using VK_EXT_headless_surface, we still create and use a swap-chain
+	// Offscreen, no swap-chain is created, but the samples still leave their images in the present layout it defines
 	{
 		add_device_extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
@@ -1096,6 +1160,64 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 		}
 	}
 
+	// Lets the framework report whether pipelines were found in the pipeline cache
+	add_device_extension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME, /*optional=*/true);
+
+	// The scene subpasses of the C bindings draw indirectly if it was selected with --draw-mode
+	if constexpr (bindingType == BindingType::C)
+	{
+		if (GeometrySubpass::get_default_draw_submission_mode() == DrawSubmissionMode::Indirect)
+		{
+			IndirectScene::request_gpu_features(reinterpret_cast<vkb::PhysicalDevice &>(gpu));
+
+			if (gpu.is_extension_supported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+			{
+				add_device_extension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+			}
+		}
+	}
+
+	// The scene subpasses of the C bindings read their materials from a bindless set if it was selected with --bindless-materials
+	if constexpr (bindingType == BindingType::C)
+	{
+		if (GeometrySubpass::get_default_bindless_materials())
+		{
+			BindlessMaterials::request_gpu_features(reinterpret_cast<vkb::PhysicalDevice &>(gpu));
+
+			if (gpu.is_extension_supported(VK_KHR_MAINTENANCE3_EXTENSION_NAME) && gpu.is_extension_supported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+			{
+				add_device_extension(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+				add_device_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			}
+		}
+	}
+
+	// The descriptor buffer backend is only available to the command buffers of the C bindings
+	if constexpr (bindingType == BindingType::C)
+	{
+		if (descriptor_buffer)
+		{
+			const std::vector<const char *> descriptor_buffer_extensions = {VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
+			                                                                VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+			                                                                VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+			                                                                VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+			                                                                VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME};
+
+			if (std::all_of(descriptor_buffer_extensions.begin(), descriptor_buffer_extensions.end(),
+			                [&gpu](const char *extension) { return gpu.is_extension_supported(extension); }))
+			{
+				for (auto extension : descriptor_buffer_extensions)
+				{
+					add_device_extension(extension);
+				}
+			}
+			else
+			{
+				LOGW("Descriptor buffers were requested, but {} or one of its dependencies is not supported", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+			}
+		}
+	}
+
 #ifdef VKB_ENABLE_PORTABILITY
 	// VK_KHR_portability_subset must be enabled if present in the implementation (e.g on macOS/iOS with beta extensions enabled)
 	add_device_extension(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME, /*optional=*/true);
@@ -1142,6 +1264,12 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(device->get_handle());
 
 	create_render_context();
+
+	if (default_frames_in_flight > 0)
+	{
+		render_context->set_frames_in_flight(default_frames_in_flight);
+	}
+
 	prepare_render_context();
 
 	stats = std::make_unique<vkb::stats::HPPStats>(*render_context);
@@ -1247,6 +1375,24 @@ inline void VulkanSample<bindingType>::set_high_priority_graphics_queue_enable(b
 	high_priority_graphics_queue = enable;
 }
 
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_descriptor_buffer_enable(bool enable)
+{
+	descriptor_buffer = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_default_descriptor_buffer_enable(bool enable)
+{
+	default_descriptor_buffer = enable;
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_default_frames_in_flight(uint32_t count)
+{
+	default_frames_in_flight = count;
+}
+
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::set_render_context(std::unique_ptr<RenderContextType> &&rc)
 {
@@ -1304,6 +1450,11 @@ inline void VulkanSample<bindingType>::update(float delta_time)
 
 	auto &command_buffer = render_context->begin();
 
+	if (frame_capture)
+	{
+		frame_capture->update();
+	}
+
 	// Collect the performance data for the sample graphs
 	update_stats(delta_time);
 
@@ -1320,10 +1471,20 @@ inline void VulkanSample<bindingType>::update(float delta_time)
 		     reinterpret_cast<vkb::RenderTarget &>(render_context->get_active_frame().get_render_target()));
 	}
 
+	if (frame_capture)
+	{
+		frame_capture->record(reinterpret_cast<vkb::CommandBuffer &>(command_buffer));
+	}
+
 	stats->end_sampling(command_buffer);
 	command_buffer.end();
 
 	render_context->submit(command_buffer);
+
+	if constexpr (bindingType == BindingType::C)
+	{
+		get_device().get_pipeline_cache().update(delta_time);
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -1354,6 +1515,14 @@ inline void VulkanSample<bindingType>::update_debug_window()
 			}
 		}
 	}
+
+	if constexpr (bindingType == BindingType::C)
+	{
+		auto pipeline_cache_stats = get_device().get_resource_cache().get_pipeline_cache_stats();
+		get_debug_info().template insert<field::Static, std::string>("pipeline_cache",
+		                                                             fmt::format("{} hits, {} misses, {} unknown",
+		                                                                         pipeline_cache_stats.hits, pipeline_cache_stats.misses, pipeline_cache_stats.unknown));
+	}
 }
 
 template <vkb::BindingType bindingType>
@@ -1413,6 +1582,9 @@ inline void VulkanSample<bindingType>::update_stats(float delta_time)
 	{
 		stats->update(delta_time);
 
+		// Keep the unsmoothed GPU time for the benchmark mode, when the sample requested it
+		gpu_frame_time = stats->get_last_value(StatIndex::gpu_time) * 1000.0f;
+
 		static float stats_view_count = 0.0f;
 		stats_view_count += delta_time;
 
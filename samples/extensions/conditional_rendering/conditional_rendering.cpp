@@ -86,9 +86,14 @@ void ConditionalRendering::build_command_buffers()
 		uint32_t node_index = 0;
 		for (auto &node : linear_scene_nodes)
 		{
-			const auto &vertex_buffer_pos    = node.sub_mesh->vertex_buffers.at("position");
-			const auto &vertex_buffer_normal = node.sub_mesh->vertex_buffers.at("normal");
-			auto       &index_buffer         = node.sub_mesh->index_buffer;
+			vkb::sg::VertexAttribute attribute_pos;
+			vkb::sg::VertexAttribute attribute_normal;
+			node.sub_mesh->get_attribute("position", attribute_pos);
+			node.sub_mesh->get_attribute("normal", attribute_normal);
+
+			const auto *vertex_buffer_pos    = node.sub_mesh->get_vertex_buffer("position");
+			const auto *vertex_buffer_normal = node.sub_mesh->get_vertex_buffer("normal");
+			const auto *index_buffer         = node.sub_mesh->get_index_buffer();
 
 			// Start a conditional rendering block, commands in this block are only executed if the buffer at the current position is 1 at command buffer submission time
 			VkConditionalRenderingBeginInfoEXT conditional_rendering_info{};
@@ -104,10 +109,9 @@ void ConditionalRendering::build_command_buffers()
 			push_const_block.color        = glm::vec4(node_material->base_color_factor.rgb, 1.0f);
 			vkCmdPushConstants(draw_cmd_buffers[i], pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push_const_block), &push_const_block);
 
-			VkDeviceSize offsets[1] = {0};
-			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer_pos.get(), offsets);
-			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, vertex_buffer_normal.get(), offsets);
-			vkCmdBindIndexBuffer(draw_cmd_buffers[i], index_buffer->get_handle(), 0, node.sub_mesh->index_type);
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer_pos->get(), &attribute_pos.buffer_offset);
+			vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, vertex_buffer_normal->get(), &attribute_normal.buffer_offset);
+			vkCmdBindIndexBuffer(draw_cmd_buffers[i], index_buffer->get_handle(), node.sub_mesh->index_offset, node.sub_mesh->index_type);
 
 			vkCmdDrawIndexed(draw_cmd_buffers[i], node.sub_mesh->vertex_indices, 1, 0, 0, 0);
 
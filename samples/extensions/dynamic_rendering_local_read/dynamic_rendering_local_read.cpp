@@ -151,7 +151,7 @@ void DynamicRenderingLocalRead::setup_render_pass()
 
 	std::array<VkAttachmentDescription, 5> attachments{};
 	// Color attachment
-	attachments[0].format         = get_render_context().get_swapchain().get_format();
+	attachments[0].format         = get_render_context().get_format();
 	attachments[0].samples        = VK_SAMPLE_COUNT_1_BIT;
 	attachments[0].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	attachments[0].storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
@@ -774,9 +774,14 @@ void DynamicRenderingLocalRead::draw_scene(std::unique_ptr<vkb::sg::Scene> &scen
 		{
 			for (auto &sub_mesh : mesh->get_submeshes())
 			{
-				const auto &vertex_buffer_position = sub_mesh->vertex_buffers.at("position");
-				const auto &vertex_buffer_normal   = sub_mesh->vertex_buffers.at("normal");
-				auto       &index_buffer           = sub_mesh->index_buffer;
+				vkb::sg::VertexAttribute attribute_position;
+				vkb::sg::VertexAttribute attribute_normal;
+				sub_mesh->get_attribute("position", attribute_position);
+				sub_mesh->get_attribute("normal", attribute_normal);
+
+				const auto *vertex_buffer_position = sub_mesh->get_vertex_buffer("position");
+				const auto *vertex_buffer_normal   = sub_mesh->get_vertex_buffer("normal");
+				const auto *index_buffer           = sub_mesh->get_index_buffer();
 				auto        mesh_material          = dynamic_cast<const vkb::sg::PBRMaterial *>(sub_mesh->get_material());
 
 				PushConstantSceneNode push_constant_scene_node{};
@@ -784,17 +789,17 @@ void DynamicRenderingLocalRead::draw_scene(std::unique_ptr<vkb::sg::Scene> &scen
 				push_constant_scene_node.color  = mesh_material->base_color_factor;
 				vkCmdPushConstants(cmd, pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantSceneNode), &push_constant_scene_node);
 
-				VkDeviceSize offsets[1] = {0};
-				vkCmdBindVertexBuffers(cmd, 0, 1, vertex_buffer_position.get(), offsets);
-				vkCmdBindVertexBuffers(cmd, 1, 1, vertex_buffer_normal.get(), offsets);
+				vkCmdBindVertexBuffers(cmd, 0, 1, vertex_buffer_position->get(), &attribute_position.buffer_offset);
+				vkCmdBindVertexBuffers(cmd, 1, 1, vertex_buffer_normal->get(), &attribute_normal.buffer_offset);
 
-				bool has_uv = sub_mesh->vertex_buffers.find("texcoord_0") != sub_mesh->vertex_buffers.end();
+				vkb::sg::VertexAttribute attribute_uv;
+				bool                     has_uv = sub_mesh->get_attribute("texcoord_0", attribute_uv);
 				if (has_uv)
 				{
-					const auto &vertex_buffer_uv = sub_mesh->vertex_buffers.at("texcoord_0");
-					vkCmdBindVertexBuffers(cmd, 2, 1, vertex_buffer_uv.get(), offsets);
+					const auto *vertex_buffer_uv = sub_mesh->get_vertex_buffer("texcoord_0");
+					vkCmdBindVertexBuffers(cmd, 2, 1, vertex_buffer_uv->get(), &attribute_uv.buffer_offset);
 				}
-				vkCmdBindIndexBuffer(cmd, index_buffer->get_handle(), 0, sub_mesh->index_type);
+				vkCmdBindIndexBuffer(cmd, index_buffer->get_handle(), sub_mesh->index_offset, sub_mesh->index_type);
 
 				vkCmdDrawIndexed(cmd, sub_mesh->vertex_indices, 1, 0, 0, 0);
 			}
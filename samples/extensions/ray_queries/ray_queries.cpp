@@ -344,6 +344,8 @@ void RayQueries::load_scene()
 	model = {};
 
 	vkb::GLTFLoader loader{get_device()};
+	// The geometry is read back to build the acceleration structure
+	loader.set_host_visible_geometry(true);
 	auto            scene = loader.read_scene_from_file("scenes/sponza/Sponza01.gltf");
 
 	load_node(scene->get_root_node());
@@ -756,7 +756,7 @@ void RaytracingBasic::build_command_buffers()
 
 		// Prepare current swap chain image as transfer destination
 		vkb::image_layout_transition(draw_cmd_buffers[i],
-		                             get_render_context().get_swapchain().get_images()[i],
+		                             swapchain_buffers[i].image,
 		                             VK_IMAGE_LAYOUT_UNDEFINED,
 		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
@@ -778,11 +778,11 @@ void RaytracingBasic::build_command_buffers()
 		copy_region.dstOffset      = {0, 0, 0};
 		copy_region.extent         = {width, height, 1};
 		vkCmdCopyImage(draw_cmd_buffers[i], storage_image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-		               get_render_context().get_swapchain().get_images()[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
+		               swapchain_buffers[i].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
 
 		// Transition swap chain image back for presentation
 		vkb::image_layout_transition(draw_cmd_buffers[i],
-		                             get_render_context().get_swapchain().get_images()[i],
+		                             swapchain_buffers[i].image,
 		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 		                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
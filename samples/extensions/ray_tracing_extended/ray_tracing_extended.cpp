@@ -1421,7 +1421,7 @@ void RaytracingExtended::draw()
 	*/
 	// Prepare current swap chain image as transfer destination
 	vkb::image_layout_transition(draw_cmd_buffers[i],
-	                             get_render_context().get_swapchain().get_images()[i],
+	                             swapchain_buffers[i].image,
 	                             VK_IMAGE_LAYOUT_UNDEFINED,
 	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
@@ -1443,11 +1443,11 @@ void RaytracingExtended::draw()
 	copy_region.dstOffset      = {0, 0, 0};
 	copy_region.extent         = {width, height, 1};
 	vkCmdCopyImage(draw_cmd_buffers[i], storage_image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-	               get_render_context().get_swapchain().get_images()[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
+	               swapchain_buffers[i].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
 
 	// Transition swap chain image back for presentation
 	vkb::image_layout_transition(draw_cmd_buffers[i],
-	                             get_render_context().get_swapchain().get_images()[i],
+	                             swapchain_buffers[i].image,
 	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
@@ -1498,6 +1498,8 @@ std::unique_ptr<vkb::VulkanSampleC> create_ray_tracing_extended()
 RaytracingExtended::RaytracingScene::RaytracingScene(vkb::Device &device, const std::vector<SceneLoadInfo> &scenesToLoad)
 {
 	vkb::GLTFLoader loader{device};
+	// The geometry is read back to build the acceleration structures
+	loader.set_host_visible_geometry(true);
 	scenes.resize(scenesToLoad.size());
 	for (size_t sceneIndex = 0; sceneIndex < scenesToLoad.size(); ++sceneIndex)
 	{
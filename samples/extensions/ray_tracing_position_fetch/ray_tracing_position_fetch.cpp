@@ -165,9 +165,13 @@ void RayTracingPositionFetch::create_bottom_level_acceleration_structure()
 			vkb::sg::VertexAttribute attrib;
 			sub_mesh->get_attribute("position", attrib);
 
+			// The geometry of the scene is suballocated from shared buffers, so the addresses of the data of the submesh are provided
+			auto *vertex_buffer = sub_mesh->get_vertex_buffer("position");
+			auto *index_buffer  = sub_mesh->get_index_buffer();
+
 			bottom_level_acceleration_structure->add_triangle_geometry(
-			    sub_mesh->vertex_buffers.at("position"),
-			    *sub_mesh->index_buffer,
+			    *vertex_buffer,
+			    *index_buffer,
 			    *transform_matrix_buffer,
 			    num_triangles,
 			    num_vertices,
@@ -175,7 +179,9 @@ void RayTracingPositionFetch::create_bottom_level_acceleration_structure()
 			    0,
 			    attrib.format,
 			    sub_mesh->index_type,
-			    VK_GEOMETRY_OPAQUE_BIT_KHR);
+			    VK_GEOMETRY_OPAQUE_BIT_KHR,
+			    vertex_buffer->get_device_address() + attrib.buffer_offset,
+			    index_buffer->get_device_address() + sub_mesh->index_offset);
 		}
 	}
 
@@ -475,7 +481,7 @@ void RayTracingPositionFetch::build_command_buffers()
 
 		// Prepare current swap chain image as transfer destination
 		vkb::image_layout_transition(draw_cmd_buffers[i],
-		                             get_render_context().get_swapchain().get_images()[i],
+		                             swapchain_buffers[i].image,
 		                             VK_IMAGE_LAYOUT_UNDEFINED,
 		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
@@ -497,11 +503,11 @@ void RayTracingPositionFetch::build_command_buffers()
 		copy_region.dstOffset      = {0, 0, 0};
 		copy_region.extent         = {width, height, 1};
 		vkCmdCopyImage(draw_cmd_buffers[i], storage_image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-		               get_render_context().get_swapchain().get_images()[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
+		               swapchain_buffers[i].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
 
 		// Transition swap chain image back for presentation
 		vkb::image_layout_transition(draw_cmd_buffers[i],
-		                             get_render_context().get_swapchain().get_images()[i],
+		                             swapchain_buffers[i].image,
 		                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 		                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
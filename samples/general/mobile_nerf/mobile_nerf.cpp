@@ -837,6 +837,8 @@ void MobileNerf::load_scene(int model_index, int sub_model_index, int models_ent
 	Model &model = models[models_entry];
 
 	vkb::GLTFLoader loader{get_device()};
+	// The geometry of the models is read back and merged into a single set of vertex buffers
+	loader.set_host_visible_geometry(true);
 	int             total_sub_sub_model = using_original_nerf_models[model_index] ? 8 : 1;
 
 	for (int sub_model = 0; sub_model < total_sub_sub_model; sub_model++)
@@ -1628,7 +1630,7 @@ void MobileNerf::update_render_pass_nerf_forward()
 	attachments[0].initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
 	attachments[0].finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 	// Swapchain  attachment
-	attachments[1].format         = get_render_context().get_swapchain().get_format();
+	attachments[1].format         = get_render_context().get_format();
 	attachments[1].samples        = VK_SAMPLE_COUNT_1_BIT;
 	attachments[1].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	attachments[1].storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
@@ -1732,7 +1734,7 @@ void MobileNerf::update_render_pass_nerf_baseline()
 	// Swapchain  attachment
 	swapchain_attach_idx                          = attachment_idx++;
 	VkAttachmentDescription swapchain_description = {};
-	swapchain_description.format                  = get_render_context().get_swapchain().get_format();
+	swapchain_description.format                  = get_render_context().get_format();
 	swapchain_description.samples                 = VK_SAMPLE_COUNT_1_BIT;
 	swapchain_description.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	swapchain_description.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
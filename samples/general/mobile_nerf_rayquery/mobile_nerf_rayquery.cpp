@@ -569,6 +569,8 @@ void MobileNerfRayQuery::load_scene(int model_index, int sub_model_index, int mo
 	Model &model = models[models_entry];
 
 	vkb::GLTFLoader loader{get_device()};
+	// The geometry of the models is read back and merged into a single set of acceleration structure
+	loader.set_host_visible_geometry(true);
 	int             total_sub_sub_model = 1;
 
 	for (int sub_model = 0; sub_model < total_sub_sub_model; sub_model++)
@@ -249,10 +249,11 @@ CommandBufferUsage::ForwardSubpassSecondary::ForwardSubpassSecondary(vkb::Render
                                                                      vkb::ShaderSource &&vertex_shader, vkb::ShaderSource &&fragment_shader, vkb::sg::Scene &scene_, vkb::sg::Camera &camera) :
     vkb::ForwardSubpass{render_context, std::move(vertex_shader), std::move(fragment_shader), scene_, camera}
 {
+	// Every submesh is recorded as its own draw, which is what the sample measures
+	set_instancing(false);
 }
 
-void CommandBufferUsage::ForwardSubpassSecondary::record_draw(vkb::CommandBuffer                                                &command_buffer,
-                                                              const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+void CommandBufferUsage::ForwardSubpassSecondary::record_draw(vkb::CommandBuffer &command_buffer, const vkb::RenderQueue &nodes,
                                                               uint32_t mesh_start, uint32_t mesh_end, size_t thread_index)
 {
 	command_buffer.set_color_blend_state(color_blend_state);
@@ -264,14 +265,13 @@ void CommandBufferUsage::ForwardSubpassSecondary::record_draw(vkb::CommandBuffer
 	assert(mesh_end <= nodes.size());
 	for (uint32_t i = mesh_start; i < mesh_end; i++)
 	{
-		update_uniform(command_buffer, *nodes[i].first, thread_index);
+		bind_uniform(command_buffer, nodes[i], thread_index);
 
-		draw_submesh(command_buffer, *nodes[i].second);
+		draw_submesh(command_buffer, *nodes[i].sub_mesh);
 	}
 }
 
-vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_secondary(vkb::CommandBuffer                                                &primary_command_buffer,
-                                                                                       const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_secondary(vkb::CommandBuffer &primary_command_buffer, const vkb::RenderQueue &nodes,
                                                                                        uint32_t mesh_start, uint32_t mesh_end, size_t thread_index)
 {
 	const auto &queue = get_render_context().get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
@@ -294,28 +294,15 @@ vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_sec
 
 void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &primary_command_buffer)
 {
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> opaque_nodes;
-
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> transparent_nodes;
-
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
-
-	// Sort opaque objects in front-to-back order
+	// Opaque objects are sorted by state and front-to-back, transparent objects back-to-front
 	// Note: sorting objects does not help on PowerVR, so it can be avoided to save CPU cycles
-	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_opaque_nodes;
-	for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
-	{
-		sorted_opaque_nodes.push_back(node_it->second);
-	}
-	const auto opaque_submeshes = vkb::to_u32(sorted_opaque_nodes.size());
+	get_sorted_nodes(opaque_queue, transparent_queue);
 
-	// Sort transparent objects in back-to-front order
-	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_transparent_nodes;
-	for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
-	{
-		sorted_transparent_nodes.push_back(node_it->second);
-	}
-	const auto transparent_submeshes = vkb::to_u32(sorted_transparent_nodes.size());
+	// Upload the uniforms of all nodes once, before recording on multiple threads
+	update_uniforms(thread_index);
+
+	const auto opaque_submeshes      = vkb::to_u32(opaque_queue.size());
+	const auto transparent_submeshes = vkb::to_u32(transparent_queue.size());
 
 	allocate_lights<vkb::ForwardLights>(scene.get_components<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
 
@@ -356,15 +343,15 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 			if (state.multi_threading)
 			{
 				auto fut = thread_pool.push(
-				    [this, cb_count, &primary_command_buffer, &sorted_opaque_nodes, mesh_start, mesh_end](size_t thread_id) {
-					    return record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_start, mesh_end, thread_id);
+				    [this, cb_count, &primary_command_buffer, mesh_start, mesh_end](size_t thread_id) {
+					    return record_draw_secondary(primary_command_buffer, opaque_queue, mesh_start, mesh_end, thread_id);
 				    });
 
 				secondary_cmd_buf_futures.push_back(std::move(fut));
 			}
 			else
 			{
-				secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, sorted_opaque_nodes, mesh_start, mesh_end));
+				secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, opaque_queue, mesh_start, mesh_end));
 			}
 
 			mesh_start = mesh_end;
@@ -380,7 +367,7 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 	}
 	else
 	{
-		record_draw(primary_command_buffer, sorted_opaque_nodes, 0, opaque_submeshes);
+		record_draw(primary_command_buffer, opaque_queue, 0, opaque_submeshes);
 	}
 
 	// Enable alpha blending
@@ -396,11 +383,11 @@ void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &prima
 	{
 		if (use_secondary_command_buffers)
 		{
-			secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, sorted_transparent_nodes, 0, transparent_submeshes));
+			secondary_command_buffers.push_back(record_draw_secondary(primary_command_buffer, transparent_queue, 0, transparent_submeshes));
 		}
 		else
 		{
-			record_draw(primary_command_buffer, sorted_transparent_nodes, 0, transparent_submeshes);
+			record_draw(primary_command_buffer, transparent_queue, 0, transparent_submeshes);
 		}
 	}
 
@@ -89,7 +89,7 @@ class CommandBufferUsage : public vkb::VulkanSampleC
 		 * @param mesh_end Index to the mesh where recording will stop (not included)
 		 * @param thread_index Identifies the resources allocated for this thread
 		 */
-		void record_draw(vkb::CommandBuffer &command_buffer, const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+		void record_draw(vkb::CommandBuffer &command_buffer, const vkb::RenderQueue &nodes,
 		                 uint32_t mesh_start, uint32_t mesh_end, size_t thread_index = 0);
 
 		/**
@@ -103,7 +103,7 @@ class CommandBufferUsage : public vkb::VulkanSampleC
 		 * @param thread_index Identifies the resources allocated for this thread
 		 * @return a pointer to the recorded secondary command buffer
 		 */
-		vkb::CommandBuffer *record_draw_secondary(vkb::CommandBuffer &primary_command_buffer, const std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> &nodes,
+		vkb::CommandBuffer *record_draw_secondary(vkb::CommandBuffer &primary_command_buffer, const vkb::RenderQueue &nodes,
 		                                          uint32_t mesh_start, uint32_t mesh_end, size_t thread_index = 0);
 
 		VkViewport viewport{};
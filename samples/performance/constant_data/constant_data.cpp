@@ -311,6 +311,11 @@ void ConstantData::ConstantDataSubpass::prepare()
 	}
 }
 
+void ConstantData::ConstantDataSubpass::update_uniforms(size_t thread_index)
+{
+	// Intentionally empty, the per-node data is sent by the update_uniform of each subpass
+}
+
 void ConstantData::PushConstantSubpass::update_uniform(vkb::CommandBuffer &command_buffer, vkb::sg::Node &node, size_t thread_index)
 {
 	mvp_uniform = fill_mvp(node, camera);
@@ -492,7 +497,7 @@ void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &
 	if (sub_mesh.vertex_indices != 0)
 	{
 		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		command_buffer.bind_index_buffer(*sub_mesh.get_index_buffer(), sub_mesh.index_offset, sub_mesh.index_type);
 
 		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, instance_index++);
 	}
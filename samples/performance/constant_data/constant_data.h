@@ -111,6 +111,11 @@ class ConstantData : public vkb::VulkanSampleC
 
 		virtual void prepare() override;
 
+		/**
+		 * @brief No-op, each method under test provides its own constant data
+		 */
+		virtual void update_uniforms(size_t thread_index) override;
+
 		uint32_t struct_size{128};
 	};
 
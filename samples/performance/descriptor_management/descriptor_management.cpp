@@ -58,7 +58,7 @@ bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
 	set_render_pipeline(std::move(render_pipeline));
 
 	// Add a GUI with the stats you want to monitor
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::descriptor_set_hit_rate, vkb::StatIndex::descriptor_sets_resident});
 	create_gui(*window, &get_stats());
 
 	return true;
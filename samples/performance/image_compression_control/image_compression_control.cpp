@@ -114,6 +114,13 @@ bool ImageCompressionControlSample::prepare(const vkb::ApplicationOptions &optio
 
 void ImageCompressionControlSample::create_render_context()
 {
+	// Without a surface the frames are rendered offscreen, there is no swapchain to compress
+	if (get_surface() == VK_NULL_HANDLE)
+	{
+		VulkanSample::create_render_context();
+		return;
+	}
+
 	/**
 	 * The framework expects a prioritized list of surface formats. For this sample, include
 	 * only those that can be compressed.
@@ -564,7 +571,7 @@ void ImageCompressionControlSample::draw_gui()
 			    // Single or no compression options available on this device
 			    ImGui::Text("(Extensions are not supported)");
 		    }
-		    else
+		    else if (get_render_context().has_swapchain())
 		    {
 			    // Indicate if the Swapchain compression matches that of the color attachment
 			    ImGui::Text("(Swapchain is %s affected)", get_render_context().get_swapchain().get_applied_compression() == compression_flag ? "also" : "not");
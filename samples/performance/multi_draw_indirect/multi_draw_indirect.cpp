@@ -297,7 +297,8 @@ bool MultiDrawIndirect::prepare(const vkb::ApplicationOptions &options)
 void MultiDrawIndirect::load_scene()
 {
 	const std::string scene_path = "scenes/vokselia/";
-	ApiVulkanSample::load_scene(scene_path + "vokselia.gltf");
+	// The geometry is read back to be merged into a single vertex buffer
+	ApiVulkanSample::load_scene(scene_path + "vokselia.gltf", true);
 
 	assert(has_scene());
 	for (auto &&mesh : get_scene().get_components<vkb::sg::Mesh>())
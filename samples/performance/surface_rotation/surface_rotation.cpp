@@ -78,6 +78,13 @@ bool SurfaceRotation::prepare(const vkb::ApplicationOptions &options)
 
 void SurfaceRotation::update(float delta_time)
 {
+	// Without a swapchain the frames are rendered offscreen, there is no surface to rotate
+	if (!get_render_context().has_swapchain())
+	{
+		VulkanSample::update(delta_time);
+		return;
+	}
+
 	// Process GUI input, recreating the swapchain if pre-rotate mode was
 	// enabled/disabled by the user. Otherwise it might still be recreated if
 	// a 180 degree change in orientation is detected
@@ -119,15 +126,20 @@ void SurfaceRotation::update(float delta_time)
 
 void SurfaceRotation::draw_gui()
 {
-	auto        extent          = get_render_context().get_swapchain().get_extent();
+	auto &render_context = get_render_context();
+
+	// Offscreen frames are never rotated
+	auto extent            = render_context.has_swapchain() ? render_context.get_swapchain().get_extent() : render_context.get_surface_extent();
+	auto surface_transform = render_context.has_swapchain() ? render_context.get_swapchain().get_transform() : VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+
 	std::string rotation_by_str = pre_rotate ? "application" : "compositor";
 	auto        prerotate_str   = "Pre-rotate (" + rotation_by_str + " rotates)";
-	auto        transform       = vkb::to_string(get_render_context().get_swapchain().get_transform());
+	auto        transform       = vkb::to_string(surface_transform);
 	auto        resolution_str  = "Res: " + std::to_string(extent.width) + "x" + std::to_string(extent.height);
 
 	// If pre-rotate is enabled, the aspect ratio will not change, therefore need to check if the
 	// scene has been rotated using the swapchain preTransform attribute
-	auto  rotated      = get_render_context().get_swapchain().get_transform() & (VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR | VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR);
+	auto  rotated      = surface_transform & (VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR | VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR);
 	float aspect_ratio = static_cast<float>(extent.width) / extent.height;
 	if (aspect_ratio > 1.0f || (aspect_ratio < 1.0f && rotated))
 	{
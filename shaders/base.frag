@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,7 +18,33 @@
 
 precision highp float;
 
-#ifdef HAS_BASE_COLOR_TEXTURE
+#ifdef BINDLESS
+// Textures and materials of the whole scene, see BindlessMaterials
+#define MAX_BINDLESS_TEXTURES 1024
+#define NO_TEXTURE 0xFFFFFFFFu
+
+layout(set = 1, binding = 0) uniform sampler2D textures[MAX_BINDLESS_TEXTURES];
+
+struct Material
+{
+	vec4  base_color_factor;
+	vec4  emissive_factor;
+	float metallic_factor;
+	float roughness_factor;
+	uint  base_color_texture;
+	uint  normal_texture;
+	uint  metallic_roughness_texture;
+	uint  occlusion_texture;
+	uint  emissive_texture;
+	uint  padding;
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer MaterialData
+{
+	Material materials[];
+}
+material_data;
+#elif defined(HAS_BASE_COLOR_TEXTURE)
 layout(set = 0, binding = 0) uniform sampler2D base_color_texture;
 #endif
 
@@ -36,6 +62,14 @@ layout(set = 0, binding = 1) uniform GlobalUniform
 }
 global_uniform;
 
+#ifdef BINDLESS
+// The draws only select their material, which is the same for the whole draw
+layout(push_constant, std430) uniform DrawMaterial
+{
+	uint index;
+}
+draw_material;
+#else
 // Push constants come with a limitation in the size of data.
 // The standard requires at least 128 bytes
 layout(push_constant, std430) uniform PBRMaterialUniform
@@ -45,6 +79,7 @@ layout(push_constant, std430) uniform PBRMaterialUniform
 	float roughness_factor;
 }
 pbr_material_uniform;
+#endif
 
 #include "lighting.h"
 
@@ -83,7 +118,18 @@ void main(void)
 
 	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
 
-#ifdef HAS_BASE_COLOR_TEXTURE
+#ifdef BINDLESS
+	Material material = material_data.materials[draw_material.index];
+
+	if (material.base_color_texture != NO_TEXTURE)
+	{
+		base_color = texture(textures[material.base_color_texture], in_uv);
+	}
+	else
+	{
+		base_color = material.base_color_factor;
+	}
+#elif defined(HAS_BASE_COLOR_TEXTURE)
 	base_color = texture(base_color_texture, in_uv);
 #else
 	base_color = pbr_material_uniform.base_color_factor;
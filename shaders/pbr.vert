@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -30,6 +30,14 @@ layout(set = 0, binding = 1) uniform GlobalUniform
 }
 global_uniform;
 
+#ifdef INSTANCED
+layout(std430, set = 0, binding = 7) readonly buffer InstanceData
+{
+	mat4 models[];
+}
+instance_data;
+#endif
+
 struct Light
 {
 	vec4 position;
@@ -49,11 +57,17 @@ layout(location = 2) out vec3 o_normal;
 
 void main(void)
 {
-	o_pos = vec3(global_uniform.model * vec4(position, 1.0));
+#ifdef INSTANCED
+	mat4 model = instance_data.models[gl_InstanceIndex];
+#else
+	mat4 model = global_uniform.model;
+#endif
+
+	o_pos = vec3(model * vec4(position, 1.0));
 
 	o_uv = texcoord_0;
 
-	o_normal = mat3(global_uniform.model) * normal;
+	o_normal = mat3(model) * normal;
 
-	gl_Position = global_uniform.view_proj * global_uniform.model * vec4(position, 1.0);
+	gl_Position = global_uniform.view_proj * model * vec4(position, 1.0);
 }